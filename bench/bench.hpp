@@ -0,0 +1,324 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A small benchmark harness: every case is set up lazily (so only one case's data is alive at a time),
+// calibrated to run for at least min_time, then timed over a few repetitions, with the hardware
+// counters (perf_counters.hpp) running during the timed repetitions if they are available. Results are
+// written as JSON in the layout of Google Benchmark (name, iterations, real_time, cpu_time, time_unit),
+// so two runs can be diffed with its tools/compare.py, plus the case parameters and counters as extra fields.
+//
+// Third-party code lives in extern/ submodules (doctest, tl-expected), but Google Benchmark itself is not
+// vendored: this harness stands in for it. Moving to an extern/benchmark submodule only replaces the
+// runner; the case names and the JSON layout stay the same.
+
+namespace finfuns::bench
+{
+
+// Keeps the compiler from dropping a computation whose result is otherwise unused
+template <typename T>
+inline void do_not_optimize(const T & value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T * sink;
+    sink = &value;
+#endif
+}
+
+// The timed code: run(n) calls the benchmarked function n times, result is one call's value (NaN if it failed)
+struct Body
+{
+    std::function<void(uint64_t)> run;
+    double result;
+};
+
+// Body calling fn() (returning a double, NaN on failure) in a loop that the compiler sees through
+template <typename Fn>
+Body loop(Fn fn)
+{
+    const double result = fn();
+    return {[fn](uint64_t n) mutable
+            {
+                for (uint64_t i = 0; i < n; ++i)
+                    do_not_optimize(fn());
+            },
+            result};
+}
+
+struct Case
+{
+    std::string function; //!< e.g. "irr", "xirr_batch"
+    std::string api; //!< "cpp" (header templates), "c" (finfunslib), "c_mt" (finfunslib, all threads)
+    std::string shape; //!< Cashflow shape, empty if it does not matter
+    std::string date_type; //!< "int" or "sys_days" for dated functions, else empty
+    std::size_t size = 0; //!< Cashflows per series (per row for batches)
+    std::size_t rows = 1; //!< Series per call
+    std::size_t items = 1; //!< Items processed per call, for the throughput
+    std::function<Body()> setup;
+
+    std::string name() const
+    {
+        std::string name = function + "/" + api;
+        for (const auto & part : {shape, date_type})
+            if (!part.empty())
+                name += "/" + part;
+        name += "/" + std::to_string(size);
+        if (rows != 1)
+            name += "x" + std::to_string(rows);
+        return name;
+    }
+};
+
+struct Options
+{
+    std::string filter; //!< Only cases whose name contains this
+    double min_time = 0.1; //!< Seconds per repetition
+    int repetitions = 3;
+    std::size_t max_size = 1'000'000; //!< Largest series length / batch size
+    std::string out; //!< JSON file, stdout if empty
+    bool list = false; //!< Print the case names and exit
+    bool counters = true; //!< Read hardware counters (if available)
+};
+
+struct Measurement
+{
+    uint64_t iterations = 0;
+    double real_ns = 0.0; //!< Per call, median over the repetitions
+    double real_ns_min = 0.0; //!< Per call, best repetition
+    double cpu_ns = 0.0; //!< Per call, median over the repetitions
+    CounterValues counters; //!< Per call, over all repetitions
+};
+
+namespace detail
+{
+
+inline double process_cpu_seconds()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+inline double median(std::vector<double> values)
+{
+    std::ranges::sort(values);
+    const std::size_t half = values.size() / 2;
+    return values.size() % 2 == 1 ? values[half] : 0.5 * (values[half - 1] + values[half]);
+}
+
+}
+
+// counters may be null (timing only)
+inline Measurement measure(const Body & body, const Options & options, PerfCounters * counters)
+{
+    using clock = std::chrono::steady_clock;
+    const auto seconds = [](clock::duration d) { return std::chrono::duration<double>(d).count(); };
+
+    // Warm up (caches, page faults, lazily started threads), then grow n until a run takes min_time
+    body.run(1);
+    uint64_t n = 1;
+    for (;;)
+    {
+        const auto start = clock::now();
+        body.run(n);
+        const double elapsed = seconds(clock::now() - start);
+        if (elapsed >= options.min_time || n >= (uint64_t{1} << 40))
+            break;
+        const double factor = elapsed <= 0.0 ? 100.0 : std::clamp(1.4 * options.min_time / elapsed, 2.0, 100.0);
+        n = static_cast<uint64_t>(std::ceil(static_cast<double>(n) * factor));
+    }
+
+    std::vector<double> real;
+    std::vector<double> cpu;
+    const int repetitions = std::max(options.repetitions, 1);
+    if (counters)
+        counters->start();
+    for (int r = 0; r < repetitions; ++r)
+    {
+        const double cpu_start = detail::process_cpu_seconds();
+        const auto start = clock::now();
+        body.run(n);
+        real.push_back(seconds(clock::now() - start) * 1e9 / static_cast<double>(n));
+        cpu.push_back((detail::process_cpu_seconds() - cpu_start) * 1e9 / static_cast<double>(n));
+    }
+    CounterValues per_call;
+    if (counters)
+    {
+        per_call = counters->stop();
+        for (auto & value : per_call)
+            if (value)
+                *value /= static_cast<double>(n) * repetitions;
+    }
+    return {n, detail::median(real), std::ranges::min(real), detail::median(cpu), per_call};
+}
+
+class JsonWriter
+{
+public:
+    explicit JsonWriter(std::ostream & out)
+        : _out{out}
+    {
+    }
+
+    void begin_object(std::string_view key = {}) { open(key, '{'); }
+    void end_object() { close('}'); }
+    void begin_array(std::string_view key) { open(key, '['); }
+    void end_array() { close(']'); }
+
+    void field(std::string_view key, std::string_view value)
+    {
+        prefix(key);
+        string(value);
+    }
+    void field(std::string_view key, const char * value) { field(key, std::string_view(value)); }
+    void field(std::string_view key, const std::string & value) { field(key, std::string_view(value)); }
+
+    void field(std::string_view key, double value)
+    {
+        prefix(key);
+        // JSON has no NaN / infinity
+        if (!std::isfinite(value))
+        {
+            _out << "null";
+            return;
+        }
+        char buffer[32];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        _out << std::string_view(buffer, ec == std::errc{} ? static_cast<std::size_t>(end - buffer) : 0);
+    }
+
+    void field(std::string_view key, uint64_t value)
+    {
+        prefix(key);
+        _out << value;
+    }
+
+    void field(std::string_view key, bool value)
+    {
+        prefix(key);
+        _out << (value ? "true" : "false");
+    }
+
+private:
+    void open(std::string_view key, char bracket)
+    {
+        prefix(key);
+        _out << bracket;
+        _first.push_back(true);
+    }
+
+    void close(char bracket)
+    {
+        _first.pop_back();
+        _out << '\n' << std::string(2 * _first.size(), ' ') << bracket;
+        if (_first.empty())
+            _out << '\n';
+    }
+
+    void prefix(std::string_view key)
+    {
+        if (!_first.empty())
+        {
+            _out << (_first.back() ? "\n" : ",\n") << std::string(2 * _first.size(), ' ');
+            _first.back() = false;
+        }
+        if (!key.empty())
+        {
+            string(key);
+            _out << ": ";
+        }
+    }
+
+    void string(std::string_view value)
+    {
+        _out << '"';
+        for (const char c : value)
+        {
+            if (c == '"' || c == '\\')
+                _out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                _out << ' ';
+            else
+                _out << c;
+        }
+        _out << '"';
+    }
+
+    std::ostream & _out;
+    std::vector<bool> _first; //!< Per open object / array: no member written yet
+};
+
+// nullopt (after printing the problem) if the command line is invalid
+inline std::optional<Options> parse_options(int argc, char ** argv)
+{
+    Options options;
+    const auto usage = [argv]
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " [--filter SUBSTRING] [--min-time SECONDS] [--repetitions N] [--max-size N] [--out FILE] [--list]"
+                     " [--no-counters]\n";
+        return std::nullopt;
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--list")
+        {
+            options.list = true;
+            continue;
+        }
+        if (arg == "--no-counters")
+        {
+            options.counters = false;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return usage();
+        const std::string_view value = argv[++i];
+        const auto parse = [value](auto & out)
+        {
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), out);
+            return ec == std::errc{} && end == value.data() + value.size();
+        };
+        bool ok = true;
+        if (arg == "--filter")
+            options.filter = value;
+        else if (arg == "--out")
+            options.out = value;
+        else if (arg == "--min-time")
+            ok = parse(options.min_time) && options.min_time >= 0.0;
+        else if (arg == "--repetitions")
+            ok = parse(options.repetitions) && options.repetitions > 0;
+        else if (arg == "--max-size")
+            ok = parse(options.max_size) && options.max_size >= 2;
+        else
+            ok = false;
+        if (!ok)
+            return usage();
+    }
+    return options;
+}
+
+}
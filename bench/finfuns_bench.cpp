@@ -0,0 +1,996 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// finfuns_bench: times npv, irr, xnpv, xirr, pv and fv through the C++ headers and the C library, and
+// the batch paths, over series lengths 2 .. 1e6, cashflow shapes and date types. Prints progress to
+// stderr and the results as JSON (see bench.hpp) to stdout or --out FILE. Where Linux perf counters
+// are available, every result also gets the counts per call, cycles per item and IPC.
+//
+//   finfuns_bench --filter xirr/cpp --max-size 10000 --out before.json
+
+#include "bench.hpp"
+#include "perf_counters.hpp"
+
+#include <finfunslib/finfunslib.h>
+
+#include <finfuns/amortization.hpp>
+#include <finfuns/annuity_batch.hpp>
+#include <finfuns/batch.hpp>
+#include <finfuns/finfuns.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace finfuns;
+using namespace finfuns::bench;
+
+namespace
+{
+
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// Deterministic pseudo random numbers in [0, 1), so every run times the same inputs
+struct Lcg
+{
+    uint64_t state = 42;
+
+    double next()
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(state >> 11) * 0x1p-53;
+    }
+};
+
+// Cashflow shapes with a known root: the tail is generated, the first cashflow then makes NPV(rate) = 0
+struct Shape
+{
+    const char * name;
+    double rate;
+    bool alternating; //!< Tail signs alternate (several sign changes), else all positive
+};
+
+constexpr Shape shapes[] = {
+    {"conventional", 0.1, false},
+    {"alternating", 0.1, true},
+    {"near_zero", 1e-7, false},
+    {"huge", 20.0, false},
+};
+
+constexpr Shape conventional = shapes[0];
+
+struct Series
+{
+    std::vector<double> cashflows; //!< Root at shape.rate per period
+    std::vector<double> dated_cashflows; //!< Root at shape.rate per year, with the dates
+    std::vector<int> dates; //!< Days since epoch, about a month apart
+    std::vector<std::chrono::sys_days> sys_dates;
+    std::vector<int64_t> datetime64_ms; //!< The dates at noon, DateTime64(3) encoded
+    std::vector<double> shuffled_cashflows; //!< dated_cashflows / dates pairs in random order
+    std::vector<int> shuffled_dates;
+};
+
+Series make_series(std::size_t n, const Shape & shape, Lcg & rng)
+{
+    Series series;
+    series.cashflows.resize(n);
+    series.dates.resize(n);
+    int date = 18000;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        series.dates[i] = date;
+        date += 1 + static_cast<int>(rng.next() * 60);
+        const bool negative = shape.alternating && i % 2 == 0;
+        series.cashflows[i] = negative ? -40.0 * (0.5 + rng.next()) : 100.0 * (1.0 + rng.next());
+    }
+    // Periods for irr / npv, ACT/365F year fractions for xirr / xnpv: the first cashflows differ
+    series.dated_cashflows = series.cashflows;
+    double tail = 0.0;
+    double dated_tail = 0.0;
+    for (std::size_t i = n - 1; i >= 1; --i)
+    {
+        tail = (tail + series.cashflows[i]) / (1.0 + shape.rate);
+        const double years = static_cast<double>(series.dates[i] - series.dates[0]) / 365.0;
+        dated_tail += series.cashflows[i] * std::pow(1.0 + shape.rate, -years);
+    }
+    series.cashflows[0] = -tail;
+    series.dated_cashflows[0] = -dated_tail;
+    series.sys_dates.reserve(n);
+    series.datetime64_ms.reserve(n);
+    for (const int d : series.dates)
+    {
+        series.sys_dates.emplace_back(std::chrono::days{d});
+        series.datetime64_ms.push_back(int64_t{d} * 86'400'000 + 43'200'000);
+    }
+    series.shuffled_cashflows = series.dated_cashflows;
+    series.shuffled_dates = series.dates;
+    for (std::size_t i = n - 1; i > 0; --i)
+    {
+        const auto j = static_cast<std::size_t>(rng.next() * static_cast<double>(i + 1));
+        std::swap(series.shuffled_cashflows[i], series.shuffled_cashflows[j]);
+        std::swap(series.shuffled_dates[i], series.shuffled_dates[j]);
+    }
+    return series;
+}
+
+// Many series of the same length in the flat offsets layout of the batch functions
+struct BatchData
+{
+    std::vector<double> cashflows;
+    std::vector<double> dated_cashflows;
+    std::vector<int> dates;
+    std::vector<uint64_t> offsets;
+    std::vector<double> results;
+    std::vector<FinFunsCode> codes;
+};
+
+std::shared_ptr<BatchData> make_batch(std::size_t row_size, std::size_t rows)
+{
+    auto batch = std::make_shared<BatchData>();
+    Lcg rng;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        const auto series = make_series(row_size, conventional, rng);
+        batch->cashflows.insert(batch->cashflows.end(), series.cashflows.begin(), series.cashflows.end());
+        batch->dated_cashflows.insert(batch->dated_cashflows.end(), series.dated_cashflows.begin(), series.dated_cashflows.end());
+        batch->dates.insert(batch->dates.end(), series.dates.begin(), series.dates.end());
+        batch->offsets.push_back(batch->cashflows.size());
+    }
+    batch->results.resize(rows);
+    batch->codes.resize(rows);
+    return batch;
+}
+
+template <typename T, typename E>
+double value_or_nan(const expected<T, E> & result)
+{
+    return result.has_value() ? result.value() : nan;
+}
+
+double value_or_nan(FinFunsCode code, double result)
+{
+    return code == FINFUNS_CODE_SUCCESS ? result : nan;
+}
+
+constexpr std::size_t series_lengths[] = {2, 8, 32, 128, 1'000, 10'000, 100'000, 1'000'000};
+constexpr std::size_t batch_row_lengths[] = {2, 8, 32, 128, 1'000};
+
+std::vector<std::size_t> series_sizes(const Options & options)
+{
+    std::vector<std::size_t> sizes;
+    for (const std::size_t size : series_lengths)
+        if (size <= options.max_size)
+            sizes.push_back(size);
+    return sizes;
+}
+
+void add_npv_cases(std::vector<Case> & cases, const Options & options)
+{
+    // The cost of an NPV does not depend on the values, only the solvers get every shape
+    for (const std::size_t n : series_sizes(options))
+    {
+        const auto make = [n] { return std::make_shared<Series>([n] { Lcg rng; return make_series(n, conventional, rng); }()); };
+        cases.push_back({"npv", "cpp", "", "", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop([s] { return value_or_nan(npv<IndexMode::ZeroBased>(0.07, s->cashflows)); });
+                         }});
+        cases.push_back({"npv", "c", "", "", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s]
+                                 {
+                                     double result = 0.0;
+                                     const auto code = finfuns_npv(
+                                         FINFUNS_ZERO_BASED, 0.07, s->cashflows.data(), static_cast<unsigned>(s->cashflows.size()), &result);
+                                     return value_or_nan(code, result);
+                                 });
+                         }});
+        cases.push_back({"xnpv", "cpp", "", "int", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s] {
+                                     return value_or_nan(
+                                         xnpv<DayCountConvention::ACT_365F>(0.07, s->dated_cashflows, std::span<const int>(s->dates)));
+                                 });
+                         }});
+        cases.push_back({"xnpv", "cpp", "", "int_act_act_isda", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s] {
+                                     return value_or_nan(
+                                         xnpv<DayCountConvention::ACT_ACT_ISDA>(0.07, s->dated_cashflows, std::span<const int>(s->dates)));
+                                 });
+                         }});
+        cases.push_back({"xnpv", "cpp", "", "int_30_360_us", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s] {
+                                     return value_or_nan(
+                                         xnpv<DayCountConvention::THIRTY_360_US>(0.07, s->dated_cashflows, std::span<const int>(s->dates)));
+                                 });
+                         }});
+        cases.push_back({"xnpv", "cpp", "", "sys_days", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s]
+                                 {
+                                     return value_or_nan(xnpv<DayCountConvention::ACT_365F>(
+                                         0.07, s->dated_cashflows, std::span<const std::chrono::sys_days>(s->sys_dates)));
+                                 });
+                         }});
+        cases.push_back({"xnpv", "cpp", "", "datetime64_ms", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s]
+                                 {
+                                     return value_or_nan(xnpv<DayCountConvention::ACT_365F, DateUnit::Milliseconds>(
+                                         0.07, s->dated_cashflows, std::span<const int64_t>(s->datetime64_ms)));
+                                 });
+                         }});
+        cases.push_back({"xnpv", "c", "", "int", n, 1, n, [make]
+                         {
+                             auto s = make();
+                             return loop(
+                                 [s]
+                                 {
+                                     double result = 0.0;
+                                     const auto code = finfuns_xnpv(
+                                         FINFUNS_ACT_365F,
+                                         0.07,
+                                         s->dated_cashflows.data(),
+                                         s->dates.data(),
+                                         static_cast<unsigned>(s->cashflows.size()),
+                                         &result);
+                                     return value_or_nan(code, result);
+                                 });
+                         }});
+    }
+}
+
+void add_irr_cases(std::vector<Case> & cases, const Options & options)
+{
+    for (const auto & shape : shapes)
+    {
+        for (const std::size_t n : series_sizes(options))
+        {
+            const auto make = [n, shape] { return std::make_shared<Series>([&] { Lcg rng; return make_series(n, shape, rng); }()); };
+            cases.push_back({"irr", "cpp", shape.name, "", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop([s] { return value_or_nan(irr(s->cashflows, 0.1)); });
+                             }});
+            cases.push_back({"irr", "c", shape.name, "", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop(
+                                     [s]
+                                     {
+                                         double result = 0.0;
+                                         const auto code
+                                             = finfuns_irr(s->cashflows.data(), static_cast<unsigned>(s->cashflows.size()), 0.1, &result);
+                                         return value_or_nan(code, result);
+                                     });
+                             }});
+            cases.push_back({"xirr", "cpp", shape.name, "int", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop(
+                                     [s] {
+                                         return value_or_nan(
+                                             xirr<DayCountConvention::ACT_365F>(s->dated_cashflows, std::span<const int>(s->dates), 0.1));
+                                     });
+                             }});
+            cases.push_back({"xirr", "cpp", shape.name, "sys_days", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop(
+                                     [s]
+                                     {
+                                         return value_or_nan(xirr<DayCountConvention::ACT_365F>(
+                                             s->dated_cashflows, std::span<const std::chrono::sys_days>(s->sys_dates), 0.1));
+                                     });
+                             }});
+            // Unsorted pairs as they are, and sorted by date first (what callers had to do before)
+            cases.push_back({"xirr", "cpp", shape.name, "int_unsorted", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop(
+                                     [s]
+                                     {
+                                         return value_or_nan(xirr<DayCountConvention::ACT_365F>(
+                                             s->shuffled_cashflows, std::span<const int>(s->shuffled_dates), 0.1));
+                                     });
+                             }});
+            cases.push_back({"xirr", "cpp", shape.name, "int_sort_first", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop(
+                                     [s]
+                                     {
+                                         std::vector<std::pair<int, double>> pairs(s->shuffled_dates.size());
+                                         for (std::size_t i = 0; i < pairs.size(); ++i)
+                                             pairs[i] = {s->shuffled_dates[i], s->shuffled_cashflows[i]};
+                                         std::ranges::sort(pairs, {}, &std::pair<int, double>::first);
+                                         std::vector<double> cashflows(pairs.size());
+                                         std::vector<int> dates(pairs.size());
+                                         for (std::size_t i = 0; i < pairs.size(); ++i)
+                                             std::tie(dates[i], cashflows[i]) = pairs[i];
+                                         return value_or_nan(xirr<DayCountConvention::ACT_365F>(cashflows, std::span<const int>(dates), 0.1));
+                                     });
+                             }});
+            cases.push_back({"xirr", "c", shape.name, "int", n, 1, n, [make]
+                             {
+                                 auto s = make();
+                                 return loop(
+                                     [s]
+                                     {
+                                         double result = 0.0;
+                                         const auto code = finfuns_xirr(
+                                             FINFUNS_ACT_365F,
+                                             s->dated_cashflows.data(),
+                                             s->dates.data(),
+                                             static_cast<unsigned>(s->cashflows.size()),
+                                             0.1,
+                                             &result);
+                                         return value_or_nan(code, result);
+                                     });
+                             }});
+        }
+    }
+}
+
+// MIRR / XMIRR as the textbook two passes, to compare the fused single pass with: the PV of the negative
+// cashflows, then the one of the positive cashflows (a running discount factor, or pow per dated cashflow)
+double mirr_two_pass(std::span<const double> cashflows, double finance_rate, double reinvest_rate)
+{
+    double negative = 0.0;
+    double discount = 1.0;
+    for (const double cf : cashflows)
+    {
+        negative += cf < 0 ? cf * discount : 0.0;
+        discount /= 1.0 + finance_rate;
+    }
+    double positive = 0.0;
+    discount = 1.0;
+    for (const double cf : cashflows)
+    {
+        positive += cf > 0 ? cf * discount : 0.0;
+        discount /= 1.0 + reinvest_rate;
+    }
+    return (1.0 + reinvest_rate) * std::pow(positive / -negative, 1.0 / static_cast<double>(cashflows.size() - 1)) - 1.0;
+}
+
+double xmirr_two_pass(std::span<const double> cashflows, std::span<const int> dates, double finance_rate, double reinvest_rate)
+{
+    double negative = 0.0;
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+        if (cashflows[i] < 0)
+            negative += cashflows[i] * std::pow(1.0 + finance_rate, -year_fraction<DayCountConvention::ACT_365F>(dates[0], dates[i]));
+    double positive = 0.0;
+    double horizon = 0.0;
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+    {
+        const double t = year_fraction<DayCountConvention::ACT_365F>(dates[0], dates[i]);
+        horizon = std::max(horizon, t);
+        if (cashflows[i] > 0)
+            positive += cashflows[i] * std::pow(1.0 + reinvest_rate, -t);
+    }
+    return (1.0 + reinvest_rate) * std::pow(positive / -negative, 1.0 / horizon) - 1.0;
+}
+
+void add_mirr_cases(std::vector<Case> & cases, const Options & options)
+{
+    static constexpr double finance_rate = 0.08;
+    static constexpr double reinvest_rate = 0.05;
+    // Alternating signs, so that both sums take half of the cashflows
+    static constexpr Shape alternating = shapes[1];
+    for (const std::size_t n : series_sizes(options))
+    {
+        const auto make = [n] { return std::make_shared<Series>([n] { Lcg rng; return make_series(n, alternating, rng); }()); };
+        const auto add = [&](const char * function, const char * api, const char * shape, const char * date_type, auto fn)
+        {
+            cases.push_back({function, api, shape, date_type, n, 1, n, [make, fn]
+                             {
+                                 auto s = make();
+                                 return loop([s, fn] { return fn(*s); });
+                             }});
+        };
+
+        add("mirr", "cpp", "fused", "",
+            [](const Series & s) { return value_or_nan(mirr(s.cashflows, finance_rate, reinvest_rate)); });
+        add("mirr", "cpp", "two_pass", "",
+            [](const Series & s) { return mirr_two_pass(s.cashflows, finance_rate, reinvest_rate); });
+        add("mirr", "c", "fused", "",
+            [](const Series & s)
+            {
+                double result = 0.0;
+                const auto code = finfuns_mirr(
+                    FINFUNS_ZERO_BASED, s.cashflows.data(), static_cast<unsigned>(s.cashflows.size()), finance_rate, reinvest_rate, &result);
+                return value_or_nan(code, result);
+            });
+        add("xmirr", "cpp", "fused", "int",
+            [](const Series & s) {
+                return value_or_nan(
+                    xmirr<DayCountConvention::ACT_365F>(s.dated_cashflows, std::span<const int>(s.dates), finance_rate, reinvest_rate));
+            });
+        add("xmirr", "cpp", "two_pass", "int",
+            [](const Series & s) { return xmirr_two_pass(s.dated_cashflows, s.dates, finance_rate, reinvest_rate); });
+        add("xmirr", "c", "fused", "int",
+            [](const Series & s)
+            {
+                double result = 0.0;
+                const auto code = finfuns_xmirr(
+                    FINFUNS_ACT_365F,
+                    s.dated_cashflows.data(),
+                    s.dates.data(),
+                    static_cast<unsigned>(s.cashflows.size()),
+                    finance_rate,
+                    reinvest_rate,
+                    &result);
+                return value_or_nan(code, result);
+            });
+    }
+}
+
+// pv / fv are O(1): one call evaluates a block of varied inputs, so that nothing is loop invariant
+constexpr std::size_t tvm_block = 1024;
+
+struct TvmInputs
+{
+    std::vector<double> rates;
+    std::vector<uint32_t> periods;
+};
+
+std::shared_ptr<TvmInputs> make_tvm_inputs()
+{
+    auto inputs = std::make_shared<TvmInputs>();
+    Lcg rng;
+    for (std::size_t i = 0; i < tvm_block; ++i)
+    {
+        inputs->rates.push_back(i % 64 == 0 ? 0.0 : 0.2 * rng.next() - 0.02);
+        inputs->periods.push_back(1 + static_cast<uint32_t>(rng.next() * 360));
+    }
+    return inputs;
+}
+
+template <typename Fn>
+Body tvm_loop(Fn fn)
+{
+    return loop(
+        [inputs = make_tvm_inputs(), fn]
+        {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < tvm_block; ++i)
+                sum += fn(inputs->rates[i], inputs->periods[i]);
+            return sum;
+        });
+}
+
+void add_tvm_cases(std::vector<Case> & cases)
+{
+    const auto add = [&cases](const char * function, const char * api, const char * due, auto fn)
+    { cases.push_back({function, api, due, "", 1, tvm_block, tvm_block, [fn] { return tvm_loop(fn); }}); };
+
+    add("pv", "cpp", "end", [](double r, uint32_t n) { return pv<PaymentDueType::EndOfPeriod>(r, n, -100.0, 1000.0); });
+    add("pv", "cpp", "begin", [](double r, uint32_t n) { return pv<PaymentDueType::BeginningOfPeriod>(r, n, -100.0, 1000.0); });
+    add("pv", "c", "end", [](double r, uint32_t n) { return finfuns_pv_due_end(r, n, -100.0, 1000.0); });
+    add("pv", "c", "begin", [](double r, uint32_t n) { return finfuns_pv_due_begin(r, n, -100.0, 1000.0); });
+    add("fv", "cpp", "end", [](double r, uint32_t n) { return fv<PaymentDueType::EndOfPeriod>(r, n, -100.0, 1000.0); });
+    add("fv", "cpp", "begin", [](double r, uint32_t n) { return fv<PaymentDueType::BeginningOfPeriod>(r, n, -100.0, 1000.0); });
+    add("fv", "c", "end", [](double r, uint32_t n) { return finfuns_fv_due_end(r, n, -100.0, 1000.0); });
+    add("fv", "c", "begin", [](double r, uint32_t n) { return finfuns_fv_due_begin(r, n, -100.0, 1000.0); });
+    add("pmt", "cpp", "end", [](double r, uint32_t n) { return pmt<PaymentDueType::EndOfPeriod>(r, n, 1000.0, -100.0); });
+    add("pmt", "c", "end", [](double r, uint32_t n) { return finfuns_pmt(r, n, 1000.0, -100.0, FINFUNS_DUE_END); });
+}
+
+// A loan table: rate, periods, payment, lump sum and due type per row, with the same inputs as the
+// scalar pv / fv cases (so ns/item compares), or only the periods varying ("broadcast")
+struct TvmTable
+{
+    std::vector<double> rates;
+    std::vector<uint32_t> periods;
+    std::vector<double> pmts;
+    std::vector<double> values;
+    std::vector<PaymentDueType> dues;
+    std::vector<FinFunsPaymentDue> c_dues;
+    std::vector<double> results;
+};
+
+std::shared_ptr<TvmTable> make_tvm_table(std::size_t rows)
+{
+    auto table = std::make_shared<TvmTable>();
+    const auto inputs = make_tvm_inputs();
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        table->rates.push_back(inputs->rates[i % tvm_block]);
+        table->periods.push_back(inputs->periods[i % tvm_block]);
+        table->pmts.push_back(-100.0);
+        table->values.push_back(1000.0);
+        table->dues.push_back(i % 2 == 0 ? PaymentDueType::EndOfPeriod : PaymentDueType::BeginningOfPeriod);
+        table->c_dues.push_back(i % 2 == 0 ? FINFUNS_DUE_END : FINFUNS_DUE_BEGIN);
+    }
+    table->results.resize(rows);
+    return table;
+}
+
+void add_tvm_batch_cases(std::vector<Case> & cases, const Options & options)
+{
+    const std::size_t rows = std::min<std::size_t>(options.max_size, 1'000'000);
+    const auto add = [&](const char * function, const char * api, const char * shape, auto fn)
+    {
+        cases.push_back({function, api, shape, "", 1, rows, rows, [=]
+                         {
+                             return loop([table = make_tvm_table(rows), fn] {
+                                 fn(*table);
+                                 return table->results[0];
+                             });
+                         }});
+    };
+
+    for (const bool fv_batch : {false, true})
+    {
+        const auto function = fv_batch ? "fv_batch" : "pv_batch";
+        add(function, "cpp", "columns",
+            [fv_batch](TvmTable & t)
+            {
+                const auto run = fv_batch ? &batch::fv<simd::compiled_isa, PaymentDueType> : &batch::pv<simd::compiled_isa, PaymentDueType>;
+                run(batch::column<double>(t.rates),
+                    batch::column<uint32_t>(t.periods),
+                    batch::column<double>(t.pmts),
+                    batch::column<double>(t.values),
+                    batch::column<PaymentDueType>(t.dues),
+                    t.results);
+            });
+        add(function, "c", "columns",
+            [fv_batch](TvmTable & t)
+            {
+                const auto run = fv_batch ? &finfuns_fv_batch : &finfuns_pv_batch;
+                run(t.rates.data(), 1, t.periods.data(), 1, t.pmts.data(), 1, t.values.data(), 1, t.c_dues.data(), 1, t.results.size(), t.results.data());
+            });
+        add(function, "c", "broadcast",
+            [fv_batch](TvmTable & t)
+            {
+                const auto run = fv_batch ? &finfuns_fv_batch : &finfuns_pv_batch;
+                run(t.rates.data(), 0, t.periods.data(), 1, t.pmts.data(), 0, t.values.data(), 0, t.c_dues.data(), 0, t.results.size(), t.results.data());
+            });
+    }
+
+    // The table's values as present values, pmts as future values
+    add("pmt_batch", "cpp", "columns",
+        [](TvmTable & t)
+        {
+            batch::pmt(
+                batch::column<double>(t.rates),
+                batch::column<uint32_t>(t.periods),
+                batch::column<double>(t.values),
+                batch::column<double>(t.pmts),
+                batch::column<PaymentDueType>(t.dues),
+                t.results);
+        });
+    add("pmt_batch", "c", "columns",
+        [](TvmTable & t) {
+            finfuns_pmt_batch(
+                t.rates.data(), 1, t.periods.data(), 1, t.values.data(), 1, t.pmts.data(), 1, t.c_dues.data(), 1, t.results.size(), t.results.data());
+        });
+}
+
+// Loans for RATE to back out: the rates and periods of the pv / fv cases, payments of pmt() on 1000
+struct RateTable
+{
+    std::vector<uint32_t> periods;
+    std::vector<double> pmts;
+    std::vector<PaymentDueType> dues;
+    std::vector<FinFunsPaymentDue> c_dues;
+    std::vector<double> results;
+    std::vector<FinFunsCode> codes;
+};
+
+void add_rate_cases(std::vector<Case> & cases, const Options & options)
+{
+    static constexpr double present_value = 1000.0;
+    static constexpr double future_value = 0.0;
+    const std::size_t rows = std::min<std::size_t>(options.max_size, 100'000);
+    const auto make = [rows]
+    {
+        auto table = std::make_shared<RateTable>();
+        const auto inputs = make_tvm_inputs();
+        for (std::size_t i = 0; i < rows; ++i)
+        {
+            const double rate = inputs->rates[i % tvm_block];
+            const uint32_t n = inputs->periods[i % tvm_block];
+            const bool begin = i % 2 != 0;
+            table->periods.push_back(n);
+            table->pmts.push_back(
+                begin ? pmt<PaymentDueType::BeginningOfPeriod>(rate, n, present_value, future_value)
+                      : pmt<PaymentDueType::EndOfPeriod>(rate, n, present_value, future_value));
+            table->dues.push_back(begin ? PaymentDueType::BeginningOfPeriod : PaymentDueType::EndOfPeriod);
+            table->c_dues.push_back(begin ? FINFUNS_DUE_BEGIN : FINFUNS_DUE_END);
+        }
+        table->results.resize(rows);
+        table->codes.resize(rows);
+        return table;
+    };
+    const auto add = [&](const char * api, const char * shape, auto fn)
+    {
+        cases.push_back({"rate_batch", api, shape, "", 1, rows, rows, [=]
+                         {
+                             return loop([table = make(), fn] {
+                                 fn(*table);
+                                 return table->results[0];
+                             });
+                         }});
+    };
+
+    add("cpp", "closed_form_guess",
+        [](RateTable & t)
+        {
+            batch::rate(
+                batch::column<uint32_t>(t.periods),
+                batch::column<double>(t.pmts),
+                batch::broadcast(present_value),
+                batch::broadcast(future_value),
+                batch::column<PaymentDueType>(t.dues),
+                t.results,
+                [](std::size_t, const AnnuityRateError &) {});
+        });
+    // Excel's default starting point, for comparison
+    add("cpp", "guess_0.1",
+        [](RateTable & t)
+        {
+            for (std::size_t i = 0; i < t.results.size(); ++i)
+            {
+                const auto res = t.dues[i] == PaymentDueType::EndOfPeriod
+                    ? rate<PaymentDueType::EndOfPeriod>(t.periods[i], t.pmts[i], present_value, future_value, 0.1)
+                    : rate<PaymentDueType::BeginningOfPeriod>(t.periods[i], t.pmts[i], present_value, future_value, 0.1);
+                t.results[i] = res.value_or(std::numeric_limits<double>::quiet_NaN());
+            }
+        });
+    add("c", "closed_form_guess",
+        [](RateTable & t)
+        {
+            finfuns_rate_batch(
+                t.periods.data(), 1, t.pmts.data(), 1, &present_value, 0, &future_value, 0, t.c_dues.data(), 1, t.results.size(), t.results.data(), t.codes.data());
+        });
+}
+
+// Monthly schedules of 30 year loans, about a million periods per call
+struct AmortizationData
+{
+    std::vector<double> rates;
+    std::vector<double> present_values;
+    std::vector<FinFunsPaymentDue> dues;
+    std::vector<uint64_t> offsets;
+    std::vector<double> interest;
+    std::vector<double> principal;
+    std::vector<double> balance;
+    std::vector<double> payments;
+    std::vector<FinFunsCode> codes;
+};
+
+void add_amortization_cases(std::vector<Case> & cases, const Options & options)
+{
+    constexpr std::size_t periods = 360;
+    const std::size_t loans = std::max<std::size_t>(1, std::min<std::size_t>(options.max_size, 1'000'000) / periods);
+    const auto make = [loans]
+    {
+        auto data = std::make_shared<AmortizationData>();
+        Lcg rng{11};
+        for (std::size_t i = 0; i < loans; ++i)
+        {
+            data->rates.push_back((0.01 + 0.07 * rng.next()) / 12);
+            data->present_values.push_back(50'000.0 + 450'000.0 * rng.next());
+            data->dues.push_back(i % 2 == 0 ? FINFUNS_DUE_END : FINFUNS_DUE_BEGIN);
+            data->offsets.push_back((i + 1) * periods);
+        }
+        data->interest.resize(loans * periods);
+        data->principal.resize(loans * periods);
+        data->balance.resize(loans * periods);
+        data->payments.resize(loans);
+        data->codes.resize(loans);
+        return data;
+    };
+    const auto add = [&](const char * api, auto fn)
+    {
+        cases.push_back({"amortization_batch", api, "", "", periods, loans, loans * periods, [=]
+                         {
+                             return loop([data = make(), fn] {
+                                 fn(*data);
+                                 return data->payments[0];
+                             });
+                         }});
+    };
+
+    const double future_value = 0.0;
+    add("cpp",
+        [future_value](AmortizationData & d)
+        {
+            batch::amortization_schedules(
+                batch::AmortizationLoans<FinFunsPaymentDue>{
+                    batch::column<double>(d.rates), batch::column<double>(d.present_values), batch::broadcast(future_value), batch::column<FinFunsPaymentDue>(d.dues)},
+                d.offsets,
+                AmortizationSchedule{d.interest, d.principal, d.balance},
+                d.payments,
+                [](std::size_t, AmortizationError) {});
+        });
+    add("c",
+        [future_value](AmortizationData & d)
+        {
+            finfuns_amortization_schedule_batch(
+                d.rates.data(), 1, d.present_values.data(), 1, &future_value, 0, d.dues.data(), 1, d.offsets.data(), d.offsets.size(),
+                d.interest.data(), d.principal.data(), d.balance.data(), d.payments.data(), d.codes.data());
+        });
+    add("c_mt",
+        [future_value](AmortizationData & d)
+        {
+            finfuns_amortization_schedule_batch_mt(
+                d.rates.data(), 1, d.present_values.data(), 1, &future_value, 0, d.dues.data(), 1, d.offsets.data(), d.offsets.size(),
+                d.interest.data(), d.principal.data(), d.balance.data(), d.payments.data(), d.codes.data(), 0);
+        });
+}
+
+void add_batch_cases(std::vector<Case> & cases, const Options & options)
+{
+    // About a million cashflows per call, split into rows of different lengths
+    const std::size_t total = std::min<std::size_t>(options.max_size, 1'000'000);
+    for (const std::size_t row_size : batch_row_lengths)
+    {
+        if (row_size > total)
+            continue;
+        const std::size_t rows = total / row_size;
+        const std::size_t items = rows * row_size;
+        const auto add = [&](const char * function, const char * api, const char * date_type, auto fn)
+        {
+            cases.push_back({function, api, conventional.name, date_type, row_size, rows, items, [=]
+                             {
+                                 return loop([batch = make_batch(row_size, rows), fn] {
+                                     fn(*batch);
+                                     return batch->results[0];
+                                 });
+                             }});
+        };
+
+        add("irr_batch", "cpp", "",
+            [](BatchData & b) { batch::irr(b.cashflows, b.offsets, batch::RowGuesses(0.1), b.results, [](std::size_t, auto) {}); });
+        add("irr_batch", "c", "",
+            [](BatchData & b)
+            { finfuns_irr_batch(b.cashflows.data(), b.offsets.data(), b.offsets.size(), 0.1, b.results.data(), b.codes.data()); });
+        add("irr_batch", "c_mt", "",
+            [](BatchData & b) {
+                finfuns_irr_batch_mt(b.cashflows.data(), b.offsets.data(), b.offsets.size(), 0.1, b.results.data(), b.codes.data(), 0);
+            });
+        add("xirr_batch", "cpp", "int",
+            [](BatchData & b)
+            {
+                batch::xirr<DayCountConvention::ACT_365F>(
+                    std::span<const double>(b.dated_cashflows),
+                    std::span<const int>(b.dates),
+                    std::span<const uint64_t>(b.offsets),
+                    batch::RowGuesses(0.1),
+                    b.results,
+                    [](std::size_t, auto) {});
+            });
+        add("xirr_batch", "c", "int",
+            [](BatchData & b)
+            {
+                (void)finfuns_xirr_batch(
+                    FINFUNS_ACT_365F, b.dated_cashflows.data(), b.dates.data(), b.offsets.data(), b.offsets.size(), 0.1, b.results.data(), b.codes.data());
+            });
+        add("xirr_batch", "c_mt", "int",
+            [](BatchData & b)
+            {
+                (void)finfuns_xirr_batch_mt(
+                    FINFUNS_ACT_365F,
+                    b.dated_cashflows.data(),
+                    b.dates.data(),
+                    b.offsets.data(),
+                    b.offsets.size(),
+                    0.1,
+                    b.results.data(),
+                    b.codes.data(),
+                    0);
+            });
+        add("mirr_batch", "c", "",
+            [](BatchData & b) {
+                finfuns_mirr_batch(
+                    FINFUNS_ZERO_BASED, b.cashflows.data(), b.offsets.data(), b.offsets.size(), 0.08, 0.05, b.results.data(), b.codes.data());
+            });
+        add("xmirr_batch", "c", "int",
+            [](BatchData & b)
+            {
+                (void)finfuns_xmirr_batch(
+                    FINFUNS_ACT_365F,
+                    b.dated_cashflows.data(),
+                    b.dates.data(),
+                    b.offsets.data(),
+                    b.offsets.size(),
+                    0.08,
+                    0.05,
+                    b.results.data(),
+                    b.codes.data());
+            });
+    }
+}
+
+std::optional<double> cycles_per_item(const Case & c, const Measurement & m)
+{
+    const auto & cycles = m.counters[static_cast<std::size_t>(Counter::Cycles)];
+    if (!cycles)
+        return std::nullopt;
+    return *cycles / static_cast<double>(c.items);
+}
+
+std::optional<double> instructions_per_cycle(const Measurement & m)
+{
+    const auto & cycles = m.counters[static_cast<std::size_t>(Counter::Cycles)];
+    const auto & instructions = m.counters[static_cast<std::size_t>(Counter::Instructions)];
+    if (!cycles || !instructions || *cycles <= 0.0)
+        return std::nullopt;
+    return *instructions / *cycles;
+}
+
+std::string counters_description(const PerfCounters * counters)
+{
+    if (!counters)
+        return "disabled";
+    std::string names;
+    for (std::size_t i = 0; i < counter_count; ++i)
+        if (counters->available(static_cast<Counter>(i)))
+            names += (names.empty() ? "" : ",") + std::string(counter_name(static_cast<Counter>(i)));
+    if (counters->status().empty())
+        return names;
+    return (names.empty() ? "unavailable" : names) + " (" + counters->status() + ")";
+}
+
+void write_json(
+    std::ostream & out,
+    const Options & options,
+    const std::string & counters_info,
+    const std::vector<std::pair<const Case *, Measurement>> & runs,
+    const std::vector<double> & results)
+{
+    auto json = JsonWriter(out);
+    json.begin_object();
+    json.begin_object("context");
+    json.field("library", "finfuns");
+#ifdef FINFUNS_BENCH_VERSION
+    json.field("library_version", FINFUNS_BENCH_VERSION);
+#endif
+#ifdef FINFUNS_BENCH_BUILD_TYPE
+    json.field("library_build_type", FINFUNS_BENCH_BUILD_TYPE);
+#endif
+#ifdef __VERSION__
+    json.field("compiler", __VERSION__);
+#endif
+    json.field("simd_isa", simd::isa_to_string(simd::compiled_isa));
+    json.field("min_time", options.min_time);
+    json.field("repetitions", static_cast<uint64_t>(options.repetitions));
+    json.field("perf_counters", counters_info);
+    json.end_object();
+
+    json.begin_array("benchmarks");
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        const auto & [c, m] = runs[i];
+        json.begin_object();
+        json.field("name", c->name());
+        json.field("run_name", c->name());
+        json.field("run_type", "iteration");
+        json.field("iterations", m.iterations);
+        json.field("real_time", m.real_ns);
+        json.field("cpu_time", m.cpu_ns);
+        json.field("time_unit", "ns");
+        json.field("real_time_min", m.real_ns_min);
+        json.field("items_per_second", static_cast<double>(c->items) * 1e9 / m.real_ns);
+        json.field("function", c->function);
+        json.field("api", c->api);
+        json.field("shape", c->shape);
+        json.field("date_type", c->date_type);
+        json.field("size", static_cast<uint64_t>(c->size));
+        json.field("rows", static_cast<uint64_t>(c->rows));
+        json.field("result", results[i]);
+        for (std::size_t k = 0; k < counter_count; ++k)
+            if (const auto & value = m.counters[k])
+                json.field(counter_name(static_cast<Counter>(k)), *value);
+        if (const auto cpi = cycles_per_item(*c, m))
+            json.field("cycles_per_item", *cpi);
+        if (const auto ipc = instructions_per_cycle(m))
+            json.field("ipc", *ipc);
+        json.end_object();
+    }
+    json.end_array();
+    json.end_object();
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+    const auto options = parse_options(argc, argv);
+    if (!options)
+        return 2;
+
+    std::vector<Case> cases;
+    add_npv_cases(cases, *options);
+    add_irr_cases(cases, *options);
+    add_mirr_cases(cases, *options);
+    add_tvm_cases(cases);
+    add_tvm_batch_cases(cases, *options);
+    add_rate_cases(cases, *options);
+    add_amortization_cases(cases, *options);
+    add_batch_cases(cases, *options);
+
+    // Timing only if the counters cannot be opened at all
+    std::optional<PerfCounters> counters;
+    std::string counters_info = counters_description(nullptr);
+    if (options->counters && !options->list)
+    {
+        counters.emplace();
+        counters_info = counters_description(&*counters);
+        if (!counters->status().empty())
+            std::cerr << "perf counters: " << counters_info << '\n';
+        if (!counters->available())
+            counters.reset();
+    }
+    PerfCounters * active_counters = counters ? &*counters : nullptr;
+
+    std::vector<std::pair<const Case *, Measurement>> runs;
+    std::vector<double> results;
+    for (const auto & c : cases)
+    {
+        const auto name = c.name();
+        if (name.find(options->filter) == std::string::npos)
+            continue;
+        if (options->list)
+        {
+            std::cout << name << '\n';
+            continue;
+        }
+        const Body body = c.setup();
+        const auto m = measure(body, *options, active_counters);
+        runs.emplace_back(&c, m);
+        results.push_back(body.result);
+        std::cerr << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << m.real_ns
+                  << " ns" << std::setw(12) << std::setprecision(2) << m.real_ns / static_cast<double>(c.items) << " ns/item";
+        if (const auto cpi = cycles_per_item(c, m))
+            std::cerr << std::setw(12) << *cpi << " cycles/item";
+        if (const auto ipc = instructions_per_cycle(m))
+            std::cerr << std::setw(8) << *ipc << " IPC";
+        std::cerr << '\n';
+    }
+    if (options->list)
+        return 0;
+
+    if (options->out.empty())
+    {
+        write_json(std::cout, *options, counters_info, runs, results);
+        return 0;
+    }
+    auto file = std::ofstream(options->out);
+    write_json(file, *options, counters_info, runs, results);
+    return file.good() ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifdef __linux__
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+
+#    include <cerrno>
+#    include <cstring>
+#endif
+
+// Hardware performance counters of the benchmarked code, through Linux perf_event_open.
+//
+// Every counter is opened on its own (user space only, inherited by threads started while it runs, so
+// the _mt batches are counted too), and any subset may be missing: no PMU in a VM, perf_event_paranoid
+// too strict, seccomp in a container, not Linux at all. When the kernel multiplexes more counters than
+// the PMU has, the counts are scaled by enabled / running time like `perf stat` does.
+
+namespace finfuns::bench
+{
+
+enum class Counter : std::size_t
+{
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1dMisses, //!< L1 data cache read misses
+    LlcMisses, //!< Last level cache misses
+};
+
+inline constexpr std::size_t counter_count = 5;
+
+constexpr std::string_view counter_name(Counter counter)
+{
+    switch (counter)
+    {
+        case Counter::Cycles:
+            return "cycles";
+        case Counter::Instructions:
+            return "instructions";
+        case Counter::BranchMisses:
+            return "branch_misses";
+        case Counter::L1dMisses:
+            return "l1d_misses";
+        case Counter::LlcMisses:
+            return "llc_misses";
+    }
+    return "unknown";
+}
+
+// Counts between start() and stop(), nullopt for counters that are not available
+using CounterValues = std::array<std::optional<double>, counter_count>;
+
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+#ifdef __linux__
+        constexpr auto cache_event = [](uint64_t cache, uint64_t op, uint64_t result) { return cache | (op << 8) | (result << 16); };
+        const std::array<std::pair<uint32_t, uint64_t>, counter_count> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        }};
+        for (std::size_t i = 0; i < counter_count; ++i)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            _fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (_fds[i] < 0 && _status.empty())
+                _status = std::string(counter_name(static_cast<Counter>(i))) + ": " + std::strerror(errno);
+        }
+#else
+        _status = "perf_event_open is Linux only";
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (const int fd : _fds)
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters & operator=(const PerfCounters &) = delete;
+
+    bool available() const
+    {
+        for (const int fd : _fds)
+            if (fd >= 0)
+                return true;
+        return false;
+    }
+
+    bool available(Counter counter) const { return _fds[static_cast<std::size_t>(counter)] >= 0; }
+
+    // Why the first missing counter could not be opened, empty if all are there
+    const std::string & status() const { return _status; }
+
+    void start()
+    {
+#ifdef __linux__
+        for (const int fd : _fds)
+        {
+            if (fd < 0)
+                continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    CounterValues stop()
+    {
+        CounterValues values;
+#ifdef __linux__
+        for (const int fd : _fds)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (std::size_t i = 0; i < counter_count; ++i)
+        {
+            if (_fds[i] < 0)
+                continue;
+            // value, time enabled, time running
+            uint64_t data[3] = {};
+            if (read(_fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+                continue;
+            values[i] = static_cast<double>(data[0]) * (static_cast<double>(data[1]) / static_cast<double>(data[2]));
+        }
+#endif
+        return values;
+    }
+
+private:
+    std::array<int, counter_count> _fds = {-1, -1, -1, -1, -1};
+    std::string _status;
+};
+
+}
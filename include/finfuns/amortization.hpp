@@ -0,0 +1,117 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/expected.hpp>
+#include <finfuns/payment_due_type.hpp>
+#include <finfuns/pmt.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace finfuns
+{
+
+enum class AmortizationError : int32_t
+{
+    InvalidRate, //!< rate is NaN/infinity or <= -1
+    EmptySchedule, //!< the schedule has no periods
+    ScheduleSizeMismatch, //!< interest, principal and balance differ in size
+    InvalidDueType, //!< due type other than EndOfPeriod / BeginningOfPeriod (batch::amortization_schedules)
+};
+
+constexpr std::string_view error_to_sv(AmortizationError error)
+{
+    switch (error)
+    {
+        case AmortizationError::InvalidRate:
+            return "Invalid rate: NaN, infinity or <= -1";
+        case AmortizationError::EmptySchedule:
+            return "Schedule has no periods";
+        case AmortizationError::ScheduleSizeMismatch:
+            return "Interest, principal and balance sizes differ";
+        case AmortizationError::InvalidDueType:
+            return "Unsupported payment due type";
+        default:
+            return "Unknown amortization error";
+    }
+}
+
+// Caller provided columns of a schedule, one element per period
+struct AmortizationSchedule
+{
+    std::span<double> interest; //!< ipmt() of the period
+    std::span<double> principal; //!< ppmt() of the period
+    std::span<double> balance; //!< Balance after the period's payment, in the sign of present_value
+};
+
+// Fills the schedule of the loan paid by pmt<due_type>(rate, schedule.size(), present_value, future_value)
+// and returns that payment. Period k (0 based) is payment k + 1 of ipmt() / ppmt().
+//
+// The periods are filled by the recurrence balance' = balance * (1 + rate) + payment, with interest =
+// -rate * balance and principal = payment - interest: a multiply-add per period instead of a pow. An
+// error in the balance grows by (1 + rate) per step, so the recurrence runs from the last balance
+// (-future_value, or -future_value / (1 + rate) with payments at the beginning of the period, as the
+// last period's interest is still to accrue) backwards for rate >= 0, and from present_value forwards
+// for rate < 0. Either way the errors die out instead of compounding, and the schedule stays within
+// about periods ulps of present_value even where (1 + rate)^periods is huge.
+template <PaymentDueType due_type>
+expected<double, AmortizationError>
+amortization_schedule(double rate, double present_value, double future_value, const AmortizationSchedule & schedule)
+{
+    if (!std::isfinite(rate) || rate <= -1.0) [[unlikely]]
+        return unexpected(AmortizationError::InvalidRate);
+    const std::size_t periods = schedule.interest.size();
+    if (periods == 0) [[unlikely]]
+        return unexpected(AmortizationError::EmptySchedule);
+    if (schedule.principal.size() != periods || schedule.balance.size() != periods) [[unlikely]]
+        return unexpected(AmortizationError::ScheduleSizeMismatch);
+
+    constexpr bool due_begin = due_type == PaymentDueType::BeginningOfPeriod;
+    const double payment = pmt<due_type>(rate, static_cast<uint32_t>(periods), present_value, future_value);
+    // A payment at the beginning of the first period comes before any interest accrued
+    const double first_interest = due_begin ? 0.0 : -rate * present_value;
+    schedule.interest[0] = first_interest;
+    schedule.principal[0] = payment - first_interest;
+
+    if (rate < 0.0)
+    {
+        double balance = present_value + (payment - first_interest);
+        schedule.balance[0] = balance;
+        for (std::size_t k = 1; k < periods; ++k)
+        {
+            const double interest = -rate * balance;
+            const double principal = payment - interest;
+            balance += principal;
+            schedule.interest[k] = interest;
+            schedule.principal[k] = principal;
+            schedule.balance[k] = balance;
+        }
+    }
+    else
+    {
+        const double discount = 1.0 / (1.0 + rate);
+        double balance = due_begin ? -future_value * discount : -future_value;
+        for (std::size_t k = periods - 1; k > 0; --k)
+        {
+            schedule.balance[k] = balance;
+            // The balance after the previous payment
+            balance = (balance - payment) * discount;
+            const double interest = -rate * balance;
+            schedule.interest[k] = interest;
+            schedule.principal[k] = payment - interest;
+        }
+        schedule.balance[0] = balance;
+    }
+    return payment;
+}
+
+}
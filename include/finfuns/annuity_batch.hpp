@@ -0,0 +1,224 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/amortization.hpp>
+#include <finfuns/annuity_kernels.hpp>
+#include <finfuns/batch.hpp>
+#include <finfuns/payment_due_type.hpp>
+#include <finfuns/rate.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Columnar pv / fv / pmt: one result per row of a loan table, every input either a column or one value
+// for all rows. Results match pv() / fv() / pmt() up to rounding (see annuity_kernels.hpp), with NaN
+// where they return NaN and also for a due type other than EndOfPeriod / BeginningOfPeriod.
+//
+// batch::rate solves every row from its closed form guess (see rate.hpp): no pow per evaluation, so a
+// row costs a handful of exp / log1p.
+//
+// amortization_schedules fills the schedules of many loans back to back, delimited by offsets like
+// the rows of batch::irr (see batch.hpp).
+
+namespace finfuns::batch
+{
+
+// Row i is data[i * stride]: stride 1 for a contiguous column, 0 to use *data for every row
+template <typename T>
+struct Column
+{
+    const T * data;
+    std::size_t stride = 1;
+
+    T operator[](std::size_t row) const { return data[row * stride]; }
+};
+
+template <typename T>
+Column<T> column(std::span<const T> values)
+{
+    return {values.data(), 1};
+}
+
+// The referenced value must outlive the call
+template <typename T>
+Column<T> broadcast(const T & value)
+{
+    return {&value, 0};
+}
+
+template <typename Due = PaymentDueType>
+struct AnnuityColumns
+{
+    Column<double> rate;
+    Column<uint32_t> periods;
+    Column<double> amount; //!< Payment for pv / fv, present value for pmt
+    Column<double> value; //!< Future value for pv / pmt, present value for fv
+    Column<Due> due;
+};
+
+// The loans of amortization_schedules, one row per loan
+template <typename Due = PaymentDueType>
+struct AmortizationLoans
+{
+    Column<double> rate;
+    Column<double> present_value;
+    Column<double> future_value;
+    Column<Due> due;
+};
+
+// pv<due[i]>(rate[i], periods[i], pmt[i], future_value[i]) for every row i < results.size()
+template <simd::Isa isa = simd::compiled_isa, typename Due = PaymentDueType>
+void pv(
+    Column<double> rate,
+    Column<uint32_t> periods,
+    Column<double> pmt,
+    Column<double> future_value,
+    Column<Due> due,
+    std::span<double> results)
+{
+    const auto columns = AnnuityColumns<Due>{rate, periods, pmt, future_value, due};
+    finfuns::detail::annuity_values<isa, finfuns::detail::AnnuityFunction::PresentValue>(columns, results.size(), results.data());
+}
+
+// fv<due[i]>(rate[i], periods[i], pmt[i], present_value[i]) for every row i < results.size()
+template <simd::Isa isa = simd::compiled_isa, typename Due = PaymentDueType>
+void fv(
+    Column<double> rate,
+    Column<uint32_t> periods,
+    Column<double> pmt,
+    Column<double> present_value,
+    Column<Due> due,
+    std::span<double> results)
+{
+    const auto columns = AnnuityColumns<Due>{rate, periods, pmt, present_value, due};
+    finfuns::detail::annuity_values<isa, finfuns::detail::AnnuityFunction::FutureValue>(columns, results.size(), results.data());
+}
+
+// pmt<due[i]>(rate[i], periods[i], present_value[i], future_value[i]) for every row i < results.size()
+template <simd::Isa isa = simd::compiled_isa, typename Due = PaymentDueType>
+void pmt(
+    Column<double> rate,
+    Column<uint32_t> periods,
+    Column<double> present_value,
+    Column<double> future_value,
+    Column<Due> due,
+    std::span<double> results)
+{
+    const auto columns = AnnuityColumns<Due>{rate, periods, present_value, future_value, due};
+    finfuns::detail::annuity_values<isa, finfuns::detail::AnnuityFunction::Payment>(columns, results.size(), results.data());
+}
+
+// rate<due[i]>(periods[i], pmt[i], present_value[i], future_value[i]) for every row i < results.size().
+// Failed rows get NaN and are reported through on_error(row, AnnuityRateError).
+template <typename Due, typename ErrorSink>
+void rate(
+    Column<uint32_t> periods,
+    Column<double> pmt,
+    Column<double> present_value,
+    Column<double> future_value,
+    Column<Due> due,
+    std::span<double> results,
+    ErrorSink && on_error)
+{
+    for (std::size_t row = 0; row < results.size(); ++row)
+    {
+        expected<double, AnnuityRateError> res = unexpected(AnnuityRateErrorCode::InvalidDueType);
+        switch (finfuns::detail::due_type_code(due[row]))
+        {
+            case finfuns::detail::due_end_code:
+                res = finfuns::rate<PaymentDueType::EndOfPeriod>(periods[row], pmt[row], present_value[row], future_value[row]);
+                break;
+            case finfuns::detail::due_begin_code:
+                res = finfuns::rate<PaymentDueType::BeginningOfPeriod>(periods[row], pmt[row], present_value[row], future_value[row]);
+                break;
+            default:
+                break;
+        }
+        if (res.has_value()) [[likely]]
+        {
+            results[row] = res.value();
+        }
+        else
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, res.error());
+        }
+    }
+}
+
+namespace detail
+{
+
+template <typename Due, typename ErrorSink>
+void amortization_rows(
+    const AmortizationLoans<Due> & loans,
+    std::span<const uint64_t> offsets,
+    RowTask task,
+    const AmortizationSchedule & schedules,
+    std::span<double> payments,
+    ErrorSink & on_error)
+{
+    for (std::size_t row = task.row_begin; row < task.row_end; ++row)
+    {
+        const auto [begin, size] = row_range(offsets, row);
+        const AmortizationSchedule schedule{
+            schedules.interest.subspan(begin, size), schedules.principal.subspan(begin, size), schedules.balance.subspan(begin, size)};
+        const double rate = loans.rate[row];
+        const double present_value = loans.present_value[row];
+        const double future_value = loans.future_value[row];
+
+        expected<double, AmortizationError> res = unexpected(AmortizationError::InvalidDueType);
+        switch (finfuns::detail::due_type_code(loans.due[row]))
+        {
+            case finfuns::detail::due_end_code:
+                res = amortization_schedule<PaymentDueType::EndOfPeriod>(rate, present_value, future_value, schedule);
+                break;
+            case finfuns::detail::due_begin_code:
+                res = amortization_schedule<PaymentDueType::BeginningOfPeriod>(rate, present_value, future_value, schedule);
+                break;
+            default:
+                break;
+        }
+        if (res.has_value()) [[likely]]
+        {
+            payments[row] = res.value();
+        }
+        else
+        {
+            constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+            std::ranges::fill(schedule.interest, nan);
+            std::ranges::fill(schedule.principal, nan);
+            std::ranges::fill(schedule.balance, nan);
+            payments[row] = nan;
+            on_error(row, res.error());
+        }
+    }
+}
+
+}
+
+// Schedule of every loan: loan i fills rows [offsets[i - 1], offsets[i]) of schedules (its number of
+// periods is the row length) and payments[i] gets its payment. Failed loans get NaN in payments and in
+// their rows, and are reported through on_error(row, AmortizationError).
+template <typename Due, typename ErrorSink>
+void amortization_schedules(
+    const AmortizationLoans<Due> & loans,
+    std::span<const uint64_t> offsets,
+    const AmortizationSchedule & schedules,
+    std::span<double> payments,
+    ErrorSink && on_error)
+{
+    detail::amortization_rows(loans, offsets, {0, offsets.size()}, schedules, payments, on_error);
+}
+
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/payment_due_type.hpp>
+#include <finfuns/preprocessor.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Element-wise pv / fv / pmt of annuities for the batch functions (annuity_batch.hpp).
+//
+// (1 + rate)^periods is computed by exponentiation by squaring over the bits of the integer periods:
+// a few multiplies and selects per bit, no pow call. Its rounding error grows like periods * 2^-53,
+// the same order as the one pv / fv already inherit from rounding 1 + rate. Alongside, the same
+// squaring steps carry (1 + rate)^k - 1, starting from the exact rate instead of the rounded 1 + rate,
+// so the annuity factor ((1 + rate)^n - 1) / rate keeps full precision for rates close to 0, where
+// pv() / fv() lose about 2^-53 / rate of it to cancellation.
+//
+// The special cases (rate == 0, rate <= -1, an unknown due type, 0 periods for pmt) are selected after
+// computing every lane the regular way, so a block of mixed rows takes no branch. The scalar and the
+// SIMD kernels do the same operations in the same order, so the Isas agree to the last bit unless the
+// compiler contracts some into FMAs.
+//
+// A Columns type provides rate, periods, amount, value and due, each indexable by row: for pv / fv
+// amount is the payment and value the future / present value, for pmt they are the present and the
+// future value.
+
+namespace finfuns::detail
+{
+
+template <typename Due>
+constexpr int32_t due_type_code(Due due)
+{
+    return static_cast<int32_t>(due);
+}
+
+inline constexpr int32_t due_end_code = static_cast<int32_t>(PaymentDueType::EndOfPeriod);
+inline constexpr int32_t due_begin_code = static_cast<int32_t>(PaymentDueType::BeginningOfPeriod);
+
+enum class AnnuityFunction
+{
+    PresentValue,
+    FutureValue,
+    Payment,
+};
+
+// fn of one row
+template <AnnuityFunction fn, typename Columns>
+inline double annuity_value(const Columns & in, std::size_t i)
+{
+    const double rate = in.rate[i];
+    const uint32_t periods = in.periods[i];
+    const double amount = in.amount[i];
+    const double value = in.value[i];
+    const int32_t due = due_type_code(in.due[i]);
+
+    // power = base^k accumulated, growth = power - 1 and step = base - 1
+    const double base_0 = 1.0 + rate;
+    double power = 1.0;
+    double base = base_0;
+    double growth = 0.0;
+    double step = rate;
+    for (uint32_t e = periods; e != 0; e >>= 1)
+    {
+        const bool bit = (e & 1) != 0;
+        power = bit ? power * base : power;
+        growth = bit ? growth + step + growth * step : growth;
+        base *= base;
+        step *= step + 2.0;
+    }
+
+    const bool zero = rate == 0.0;
+    // growth where power - 1 would cancel; far from 1 power - 1 is exact enough, and growth * factor
+    // could be inf * 0
+    const bool near_one = std::abs(growth) < 0.5;
+    double result;
+    if constexpr (fn == AnnuityFunction::Payment)
+    {
+        // -rate * (pv * (1 + rate)^n + fv) / ((1 + rate)^n - 1), without the large terms that cancel
+        const double payment = -rate * (amount + (amount + value) / (near_one ? growth : power - 1.0));
+        result = due == due_begin_code ? payment / base_0 : payment;
+        result = zero ? -(amount + value) / static_cast<double>(periods) : result;
+    }
+    else
+    {
+        const double divisor = zero ? 1.0 : rate;
+        double factor;
+        double annuity;
+        if constexpr (fn == AnnuityFunction::FutureValue)
+        {
+            factor = power;
+            annuity = -amount * (near_one ? growth : power - 1.0) / divisor;
+        }
+        else
+        {
+            factor = 1.0 / power;
+            annuity = -amount * (near_one ? growth * factor : 1.0 - factor) / divisor;
+        }
+        annuity = due == due_begin_code ? annuity * base_0 : annuity;
+        result = annuity - value * factor;
+        result = zero ? -amount * static_cast<double>(periods) - value : result;
+    }
+    bool invalid = rate <= -1.0 || (due != due_end_code && due != due_begin_code);
+    if constexpr (fn == AnnuityFunction::Payment)
+        invalid = invalid || periods == 0;
+    return invalid ? std::numeric_limits<double>::quiet_NaN() : result;
+}
+
+template <AnnuityFunction fn, typename Columns>
+void annuity_values_serial(const Columns & in, std::size_t n, double * out)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = annuity_value<fn>(in, i);
+}
+
+#ifdef FINFUNS_VECTOR_EXTENSIONS
+
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpsabi"
+
+// annuity_value for U * W rows at a time: U independent vectors of W lanes, so that the multiply
+// chains of the squaring loop of one overlap with the others'. The columns are read lane by lane (any
+// stride, 0 broadcasts); the last block repeats the last row in the lanes past n and stores only the
+// rows that exist.
+template <AnnuityFunction fn, std::size_t W, std::size_t U, typename Columns>
+FINFUNS_ALWAYS_INLINE void annuity_values_kernel(const Columns & in, std::size_t n, double * out)
+{
+    using VD = simd::Vec<double, W>;
+    using VI = simd::Vec<int64_t, W>;
+    constexpr std::size_t block = U * W;
+
+    for (std::size_t i = 0; i < n; i += block)
+    {
+        const std::size_t rows = std::min(block, n - i);
+        VD rate[U];
+        VD amount[U];
+        VD value[U];
+        VI periods[U];
+        VI due[U];
+        uint32_t max_periods = 0;
+        for (std::size_t u = 0; u < U; ++u)
+        {
+            for (std::size_t l = 0; l < W; ++l)
+            {
+                const std::size_t row = i + std::min(u * W + l, rows - 1);
+                const uint32_t p = in.periods[row];
+                rate[u][l] = in.rate[row];
+                amount[u][l] = in.amount[row];
+                value[u][l] = in.value[row];
+                periods[u][l] = p;
+                due[u][l] = due_type_code(in.due[row]);
+                max_periods = std::max(max_periods, p);
+            }
+        }
+
+        const VD one = simd::splat<VD>(1.0);
+        VD power[U];
+        VD base[U];
+        VD growth[U];
+        VD step[U];
+        VI e[U];
+        for (std::size_t u = 0; u < U; ++u)
+        {
+            power[u] = one;
+            base[u] = one + rate[u];
+            growth[u] = simd::splat<VD>(0.0);
+            step[u] = rate[u];
+            e[u] = periods[u];
+        }
+        for (auto bit = std::bit_width(max_periods); bit > 0; --bit)
+        {
+            for (std::size_t u = 0; u < U; ++u)
+            {
+                const VI set = (e[u] & 1) != 0;
+                power[u] = set ? power[u] * base[u] : power[u];
+                growth[u] = set ? growth[u] + step[u] + growth[u] * step[u] : growth[u];
+                base[u] *= base[u];
+                step[u] *= step[u] + 2.0;
+                e[u] >>= 1;
+            }
+        }
+
+        for (std::size_t u = 0; u < U; ++u)
+        {
+            const VI zero = rate[u] == 0.0;
+            const VI near_one = (growth[u] < 0.5) & (growth[u] > -0.5);
+            const VD n_periods = __builtin_convertvector(periods[u], VD);
+            VD result;
+            if constexpr (fn == AnnuityFunction::Payment)
+            {
+                const VD payment = -rate[u] * (amount[u] + (amount[u] + value[u]) / (near_one ? growth[u] : power[u] - one));
+                result = due[u] == due_begin_code ? payment / (one + rate[u]) : payment;
+                result = zero ? -(amount[u] + value[u]) / n_periods : result;
+            }
+            else
+            {
+                const VD divisor = zero ? one : rate[u];
+                VD factor;
+                VD annuity;
+                if constexpr (fn == AnnuityFunction::FutureValue)
+                {
+                    factor = power[u];
+                    annuity = -amount[u] * (near_one ? growth[u] : power[u] - one) / divisor;
+                }
+                else
+                {
+                    factor = one / power[u];
+                    annuity = -amount[u] * (near_one ? growth[u] * factor : one - factor) / divisor;
+                }
+                annuity = due[u] == due_begin_code ? annuity * (one + rate[u]) : annuity;
+                result = annuity - value[u] * factor;
+                result = zero ? -amount[u] * n_periods - value[u] : result;
+            }
+            VI invalid = (rate[u] <= -1.0) | ((due[u] != due_end_code) & (due[u] != due_begin_code));
+            if constexpr (fn == AnnuityFunction::Payment)
+                invalid |= periods[u] == 0;
+            result = invalid ? simd::splat<VD>(std::numeric_limits<double>::quiet_NaN()) : result;
+
+            if (rows == block) [[likely]]
+            {
+                simd::store(out + i + u * W, result);
+            }
+            else
+            {
+                for (std::size_t l = 0; l < W && u * W + l < rows; ++l)
+                    out[i + u * W + l] = result[l];
+            }
+        }
+    }
+}
+
+#    pragma GCC diagnostic pop
+
+#endif
+
+#ifdef FINFUNS_X86_SIMD
+
+template <AnnuityFunction fn, typename Columns>
+FINFUNS_TARGET_AVX2 void annuity_values_avx2(const Columns & in, std::size_t n, double * out)
+{
+    annuity_values_kernel<fn, 4, 4>(in, n, out);
+}
+
+template <AnnuityFunction fn, typename Columns>
+FINFUNS_TARGET_AVX512 void annuity_values_avx512(const Columns & in, std::size_t n, double * out)
+{
+    annuity_values_kernel<fn, 8, 4>(in, n, out);
+}
+
+#endif
+
+template <simd::Isa isa, AnnuityFunction fn, typename Columns>
+FINFUNS_ALWAYS_INLINE void annuity_values(const Columns & in, std::size_t n, double * out)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        annuity_values_avx512<fn>(in, n, out);
+    else if constexpr (isa == simd::Isa::Avx2)
+        annuity_values_avx2<fn>(in, n, out);
+    else
+#endif
+    {
+        static_assert(isa == simd::Isa::Scalar, "Unsupported Isa");
+        annuity_values_serial<fn>(in, n, out);
+    }
+}
+
+}
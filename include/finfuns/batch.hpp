@@ -0,0 +1,303 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/day_count.hpp>
+#include <finfuns/irr.hpp>
+#include <finfuns/mirr.hpp>
+#include <finfuns/npv_calculator.hpp>
+#include <finfuns/rate_solver.hpp>
+#include <finfuns/root_check.hpp>
+#include <finfuns/simd.hpp>
+#include <finfuns/xirr.hpp>
+#include <finfuns/xmirr.hpp>
+#include <finfuns/xnpv_calculator.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Columnar (many series at once) variants of irr/xirr.
+//
+// The series are stored back to back in one flat buffer and delimited by an offsets array
+// in the ClickHouse Array layout: offsets[i] is the end (exclusive) of row i, and row i starts
+// at offsets[i - 1] (or 0 for the first row).
+//
+// Every row gets a value in results: the rate on success, NaN otherwise. Failed rows are also
+// reported through on_error(row, code), where code is either the input validation code
+// (IRRErrorCode / XIRRErrorCode) or SolverErrorCode - so no std::variant is built per row.
+//
+// dates (for xirr) share the layout of values, i.e. dates[j] is the date of values[j].
+//
+// The initial guess is either one value for all rows or per row warm starts (RowGuesses), typically
+// the results of the previous run of a recurring computation.
+//
+// mirr / xmirr take the same layout and one finance and one reinvestment rate for all rows; they are
+// closed form (no solve), so failed rows are reported with their MIRRError / XMIRRError.
+
+namespace finfuns::batch
+{
+
+struct RowRange
+{
+    std::size_t begin;
+    std::size_t size;
+};
+
+inline RowRange row_range(std::span<const uint64_t> offsets, std::size_t row)
+{
+    const auto begin = row == 0 ? uint64_t{0} : offsets[row - 1];
+    return {static_cast<std::size_t>(begin), static_cast<std::size_t>(offsets[row] - begin)};
+}
+
+// Rows [row_begin, row_end) of a batch - the unit of work of the batch executor
+struct RowTask
+{
+    std::size_t row_begin;
+    std::size_t row_end;
+};
+
+// Initial guesses of a batch
+struct RowGuesses
+{
+    // The same guess for every row
+    RowGuesses(double guess) // NOLINT(google-explicit-constructor)
+        : _guess{guess}
+    {
+    }
+
+    // Per row warm starts, one per row - NaN (e.g. a row that failed last time) falls back to guess.
+    // A warm started row also gets a narrow bracket (warm_start_bracket) for the bracketed solve.
+    explicit RowGuesses(std::span<const double> warm_starts, double guess = 0.1)
+        : _guess{guess}
+        , _warm_starts{warm_starts}
+    {
+    }
+
+    // The warm start of the row if there is one, else the common guess
+    double guess_for(std::size_t row) const
+    {
+        const bool warm = !_warm_starts.empty() && std::isfinite(_warm_starts[row]);
+        return warm ? _warm_starts[row] : _guess;
+    }
+
+    double _guess;
+    std::span<const double> _warm_starts;
+};
+
+namespace detail
+{
+
+// structure: the root structure of the row if known (see root_check.hpp) - the bracketed Newton
+// needs no warm start bracket
+template <typename Calculator>
+expected<double, SolverErrorCode>
+solve_row(Calculator && calculator, const RowGuesses & guesses, std::size_t row, std::optional<SingleSignChange> structure)
+{
+    const bool warm = !guesses._warm_starts.empty() && std::isfinite(guesses._warm_starts[row]);
+    const double guess = guesses.guess_for(row);
+    if (structure)
+        return rate_solver(calculator, guess, *structure);
+    if (warm)
+        return rate_solver(calculator, guess, warm_start_bracket(guess));
+    return rate_solver(calculator, guess);
+}
+
+template <simd::Isa isa, typename ErrorSink>
+void irr_rows(
+    std::span<const double> values,
+    std::span<const uint64_t> offsets,
+    RowTask task,
+    const RowGuesses & guesses,
+    std::span<double> results,
+    ErrorSink & on_error)
+{
+    for (std::size_t row = task.row_begin; row < task.row_end; ++row)
+    {
+        const auto [begin, size] = row_range(offsets, row);
+        const auto cashflows = values.subspan(begin, size);
+        if (auto error = validate_irr_cashflows(cashflows)) [[unlikely]]
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, *error);
+            continue;
+        }
+
+        const auto calculator = NpvCalculator(cashflows);
+        const auto structure = irr_root_structure(cashflows, guesses.guess_for(row));
+        auto res = solve_row(IsaCalculator<NpvCalculator<double>, isa>{calculator}, guesses, row, structure);
+        if (res.has_value()) [[likely]]
+        {
+            results[row] = res.value();
+        }
+        else
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, res.error());
+        }
+    }
+}
+
+// times: year fraction scratch shared by all rows - grows to the longest row, so no per row allocation
+template <DayCountConvention day_count, DateUnit unit, simd::Isa isa, typename DateType, typename ErrorSink>
+void xirr_rows(
+    std::span<const double> values,
+    std::span<const DateType> dates,
+    std::span<const uint64_t> offsets,
+    RowTask task,
+    const RowGuesses & guesses,
+    std::span<double> results,
+    ErrorSink & on_error,
+    std::vector<double> & times)
+{
+    for (std::size_t row = task.row_begin; row < task.row_end; ++row)
+    {
+        const auto [begin, size] = row_range(offsets, row);
+        const auto cashflows = values.subspan(begin, size);
+        const auto row_dates = dates.subspan(begin, size);
+        if (auto error = validate_xirr_cashflows(cashflows, row_dates)) [[unlikely]]
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, *error);
+            continue;
+        }
+
+        if (times.size() < size)
+            times.resize(size);
+        using Calculator = XnpvCalculator<DateType, day_count, ExpAccuracy::Full, double, unit>;
+        const auto xnpv = Calculator(cashflows, row_dates, earliest_date(row_dates)).prepare(times);
+        auto res = solve_row(IsaCalculator<decltype(xnpv), isa>{xnpv}, guesses, row, xirr_root_structure(cashflows, xnpv._times));
+        if (res.has_value()) [[likely]]
+        {
+            results[row] = res.value();
+        }
+        else
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, res.error());
+        }
+    }
+}
+
+template <IndexMode index_mode, simd::Isa isa, typename ErrorSink>
+void mirr_rows(
+    std::span<const double> values,
+    std::span<const uint64_t> offsets,
+    RowTask task,
+    double finance_rate,
+    double reinvest_rate,
+    std::span<double> results,
+    ErrorSink & on_error)
+{
+    for (std::size_t row = task.row_begin; row < task.row_end; ++row)
+    {
+        const auto [begin, size] = row_range(offsets, row);
+        auto res = finfuns::mirr<index_mode, isa>(values.subspan(begin, size), finance_rate, reinvest_rate);
+        if (res.has_value()) [[likely]]
+        {
+            results[row] = res.value();
+        }
+        else
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, res.error());
+        }
+    }
+}
+
+template <DayCountConvention day_count, ExpAccuracy accuracy, simd::Isa isa, typename DateType, typename ErrorSink>
+void xmirr_rows(
+    std::span<const double> values,
+    std::span<const DateType> dates,
+    std::span<const uint64_t> offsets,
+    RowTask task,
+    double finance_rate,
+    double reinvest_rate,
+    std::span<double> results,
+    ErrorSink & on_error)
+{
+    for (std::size_t row = task.row_begin; row < task.row_end; ++row)
+    {
+        const auto [begin, size] = row_range(offsets, row);
+        auto res = finfuns::xmirr<day_count, accuracy, isa>(values.subspan(begin, size), dates.subspan(begin, size), finance_rate, reinvest_rate);
+        if (res.has_value()) [[likely]]
+        {
+            results[row] = res.value();
+        }
+        else
+        {
+            results[row] = std::numeric_limits<double>::quiet_NaN();
+            on_error(row, res.error());
+        }
+    }
+}
+
+}
+
+template <simd::Isa isa = simd::compiled_isa, typename ErrorSink>
+void irr(
+    std::span<const double> values, std::span<const uint64_t> offsets, const RowGuesses & guesses, std::span<double> results, ErrorSink && on_error)
+{
+    detail::irr_rows<isa>(values, offsets, RowTask{0, offsets.size()}, guesses, results, on_error);
+}
+
+// unit: the unit of integer dates, see DateUnit
+template <
+    DayCountConvention day_count,
+    DateUnit unit = DateUnit::Days,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateType,
+    typename ErrorSink>
+void xirr(
+    std::span<const double> values,
+    std::span<const DateType> dates,
+    std::span<const uint64_t> offsets,
+    const RowGuesses & guesses,
+    std::span<double> results,
+    ErrorSink && on_error)
+{
+    std::vector<double> times;
+    detail::xirr_rows<day_count, unit, isa>(values, dates, offsets, RowTask{0, offsets.size()}, guesses, results, on_error, times);
+}
+
+template <IndexMode index_mode = IndexMode::ZeroBased, simd::Isa isa = simd::compiled_isa, typename ErrorSink>
+void mirr(
+    std::span<const double> values,
+    std::span<const uint64_t> offsets,
+    double finance_rate,
+    double reinvest_rate,
+    std::span<double> results,
+    ErrorSink && on_error)
+{
+    detail::mirr_rows<index_mode, isa>(values, offsets, RowTask{0, offsets.size()}, finance_rate, reinvest_rate, results, on_error);
+}
+
+template <
+    DayCountConvention day_count,
+    ExpAccuracy accuracy = ExpAccuracy::Full,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateType,
+    typename ErrorSink>
+void xmirr(
+    std::span<const double> values,
+    std::span<const DateType> dates,
+    std::span<const uint64_t> offsets,
+    double finance_rate,
+    double reinvest_rate,
+    std::span<double> results,
+    ErrorSink && on_error)
+{
+    detail::xmirr_rows<day_count, accuracy, isa>(
+        values, dates, offsets, RowTask{0, offsets.size()}, finance_rate, reinvest_rate, results, on_error);
+}
+
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/annuity_batch.hpp>
+#include <finfuns/batch.hpp>
+#include <finfuns/day_count.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Multi-threaded variants of batch::irr / batch::xirr / batch::amortization_schedules.
+//
+// The rows are split into tasks of roughly equal total length (see partition_rows) and every worker
+// starts with a contiguous share of them in its own deque. A worker takes its tasks front to back
+// and, once out of work, steals from the back of the other deques - so a few very long series don't
+// leave the other cores idle.
+//
+// Every row is computed by the same code no matter which worker runs it, hence results are identical
+// for any thread count. on_error may be called concurrently (always for distinct rows).
+
+namespace finfuns::batch
+{
+
+// Splits the rows into at most max_tasks tasks of roughly equal cost, where the cost of a row is its
+// length plus a fixed per row overhead (validation and solver setup). A row longer than the target
+// cost becomes a task of its own.
+inline std::vector<RowTask> partition_rows(std::span<const uint64_t> offsets, std::size_t max_tasks)
+{
+    constexpr uint64_t row_overhead = 16;
+
+    std::vector<RowTask> tasks;
+    const std::size_t n_rows = offsets.size();
+    if (n_rows == 0 || max_tasks == 0)
+        return tasks;
+
+    const uint64_t total_cost = offsets.back() + row_overhead * n_rows;
+    const uint64_t target_cost = std::max<uint64_t>(1, (total_cost + max_tasks - 1) / max_tasks);
+
+    std::size_t task_begin = 0;
+    uint64_t task_cost = 0;
+    for (std::size_t row = 0; row < n_rows; ++row)
+    {
+        task_cost += row_range(offsets, row).size + row_overhead;
+        if (task_cost >= target_cost)
+        {
+            tasks.push_back({task_begin, row + 1});
+            task_begin = row + 1;
+            task_cost = 0;
+        }
+    }
+    if (task_begin < n_rows)
+        tasks.push_back({task_begin, n_rows});
+    return tasks;
+}
+
+namespace detail
+{
+
+// Owner takes from the front, thieves from the back. Tasks are coarse (see partition_rows), so a
+// mutex per deque is not a bottleneck.
+class TaskDeque
+{
+public:
+    void push_back(RowTask task)
+    {
+        std::lock_guard lock(_mutex);
+        _tasks.push_back(task);
+    }
+
+    std::optional<RowTask> pop_front()
+    {
+        std::lock_guard lock(_mutex);
+        if (_tasks.empty())
+            return std::nullopt;
+        const RowTask task = _tasks.front();
+        _tasks.pop_front();
+        return task;
+    }
+
+    std::optional<RowTask> steal_back()
+    {
+        std::lock_guard lock(_mutex);
+        if (_tasks.empty())
+            return std::nullopt;
+        const RowTask task = _tasks.back();
+        _tasks.pop_back();
+        return task;
+    }
+
+private:
+    std::mutex _mutex;
+    std::deque<RowTask> _tasks;
+};
+
+}
+
+class Executor
+{
+public:
+    // Tasks per thread handed out by partition_rows - enough slack for stealing to even out the load
+    static constexpr std::size_t tasks_per_thread = 8;
+
+    // threads == 0 uses std::thread::hardware_concurrency()
+    explicit Executor(unsigned threads = 0)
+        : _threads{threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())}
+    {
+    }
+
+    unsigned threads() const { return _threads; }
+
+    // Calls fn(task, worker) once for every task, worker is in [0, min(threads(), tasks.size())).
+    // The calling thread is worker 0; the call returns when all the tasks are done. If fewer threads
+    // can be started than requested, the ones running take over the work of the others (built
+    // without exceptions, failing to start a thread terminates instead).
+    template <typename TaskFn>
+    void run(std::span<const RowTask> tasks, TaskFn && fn) const
+    {
+        const auto n_workers = static_cast<unsigned>(std::min<std::size_t>(_threads, tasks.size()));
+        if (n_workers <= 1)
+        {
+            for (const auto & task : tasks)
+                fn(task, 0u);
+            return;
+        }
+
+        std::vector<detail::TaskDeque> deques(n_workers);
+        for (std::size_t i = 0; i < tasks.size(); ++i)
+            deques[i * n_workers / tasks.size()].push_back(tasks[i]);
+
+        auto worker = [&deques, &fn, n_workers](unsigned id)
+        {
+            while (auto task = deques[id].pop_front())
+                fn(*task, id);
+            // No tasks are added while running, so once every deque is empty we are done
+            for (unsigned k = 1; k < n_workers; ++k)
+            {
+                auto & victim = deques[(id + k) % n_workers];
+                while (auto task = victim.steal_back())
+                    fn(*task, id);
+            }
+        };
+
+        {
+            std::vector<std::jthread> pool;
+            pool.reserve(n_workers - 1);
+#if defined(__cpp_exceptions)
+            try
+            {
+                for (unsigned id = 1; id < n_workers; ++id)
+                    pool.emplace_back(worker, id);
+            }
+            catch (const std::system_error &)
+            {
+                // Out of threads (resource limits): the started workers and this thread steal the
+                // tasks of the missing ones
+            }
+#else
+            // Without exceptions a thread that cannot be started terminates the process
+            for (unsigned id = 1; id < n_workers; ++id)
+                pool.emplace_back(worker, id);
+#endif
+            worker(0);
+        }
+    }
+
+    // Partitions the offset delimited rows and runs fn(task, worker) for every task
+    template <typename TaskFn>
+    void for_each_task(std::span<const uint64_t> offsets, TaskFn && fn) const
+    {
+        const auto tasks = partition_rows(offsets, std::size_t{_threads} * tasks_per_thread);
+        run(tasks, fn);
+    }
+
+private:
+    unsigned _threads;
+};
+
+template <simd::Isa isa = simd::compiled_isa, typename ErrorSink>
+void irr(
+    const Executor & executor,
+    std::span<const double> values,
+    std::span<const uint64_t> offsets,
+    const RowGuesses & guesses,
+    std::span<double> results,
+    ErrorSink && on_error)
+{
+    executor.for_each_task(
+        offsets, [&](RowTask task, unsigned) { detail::irr_rows<isa>(values, offsets, task, guesses, results, on_error); });
+}
+
+template <
+    DayCountConvention day_count,
+    DateUnit unit = DateUnit::Days,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateType,
+    typename ErrorSink>
+void xirr(
+    const Executor & executor,
+    std::span<const double> values,
+    std::span<const DateType> dates,
+    std::span<const uint64_t> offsets,
+    const RowGuesses & guesses,
+    std::span<double> results,
+    ErrorSink && on_error)
+{
+    // Year fraction scratch per worker: there are no more workers than tasks, nor tasks than rows
+    std::vector<std::vector<double>> times(std::min<std::size_t>(executor.threads(), offsets.size()));
+    executor.for_each_task(
+        offsets,
+        [&](RowTask task, unsigned worker)
+        { detail::xirr_rows<day_count, unit, isa>(values, dates, offsets, task, guesses, results, on_error, times[worker]); });
+}
+
+template <typename Due, typename ErrorSink>
+void amortization_schedules(
+    const Executor & executor,
+    const AmortizationLoans<Due> & loans,
+    std::span<const uint64_t> offsets,
+    const AmortizationSchedule & schedules,
+    std::span<double> payments,
+    ErrorSink && on_error)
+{
+    executor.for_each_task(
+        offsets, [&](RowTask task, unsigned) { detail::amortization_rows(loans, offsets, task, schedules, payments, on_error); });
+}
+
+}
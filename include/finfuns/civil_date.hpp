@@ -0,0 +1,153 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/preprocessor.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Day number (days since 1970-01-01) <-> proleptic Gregorian calendar date, for the calendar day count
+// conventions.
+//
+// civil_from_days / days_from_civil are the branch free era arithmetic of H. Hinnant's
+// chrono-compatible low-level date algorithms: integer ops only, divisions by constants. The year
+// fraction loops go through tables instead: the day number of every 1 January of 1900 .. 2299 finds
+// the year with one multiply and two compares, and a day of year -> month / day table the rest, so
+// a date costs a few loads. Dates outside the table years fall back to the arithmetic.
+
+namespace finfuns
+{
+
+struct CivilDate
+{
+    int32_t year;
+    uint32_t month; //!< 1 .. 12
+    uint32_t day; //!< 1 .. 31
+};
+
+constexpr bool is_leap_year(int64_t year)
+{
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+constexpr int64_t days_from_civil(int64_t year, uint32_t month, uint32_t day)
+{
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yoe = static_cast<uint32_t>(year - era * 400);
+    const uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+constexpr CivilDate civil_from_days(int64_t days)
+{
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<uint32_t>(days - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    const uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+    const uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    return {static_cast<int32_t>(static_cast<int64_t>(yoe) + era * 400 + (month <= 2)), month, day};
+}
+
+namespace detail
+{
+
+inline constexpr int32_t year_table_first = 1900;
+inline constexpr std::size_t year_table_years = 400;
+
+// Day number of 1 January of year_table_first + i, one more year at the end for the lengths
+inline constexpr auto year_starts = []
+{
+    std::array<int32_t, year_table_years + 1> starts{};
+    for (std::size_t i = 0; i < starts.size(); ++i)
+        starts[i] = static_cast<int32_t>(days_from_civil(year_table_first + static_cast<int64_t>(i), 1, 1));
+    return starts;
+}();
+
+// Month << 8 | day of every day of year (0 based), common years then leap years
+inline constexpr auto month_days = []
+{
+    std::array<uint16_t, 2 * 366> table{};
+    for (uint32_t leap = 0; leap < 2; ++leap)
+    {
+        const int64_t year = leap != 0 ? 2000 : 2001;
+        const int64_t start = days_from_civil(year, 1, 1);
+        for (uint32_t doy = 0; doy < 365 + leap; ++doy)
+        {
+            const CivilDate date = civil_from_days(start + doy);
+            table[leap * 366 + doy] = static_cast<uint16_t>(date.month << 8 | date.day);
+        }
+    }
+    return table;
+}();
+
+}
+
+// The year a day number falls in, with the day number of its 1 January and its length in days
+struct CivilYear
+{
+    int32_t year;
+    int64_t start;
+    int64_t length;
+};
+
+namespace detail
+{
+
+// Outside the table years, kept out of line so the table path stays small in the year fraction loops
+FINFUNS_NOINLINE constexpr CivilYear civil_year_arithmetic(int64_t days)
+{
+    const int32_t year = civil_from_days(days).year;
+    return {year, days_from_civil(year, 1, 1), is_leap_year(year) ? 366 : 365};
+}
+
+}
+
+constexpr CivilYear civil_year(int64_t days)
+{
+    using detail::year_starts;
+    const int64_t offset = days - year_starts.front();
+    if (offset >= 0 && days < year_starts.back()) [[likely]]
+    {
+        // The mean Gregorian year gives the year or a neighbour
+        auto i = static_cast<std::size_t>(static_cast<uint32_t>(offset) * 400U / 146097U);
+        i -= static_cast<std::size_t>(days < year_starts[i]);
+        i += static_cast<std::size_t>(days >= year_starts[i + 1]);
+        return {detail::year_table_first + static_cast<int32_t>(i), year_starts[i], year_starts[i + 1] - year_starts[i]};
+    }
+    return detail::civil_year_arithmetic(days);
+}
+
+// Month << 8 | day of a day number in year
+constexpr uint32_t month_day(const CivilYear & year, int64_t days)
+{
+    const auto leap = static_cast<std::size_t>(year.length - 365);
+    return detail::month_days[leap * 366 + static_cast<std::size_t>(days - year.start)];
+}
+
+// 28 February of a common year, 29 February of a leap year (day of year 58 + leap)
+constexpr bool is_last_of_february(const CivilYear & year, int64_t days)
+{
+    return days - year.start == year.length - 307;
+}
+
+// civil_from_days through the tables
+constexpr CivilDate civil_date(int64_t days)
+{
+    const CivilYear year = civil_year(days);
+    const uint32_t md = month_day(year, days);
+    return {year.year, md >> 8, md & 0xff};
+}
+
+}
@@ -7,7 +7,11 @@
 //  1.0. (See accompanying file LICENSE_1_0.txt or copy at
 //  http://www.boost.org/LICENSE_1_0.txt)
 
+#include <finfuns/civil_date.hpp>
+
+#include <algorithm>
 #include <chrono>
+#include <concepts>
 #include <cstdint>
 #include <string_view>
 
@@ -23,6 +27,11 @@ enum class DayCountConvention : int32_t
 {
     ACT_365F,
     ACT_365_25,
+    ACT_360,
+    ACT_365L, //!< Actual days / 366 if the later date's year is a leap year, else / 365
+    ACT_ACT_ISDA, //!< Days in each calendar year / the length of that year
+    THIRTY_360_US, //!< 30/360 US (SIA), with the end of February rules
+    THIRTY_E_360, //!< 30E/360 (Eurobond basis)
 };
 
 constexpr std::string_view day_count_to_string(DayCountConvention dcc)
@@ -33,32 +42,189 @@ constexpr std::string_view day_count_to_string(DayCountConvention dcc)
             return "ACT/365F";
         case DayCountConvention::ACT_365_25:
             return "ACT/365.25";
+        case DayCountConvention::ACT_360:
+            return "ACT/360";
+        case DayCountConvention::ACT_365L:
+            return "ACT/365L";
+        case DayCountConvention::ACT_ACT_ISDA:
+            return "ACT/ACT ISDA";
+        case DayCountConvention::THIRTY_360_US:
+            return "30/360 US";
+        case DayCountConvention::THIRTY_E_360:
+            return "30E/360";
         default:
             return "Unknown";
     }
 }
 
+// Unit of an integer date: the count of units since 1970-01-01 (or any fixed epoch). The ClickHouse
+// column encodings are Date (uint16 days), Date32 (int32 days), DateTime (uint32 seconds) and
+// DateTime64 (int64 ticks of 10^-precision seconds, precision 0, 3, 6 or 9 here).
+enum class DateUnit : int32_t
+{
+    Days,
+    Seconds,
+    Milliseconds,
+    Microseconds,
+    Nanoseconds,
+};
+
+constexpr int64_t units_per_day(DateUnit unit)
+{
+    switch (unit)
+    {
+        case DateUnit::Days:
+            return 1;
+        case DateUnit::Seconds:
+            return 86'400;
+        case DateUnit::Milliseconds:
+            return 86'400'000;
+        case DateUnit::Microseconds:
+            return 86'400'000'000;
+        case DateUnit::Nanoseconds:
+            return 86'400'000'000'000;
+    }
+    return 1;
+}
 
-template <ChronoDayType D>
+// The day of an integer date, rounded down for the time of day, so that a date time counts the
+// calendar days like the date it falls on. The divisor is a compile time constant: a multiply and a
+// shift, no division.
+template <DateUnit unit, std::integral D>
+constexpr int64_t day_number(D date)
+{
+    const auto value = static_cast<int64_t>(date);
+    if constexpr (unit == DateUnit::Days)
+        return value;
+    else
+    {
+        constexpr int64_t per_day = units_per_day(unit);
+        const int64_t quotient = value / per_day;
+        return quotient - (value % per_day < 0 ? 1 : 0);
+    }
+}
+
+template <DateUnit unit = DateUnit::Days, ChronoDayType D>
+constexpr int64_t day_number(D date)
+{
+    static_assert(unit == DateUnit::Days, "std::chrono dates carry their own unit");
+    return std::chrono::days(date.time_since_epoch()).count();
+}
+
+template <DateUnit unit = DateUnit::Days, ChronoDayType D>
 constexpr auto days_between_act(D d1, D d2)
 {
+    static_assert(unit == DateUnit::Days, "std::chrono dates carry their own unit");
     return (d2 - d1).count();
 }
 
-constexpr int days_between_act(int d1, int d2)
+template <DateUnit unit = DateUnit::Days, std::integral D>
+constexpr int64_t days_between_act(D d1, D d2)
 {
-    return d2 - d1;
+    return day_number<unit>(d2) - day_number<unit>(d1);
 }
 
-template <DayCountConvention dcc, typename D>
+// Year fractions from a fixed base date, for the loops over the dates of a cashflow series: the
+// calendar conventions resolve the base date once, leaving the table lookups of one date per call.
+//
+// ACT/ACT ISDA is the sum over the calendar years between the dates of the days in the year / the
+// length of the year: the difference of the years plus the fractions of them the dates have run.
+// 30/360 counts every month as 30 days after the day adjustments of the convention.
+template <DayCountConvention dcc, DateUnit unit, typename D>
+class YearFractionFrom
+{
+public:
+    static constexpr bool is_thirty_360 = dcc == DayCountConvention::THIRTY_360_US || dcc == DayCountConvention::THIRTY_E_360;
+
+    constexpr explicit YearFractionFrom(D base)
+        : _base{base}
+    {
+        if constexpr (dcc == DayCountConvention::ACT_365L)
+            _day = day_number<unit>(base);
+        else if constexpr (dcc == DayCountConvention::ACT_ACT_ISDA)
+        {
+            _day = day_number<unit>(base);
+            const CivilYear year = civil_year(_day);
+            _year = year.year;
+            _fraction = static_cast<double>(_day - year.start) / static_cast<double>(year.length);
+        }
+        else if constexpr (is_thirty_360)
+        {
+            _day = day_number<unit>(base);
+            const CivilYear year = civil_year(_day);
+            const uint32_t md = month_day(year, _day);
+            int64_t day = md & 0xff;
+            if constexpr (dcc == DayCountConvention::THIRTY_360_US)
+            {
+                _last_of_february = is_last_of_february(year, _day);
+                day = _last_of_february ? 30 : day;
+            }
+            _thirty_day = day == 31 ? 30 : day;
+            _thirty_days = 360 * int64_t{year.year} + 30 * static_cast<int64_t>(md >> 8) + _thirty_day;
+        }
+        else
+            static_assert(
+                dcc == DayCountConvention::ACT_365F || dcc == DayCountConvention::ACT_365_25 || dcc == DayCountConvention::ACT_360,
+                "Unsupported DayCountConvention");
+    }
+
+    // Year fraction from the base date to date (negative if date is earlier)
+    constexpr double operator()(D date) const
+    {
+        if constexpr (dcc == DayCountConvention::ACT_365F)
+            return static_cast<double>(days_between_act<unit>(_base, date)) / 365.0;
+        else if constexpr (dcc == DayCountConvention::ACT_365_25)
+            return static_cast<double>(days_between_act<unit>(_base, date)) / 365.25;
+        else if constexpr (dcc == DayCountConvention::ACT_360)
+            return static_cast<double>(days_between_act<unit>(_base, date)) / 360.0;
+        else if constexpr (dcc == DayCountConvention::ACT_365L)
+        {
+            // The denominator is the length of the later date's year, also when date is the earlier one
+            const int64_t day = day_number<unit>(date);
+            return static_cast<double>(day - _day) / static_cast<double>(civil_year(std::max(day, _day)).length);
+        }
+        else if constexpr (dcc == DayCountConvention::ACT_ACT_ISDA)
+        {
+            const int64_t day = day_number<unit>(date);
+            const CivilYear year = civil_year(day);
+            return static_cast<double>(year.year - _year) + static_cast<double>(day - year.start) / static_cast<double>(year.length)
+                - _fraction;
+        }
+        else
+        {
+            const int64_t day = day_number<unit>(date);
+            const CivilYear year = civil_year(day);
+            const uint32_t md = month_day(year, day);
+            int64_t thirty_day = md & 0xff;
+            if constexpr (dcc == DayCountConvention::THIRTY_360_US)
+            {
+                // Both on the last day of February, then 31 only if the base date is on the 30th or 31st
+                thirty_day = _last_of_february && is_last_of_february(year, day) ? 30 : thirty_day;
+                thirty_day = thirty_day == 31 && _thirty_day >= 30 ? 30 : thirty_day;
+            }
+            else
+                thirty_day = thirty_day == 31 ? 30 : thirty_day;
+            const int64_t days = 360 * int64_t{year.year} + 30 * static_cast<int64_t>(md >> 8) + thirty_day - _thirty_days;
+            return static_cast<double>(days) / 360.0;
+        }
+    }
+
+private:
+    D _base;
+    int64_t _day = 0;
+    int32_t _year = 0;
+    double _fraction = 0.0;
+    bool _last_of_february = false;
+    int64_t _thirty_day = 0;
+    int64_t _thirty_days = 0;
+};
+
+// Year fraction from d1 to d2 (negative if d2 is earlier). The calendar conventions (ACT/365L,
+// ACT/ACT ISDA, 30/360) read the dates' years / months / days through the tables of civil_date.hpp.
+template <DayCountConvention dcc, DateUnit unit = DateUnit::Days, typename D>
 constexpr double year_fraction(D d1, D d2)
 {
-    if constexpr (dcc == DayCountConvention::ACT_365F)
-        return static_cast<double>(days_between_act(d1, d2)) / 365.0;
-    else if constexpr (dcc == DayCountConvention::ACT_365_25)
-        return static_cast<double>(days_between_act(d1, d2)) / 365.25;
-    else
-        []<bool flag = false>() { static_assert(flag, "Unsupported DayCountConvention"); }();
+    return YearFractionFrom<dcc, unit, D>(d1)(d2);
 }
 
 }
@@ -0,0 +1,323 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/preprocessor.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace finfuns
+{
+
+enum class ExpAccuracy : int32_t
+{
+    Full, //!< Full double precision (within ~1 ulp of std::exp)
+    Screening, //!< ~1e-12 relative error, for fast screening runs
+};
+
+}
+
+namespace finfuns::detail
+{
+
+// 1/k!, the Taylor coefficients of exp
+inline constexpr std::array<double, 14> exp_taylor_coefficients = []
+{
+    std::array<double, 14> c{};
+    c[0] = 1.0;
+    for (std::size_t k = 1; k < c.size(); ++k)
+        c[k] = c[k - 1] / static_cast<double>(k);
+    return c;
+}();
+
+template <ExpAccuracy accuracy>
+inline constexpr std::size_t exp_polynomial_degree = accuracy == ExpAccuracy::Full ? 13 : 10;
+
+#ifdef FINFUNS_VECTOR_EXTENSIONS
+
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpsabi"
+
+// Lane-wise exp(x) for W doubles.
+//
+// x = k*ln2 + r with |r| <= ln2/2 (Cody-Waite split of ln2), exp(r) from a Taylor polynomial
+// (degree 13: <= 1 ulp, degree 10: ~3e-13 relative) and the 2^k scaling applied in two halves,
+// so overflow to inf, underflow to subnormals/0, inf and NaN all behave like std::exp.
+//
+// Computed in place: vectors are never passed or returned by value, so the kernel can be instantiated
+// from a template entry point (i.e. at the end of the translation unit) without -Wpsabi notes.
+template <ExpAccuracy accuracy, std::size_t W>
+FINFUNS_ALWAYS_INLINE void exp_kernel(simd::Vec<double, W> & x)
+{
+    using V = simd::Vec<double, W>;
+    using I = simd::Vec<int64_t, W>;
+    using U = simd::Vec<uint64_t, W>;
+
+    x = x < simd::splat<V>(-746.0) ? simd::splat<V>(-746.0) : x;
+    x = x > simd::splat<V>(710.0) ? simd::splat<V>(710.0) : x;
+
+    // Adding 1.5 * 2^52 rounds x/ln2 to an integer, which then sits in the low mantissa bits
+    const V shifter = simd::splat<V>(0x1.8p52);
+    const V t = x * simd::splat<V>(0x1.71547652b82fep0) + shifter;
+    const V k = t - shifter;
+    // ln2_hi has trailing zero bits, so k * ln2_hi is exact even without FMA
+    V r = x - k * simd::splat<V>(0x1.62e42feep-1);
+    r = r - k * simd::splat<V>(0x1.a39ef35793c76p-33);
+
+    constexpr std::size_t degree = exp_polynomial_degree<accuracy>;
+    V p = simd::splat<V>(exp_taylor_coefficients[degree]);
+    for (std::size_t i = degree; i-- > 0;)
+        p = p * r + simd::splat<V>(exp_taylor_coefficients[i]);
+
+    // 2^k = 2^k1 * 2^k2, both halves are normal doubles for every k the clamped x can produce.
+    // __builtin_bit_cast rather than std::bit_cast, which is an ordinary call at -O0 and would pass
+    // wide vectors across a target boundary
+    const I ki = __builtin_bit_cast(I, t) - __builtin_bit_cast(I, shifter);
+    const I k1 = __builtin_convertvector(__builtin_convertvector(ki + simd::splat<I>(int64_t{2048}), U) >> 1, I)
+        - simd::splat<I>(int64_t{1024});
+    const I k2 = ki - k1;
+    const V scale1 = __builtin_bit_cast(V, (k1 + simd::splat<I>(int64_t{1023})) << 52);
+    const V scale2 = __builtin_bit_cast(V, (k2 + simd::splat<I>(int64_t{1023})) << 52);
+    x = p * scale1 * scale2;
+}
+
+// Lane-wise exp(x) for W floats, the same scheme in single precision: degree 7 Taylor polynomial
+// (~1 ulp, for either accuracy) and the 2^k scaling in two halves, |k| <= 150.
+template <ExpAccuracy accuracy, std::size_t W>
+FINFUNS_ALWAYS_INLINE void exp_kernel(simd::Vec<float, W> & x)
+{
+    using V = simd::Vec<float, W>;
+    using I = simd::Vec<int32_t, W>;
+
+    x = x < simd::splat<V>(-104.0f) ? simd::splat<V>(-104.0f) : x;
+    x = x > simd::splat<V>(89.0f) ? simd::splat<V>(89.0f) : x;
+
+    const V shifter = simd::splat<V>(0x1.8p23f);
+    const V t = x * simd::splat<V>(0x1.715476p0f) + shifter;
+    const V k = t - shifter;
+    V r = x - k * simd::splat<V>(0x1.62e4p-1f);
+    r = r - k * simd::splat<V>(0x1.7f7d1cp-20f);
+
+    V p = simd::splat<V>(static_cast<float>(exp_taylor_coefficients[7]));
+    for (std::size_t i = 7; i-- > 0;)
+        p = p * r + simd::splat<V>(static_cast<float>(exp_taylor_coefficients[i]));
+
+    const I ki = __builtin_bit_cast(I, t) - __builtin_bit_cast(I, shifter);
+    const I k1 = ki >> 1;
+    const I k2 = ki - k1;
+    const V scale1 = __builtin_bit_cast(V, (k1 + simd::splat<I>(int32_t{127})) << 23);
+    const V scale2 = __builtin_bit_cast(V, (k2 + simd::splat<I>(int32_t{127})) << 23);
+    x = p * scale1 * scale2;
+}
+
+// Computes {sum(cf[i] * (1+r)^-t[i]), sum(t[i] * cf[i] * (1+r)^-t[i])} given log1pr = log(1+r)
+// (the second sum only if with_derivative)
+template <typename T, ExpAccuracy accuracy, std::size_t W, bool with_derivative>
+FINFUNS_ALWAYS_INLINE std::pair<T, T> exp_discounted_sums_kernel(const T * cf, const T * t, std::size_t n, T log1pr)
+{
+    using V = simd::Vec<T, W>;
+
+    const V minus_log1pr = simd::splat<V>(-log1pr);
+    V s0 = simd::splat<V>(T{0});
+    V s1 = s0;
+    V d0 = s0;
+    V d1 = s0;
+
+    std::size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W)
+    {
+        const V t0 = simd::load<V>(t + i);
+        const V t1 = simd::load<V>(t + i + W);
+        V e0 = t0 * minus_log1pr;
+        V e1 = t1 * minus_log1pr;
+        exp_kernel<accuracy, W>(e0);
+        exp_kernel<accuracy, W>(e1);
+        const V term0 = simd::load<V>(cf + i) * e0;
+        const V term1 = simd::load<V>(cf + i + W) * e1;
+        s0 += term0;
+        s1 += term1;
+        if constexpr (with_derivative)
+        {
+            d0 += t0 * term0;
+            d1 += t1 * term1;
+        }
+    }
+
+    // Tail: zero padded, so every element goes through the same exp
+    for (; i < n; i += W)
+    {
+        alignas(sizeof(V)) T cf_tail[W] = {};
+        alignas(sizeof(V)) T t_tail[W] = {};
+        for (std::size_t l = 0; l < W && i + l < n; ++l)
+        {
+            cf_tail[l] = cf[i + l];
+            t_tail[l] = t[i + l];
+        }
+        const V t0 = simd::load<V>(t_tail);
+        V e0 = t0 * minus_log1pr;
+        exp_kernel<accuracy, W>(e0);
+        const V term0 = simd::load<V>(cf_tail) * e0;
+        s0 += term0;
+        if constexpr (with_derivative)
+            d0 += t0 * term0;
+    }
+
+    return {simd::reduce_add<T>(s0 + s1), simd::reduce_add<T>(d0 + d1)};
+}
+
+// Rate profile step over one block: acc[j] += sum(cf[i] * exp(t[i] * minus_log1pr[j])) for i = 0..n-1.
+// Each lane holds one rate, so the block (cashflows and year fractions) is streamed once for all rates.
+template <ExpAccuracy accuracy, std::size_t W>
+FINFUNS_ALWAYS_INLINE void
+exp_profile_kernel(const double * cf, const double * t, std::size_t n, const double * minus_log1pr, double * acc, std::size_t n_rates)
+{
+    using V = simd::Vec<double, W>;
+
+    for (std::size_t j = 0; j < n_rates; j += W)
+    {
+        // Rates tail: zero padded, the padded lanes are computed and dropped
+        alignas(sizeof(V)) double m_lanes[W] = {};
+        alignas(sizeof(V)) double acc_lanes[W] = {};
+        const std::size_t lanes = std::min(W, n_rates - j);
+        for (std::size_t l = 0; l < lanes; ++l)
+        {
+            m_lanes[l] = minus_log1pr[j + l];
+            acc_lanes[l] = acc[j + l];
+        }
+
+        const V m = simd::load<V>(m_lanes);
+        V a0 = simd::load<V>(acc_lanes);
+        V a1 = simd::splat<V>(0.0);
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            V e0 = simd::splat<V>(t[i]) * m;
+            V e1 = simd::splat<V>(t[i + 1]) * m;
+            exp_kernel<accuracy, W>(e0);
+            exp_kernel<accuracy, W>(e1);
+            a0 += simd::splat<V>(cf[i]) * e0;
+            a1 += simd::splat<V>(cf[i + 1]) * e1;
+        }
+        if (i < n)
+        {
+            V e0 = simd::splat<V>(t[i]) * m;
+            exp_kernel<accuracy, W>(e0);
+            a0 += simd::splat<V>(cf[i]) * e0;
+        }
+
+        simd::store(acc_lanes, a0 + a1);
+        for (std::size_t l = 0; l < lanes; ++l)
+            acc[j + l] = acc_lanes[l];
+    }
+}
+
+#    pragma GCC diagnostic pop
+
+#endif
+
+#ifdef FINFUNS_X86_SIMD
+
+template <ExpAccuracy accuracy, bool with_derivative>
+FINFUNS_TARGET_AVX2 inline std::pair<double, double>
+exp_discounted_sums_avx2(const double * cf, const double * t, std::size_t n, double log1pr)
+{
+    return exp_discounted_sums_kernel<double, accuracy, 4, with_derivative>(cf, t, n, log1pr);
+}
+
+template <ExpAccuracy accuracy, bool with_derivative>
+FINFUNS_TARGET_AVX512 inline std::pair<double, double>
+exp_discounted_sums_avx512(const double * cf, const double * t, std::size_t n, double log1pr)
+{
+    return exp_discounted_sums_kernel<double, accuracy, 8, with_derivative>(cf, t, n, log1pr);
+}
+
+template <ExpAccuracy accuracy, bool with_derivative>
+FINFUNS_TARGET_AVX2 inline std::pair<float, float> exp_discounted_sums_avx2(const float * cf, const float * t, std::size_t n, float log1pr)
+{
+    return exp_discounted_sums_kernel<float, accuracy, 8, with_derivative>(cf, t, n, log1pr);
+}
+
+template <ExpAccuracy accuracy, bool with_derivative>
+FINFUNS_TARGET_AVX512 inline std::pair<float, float>
+exp_discounted_sums_avx512(const float * cf, const float * t, std::size_t n, float log1pr)
+{
+    return exp_discounted_sums_kernel<float, accuracy, 16, with_derivative>(cf, t, n, log1pr);
+}
+
+template <ExpAccuracy accuracy>
+FINFUNS_TARGET_AVX2 inline void
+exp_profile_avx2(const double * cf, const double * t, std::size_t n, const double * minus_log1pr, double * acc, std::size_t n_rates)
+{
+    exp_profile_kernel<accuracy, 4>(cf, t, n, minus_log1pr, acc, n_rates);
+}
+
+template <ExpAccuracy accuracy>
+FINFUNS_TARGET_AVX512 inline void
+exp_profile_avx512(const double * cf, const double * t, std::size_t n, const double * minus_log1pr, double * acc, std::size_t n_rates)
+{
+    exp_profile_kernel<accuracy, 8>(cf, t, n, minus_log1pr, acc, n_rates);
+}
+
+#endif
+
+// The scalar kernel set always uses std::exp, regardless of the requested accuracy
+template <simd::Isa isa, ExpAccuracy accuracy, bool with_derivative, typename T>
+FINFUNS_ALWAYS_INLINE std::pair<T, T> exp_discounted_sums(const T * cf, const T * t, std::size_t n, T log1pr)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        return exp_discounted_sums_avx512<accuracy, with_derivative>(cf, t, n, log1pr);
+    else if constexpr (isa == simd::Isa::Avx2)
+        return exp_discounted_sums_avx2<accuracy, with_derivative>(cf, t, n, log1pr);
+    else
+#endif
+    {
+        static_assert(isa == simd::Isa::Scalar, "Unsupported Isa");
+        T sum = 0;
+        T weighted = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const T term = cf[i] * std::exp(-t[i] * log1pr);
+            sum += term;
+            if constexpr (with_derivative)
+                weighted += t[i] * term;
+        }
+        return {sum, weighted};
+    }
+}
+
+template <simd::Isa isa, ExpAccuracy accuracy>
+FINFUNS_ALWAYS_INLINE void
+exp_profile(const double * cf, const double * t, std::size_t n, const double * minus_log1pr, double * acc, std::size_t n_rates)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        exp_profile_avx512<accuracy>(cf, t, n, minus_log1pr, acc, n_rates);
+    else if constexpr (isa == simd::Isa::Avx2)
+        exp_profile_avx2<accuracy>(cf, t, n, minus_log1pr, acc, n_rates);
+    else
+#endif
+    {
+        static_assert(isa == simd::Isa::Scalar, "Unsupported Isa");
+        for (std::size_t j = 0; j < n_rates; ++j)
+        {
+            double sum = acc[j];
+            for (std::size_t i = 0; i < n; ++i)
+                sum += cf[i] * std::exp(t[i] * minus_log1pr[j]);
+            acc[j] = sum;
+        }
+    }
+}
+
+}
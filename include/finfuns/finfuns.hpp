@@ -7,9 +7,22 @@
 //  1.0. (See accompanying file LICENSE_1_0.txt or copy at
 //  http://www.boost.org/LICENSE_1_0.txt)
 
+#include <finfuns/amortization.hpp>
+#include <finfuns/annuity_batch.hpp>
+#include <finfuns/batch.hpp>
+#include <finfuns/batch_executor.hpp>
 #include <finfuns/fv.hpp>
+#include <finfuns/ipmt.hpp>
 #include <finfuns/irr.hpp>
+#include <finfuns/irr_state.hpp>
+#include <finfuns/mirr.hpp>
+#include <finfuns/nper.hpp>
 #include <finfuns/npv.hpp>
+#include <finfuns/pmt.hpp>
 #include <finfuns/pv.hpp>
+#include <finfuns/rate.hpp>
+#include <finfuns/rolling.hpp>
 #include <finfuns/xirr.hpp>
+#include <finfuns/xirr_state.hpp>
+#include <finfuns/xmirr.hpp>
 #include <finfuns/xnpv.hpp>
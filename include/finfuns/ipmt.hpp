@@ -0,0 +1,75 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/payment_due_type.hpp>
+#include <finfuns/pmt.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace finfuns
+{
+
+namespace detail
+{
+
+// Balance of the loan of pmt<due_type>(rate, periods, present_value, future_value) at the end of period
+// k, in the sign of present_value: -fv<due_type>(rate, k, pmt(), present_value), the same for both due
+// types (with payments at the beginning of the period it includes the interest accrued since payment
+// k). Written as present_value less the share ((1 + rate)^k - 1) / ((1 + rate)^periods - 1) of
+// present_value + future_value, it has none of the large terms that cancel in the fv() form when
+// (1 + rate)^periods is large.
+inline double loan_balance(double rate, uint32_t k, uint32_t periods, double present_value, double future_value)
+{
+    double repaid;
+    if (rate == 0.)
+    {
+        repaid = static_cast<double>(k) / periods;
+    }
+    else
+    {
+        const double log_base = std::log1p(rate);
+        const double growth = compound_growth(rate, periods);
+        repaid = std::isfinite(growth) ? compound_growth(rate, k) / growth
+                                       : std::exp((static_cast<double>(k) - static_cast<double>(periods)) * log_base);
+    }
+    return present_value - (present_value + future_value) * repaid;
+}
+
+}
+
+// Interest part of payment per (1 .. periods) of pmt<due_type>(rate, periods, present_value, future_value).
+// The payment per has to pay the interest accrued since the previous one, so for payments at the
+// beginning of the period the first has none. NaN for rate <= -1 or per out of range.
+template <PaymentDueType due_type>
+inline double ipmt(double rate, uint32_t per, uint32_t periods, double present_value, double future_value = 0.0)
+{
+    if (!(rate > -1.0) || per < 1 || per > periods) [[unlikely]]
+        return std::numeric_limits<double>::quiet_NaN();
+
+    const double balance = detail::loan_balance(rate, per - 1, periods, present_value, future_value);
+    if constexpr (due_type == PaymentDueType::EndOfPeriod)
+        return -rate * balance;
+    else if constexpr (due_type == PaymentDueType::BeginningOfPeriod)
+        // Interest accrued since payment per - 1, on the balance right after it
+        return per == 1 ? 0.0 : -rate * balance / (1.0 + rate);
+    else
+        []<bool flag = false>() { static_assert(flag, "Unsupported PaymentDueType"); }();
+}
+
+// Principal part of payment per: pmt() - ipmt()
+template <PaymentDueType due_type>
+inline double ppmt(double rate, uint32_t per, uint32_t periods, double present_value, double future_value = 0.0)
+{
+    return pmt<due_type>(rate, periods, present_value, future_value)
+        - ipmt<due_type>(rate, per, periods, present_value, future_value);
+}
+
+}
@@ -10,8 +10,17 @@
 #include <finfuns/expected.hpp>
 #include <finfuns/npv_calculator.hpp>
 #include <finfuns/rate_solver.hpp>
+#include <finfuns/root_check.hpp>
+#include <finfuns/simd.hpp>
+#include <finfuns/small_buffer.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <variant>
 
@@ -26,6 +35,14 @@ enum class IRRErrorCode : int32_t
 
 using IRRError = std::variant<IRRErrorCode, SolverErrorCode>;
 
+// How irr() evaluates the NPV polynomial in each solver iteration
+enum class NpvEvaluation : int32_t
+{
+    Discounting, //!< NpvCalculator: forward pass with growing discount factors (SIMD kernels when available)
+    Horner, //!< HornerNpvCalculator: reverse Horner pass in v = 1/(1+r), no per cashflow division
+    MixedPrecision, //!< Newton on NpvCalculator<float> (twice the SIMD lanes), then refined by Discounting
+};
+
 constexpr std::string_view error_to_sv(IRRErrorCode error)
 {
     switch (error)
@@ -44,10 +61,11 @@ constexpr std::string_view error_to_sv(const IRRError & error)
     return std::visit([](const auto & e) { return error_to_sv(e); }, error);
 }
 
-inline expected<double, IRRError> irr(std::span<const double> cashflows, std::optional<double> guess)
+// Input checks shared by irr() and the batch kernels
+inline std::optional<IRRErrorCode> validate_irr_cashflows(std::span<const double> cashflows)
 {
     if (cashflows.size() <= 1) [[unlikely]]
-        return unexpected(IRRErrorCode::NotEnoughCashflows);
+        return IRRErrorCode::NotEnoughCashflows;
 
     bool has_positive = false;
     bool has_negative = false;
@@ -62,12 +80,69 @@ inline expected<double, IRRError> irr(std::span<const double> cashflows, std::op
             break;
     }
     if (not(has_negative && has_positive)) [[unlikely]]
-        return unexpected(IRRErrorCode::SameSignCashflows);
+        return IRRErrorCode::SameSignCashflows;
+    return std::nullopt;
+}
 
-    const double guess_value = guess.value_or(0.1);
-    auto npv = NpvCalculator(cashflows);
+namespace detail
+{
+
+// Root of the cashflows converted to float, to start the double solve of irr<MixedPrecision> from.
+// The cashflows are scaled by a power of 2 (exact, the roots don't change) so that the largest one
+// is ~1 and neither it nor the discounted sums overflow in float.
+template <simd::Isa isa = simd::compiled_isa>
+std::optional<double> mixed_precision_start(
+    std::span<const double> cashflows, double guess, const std::optional<SingleSignChange> & structure, int32_t & iterations)
+{
+    // max(|cf|) on the bit patterns - an integer max vectorizes, a floating point one does not
+    int64_t largest_bits = 0;
+    for (const double cf : cashflows)
+        largest_bits = std::max(largest_bits, std::bit_cast<int64_t>(cf) & std::numeric_limits<int64_t>::max());
+    const double largest = std::bit_cast<double>(largest_bits);
+    if (!std::isfinite(largest)) [[unlikely]]
+        return std::nullopt;
 
-    auto res = rate_solver(std::move(npv), guess_value);
+    const double scale = std::ldexp(1.0, -std::ilogb(largest));
+    auto cashflows_f = SmallBuffer<float, 512>(cashflows.size());
+    for (size_t i = 0; i < cashflows.size(); ++i)
+        cashflows_f.data()[i] = static_cast<float>(cashflows[i] * scale);
+    const auto calculator = NpvCalculator(std::span<const float>(cashflows_f.span()));
+    return low_precision_root(IsaCalculator<NpvCalculator<float>, isa>{calculator}, guess, structure, iterations);
+}
+
+}
+
+// stats (optional) receives the solver diagnostics, see SolverStats.
+//
+// NpvEvaluation::MixedPrecision only moves the starting point: the double solve (with its accuracy
+// and fallbacks) always runs, from the float root to ~1e-6 - typically two Newton steps. isa selects
+// the SIMD kernels of the Discounting / MixedPrecision evaluations (Horner is scalar).
+template <NpvEvaluation evaluation = NpvEvaluation::Discounting, simd::Isa isa = simd::compiled_isa>
+expected<double, IRRError> irr(std::span<const double> cashflows, std::optional<double> guess, SolverStats * stats = nullptr)
+{
+    if (auto error = validate_irr_cashflows(cashflows)) [[unlikely]]
+        return unexpected(*error);
+
+    double guess_value = guess.value_or(0.1);
+    // A provably unique root goes straight to the bracketed Newton, see root_check.hpp
+    const auto structure = irr_root_structure(cashflows, guess_value);
+    int32_t low_precision_iterations = 0;
+    if constexpr (evaluation == NpvEvaluation::MixedPrecision)
+        guess_value = detail::mixed_precision_start<isa>(cashflows, guess_value, structure, low_precision_iterations).value_or(guess_value);
+    auto solve = [&](auto && calculator)
+    { return structure ? rate_solver(calculator, guess_value, *structure, stats) : rate_solver(calculator, guess_value, stats); };
+    auto res = [&]
+    {
+        if constexpr (evaluation == NpvEvaluation::Horner)
+            return solve(HornerNpvCalculator(cashflows));
+        else
+        {
+            const auto calculator = NpvCalculator(cashflows);
+            return solve(IsaCalculator<NpvCalculator<double>, isa>{calculator});
+        }
+    }();
+    if (stats != nullptr)
+        stats->low_precision_iterations = low_precision_iterations;
     if (res.has_value()) [[likely]]
         return res.value();
     return unexpected(res.error());
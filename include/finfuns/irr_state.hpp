@@ -0,0 +1,268 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/expected.hpp>
+#include <finfuns/irr.hpp>
+#include <finfuns/npv_calculator.hpp>
+#include <finfuns/rate_solver.hpp>
+#include <finfuns/root_check.hpp>
+#include <finfuns/serialization.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace finfuns
+{
+
+namespace detail
+{
+
+struct IrrChunk
+{
+    uint64_t offset; //!< Period index of values[0]
+    std::vector<double> values;
+
+    uint64_t end() const { return offset + values.size(); }
+};
+
+// NPV of cashflows given as chunks at period offsets: sum over chunks of v^offset * NPV(chunk),
+// each chunk evaluated by NpvCalculator. Gaps between chunks are zero cashflows, overlapping
+// periods add up. The chunks are ordered by offset and the offsets are taken relative to the first
+// one: the IRR does not depend on a common shift, and the discount of a large absolute offset (a
+// row number) would underflow.
+struct OffsetChunksNpvCalculator
+{
+    std::span<const IrrChunk> _chunks;
+
+    double calculate(double rate) const
+    {
+        if (rate <= -1.0) [[unlikely]]
+            return std::numeric_limits<double>::infinity();
+        double npv = 0.0;
+        for (const auto & chunk : _chunks)
+            npv += discount(rate, relative_offset(chunk)) * NpvCalculator(chunk.values).calculate(rate);
+        return npv;
+    }
+
+    std::pair<double, double> calculate_with_derivative(double rate) const
+    {
+        if (rate <= -1.0) [[unlikely]]
+            return {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+        // d/dr (1+r)^-o * npv(r) = (1+r)^-o * (npv'(r) - o * npv(r) / (1+r))
+        double npv = 0.0;
+        double derivative = 0.0;
+        for (const auto & chunk : _chunks)
+        {
+            const uint64_t offset = relative_offset(chunk);
+            const double d = discount(rate, offset);
+            const auto [chunk_npv, chunk_derivative] = NpvCalculator(chunk.values).calculate_with_derivative(rate);
+            npv += d * chunk_npv;
+            derivative += d * (chunk_derivative - static_cast<double>(offset) * chunk_npv / (1.0 + rate));
+        }
+        return {npv, derivative};
+    }
+
+    uint64_t relative_offset(const IrrChunk & chunk) const { return chunk.offset - _chunks.front().offset; }
+
+    static double discount(double rate, uint64_t offset)
+    {
+        return offset == 0 ? 1.0 : std::pow(1.0 + rate, -static_cast<double>(offset));
+    }
+};
+
+}
+
+// Streaming, mergeable IRR input - the state of an IRR aggregate function.
+//
+// Cashflows are added one by one; the period index of every value is explicit: the state starts at
+// a given offset (e.g. the row number where a data part begins) and add() takes the next period.
+// Partial states built in parallel are combined with merge() in any order - the values are kept in
+// chunks tagged with their offsets and merge() only appends chunks; they are ordered by offset (and
+// adjacent ones joined) once, at finalize() / serialize().
+// Periods not covered by any chunk are zero cashflows, periods covered more than once add up.
+class IrrState
+{
+public:
+    static constexpr uint8_t serialization_version = 1;
+
+    explicit IrrState(uint64_t offset = 0)
+        : _next{offset}
+    {
+    }
+
+    // Adds the cashflow of the next period
+    void add(double value)
+    {
+        if (_chunks.empty() || _chunks.back().end() != _next)
+            _chunks.push_back({_next, {}});
+        _chunks.back().values.push_back(value);
+        ++_next;
+    }
+
+    // Takes over the cashflows of other; the period of the next add() does not change
+    void merge(const IrrState & other)
+    {
+        if (&other == this) [[unlikely]]
+            return merge(IrrState(other));
+        for (const auto & chunk : other._chunks)
+        {
+            if (!_chunks.empty() && _chunks.back().end() == chunk.offset)
+                _chunks.back().values.insert(_chunks.back().values.end(), chunk.values.begin(), chunk.values.end());
+            else
+                _chunks.push_back(chunk);
+        }
+    }
+
+    // Number of cashflows added (to this state and the merged ones)
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (const auto & chunk : _chunks)
+            n += chunk.values.size();
+        return n;
+    }
+
+    // Format (version 1): u8 version, varint next period, varint chunk count,
+    // then per chunk: varint offset, varint value count, the values as doubles.
+    // Chunks are written coalesced (see finalize), so equal states serialize to equal bytes.
+    void serialize(std::vector<std::byte> & out) const
+    {
+        const auto runs = coalesced();
+
+        auto writer = BinaryWriter(out);
+        writer.write_u8(serialization_version);
+        writer.write_varint(_next);
+        writer.write_varint(runs.size());
+        for (const auto & run : runs)
+        {
+            writer.write_varint(run.offset);
+            writer.write_varint(run.values.size());
+            for (const double value : run.values)
+                writer.write_double(value);
+        }
+    }
+
+    static expected<IrrState, SerializationError> deserialize(std::span<const std::byte> in)
+    {
+        auto reader = BinaryReader(in);
+        auto version = reader.read_u8();
+        if (!version.has_value()) [[unlikely]]
+            return unexpected(version.error());
+        if (*version != serialization_version) [[unlikely]]
+            return unexpected(SerializationError::UnsupportedVersion);
+
+        auto next = reader.read_varint();
+        if (!next.has_value()) [[unlikely]]
+            return unexpected(next.error());
+        auto n_chunks = reader.read_varint();
+        if (!n_chunks.has_value()) [[unlikely]]
+            return unexpected(n_chunks.error());
+
+        IrrState state(*next);
+        for (uint64_t c = 0; c < *n_chunks; ++c)
+        {
+            auto offset = reader.read_varint();
+            if (!offset.has_value()) [[unlikely]]
+                return unexpected(offset.error());
+            auto count = reader.read_varint();
+            if (!count.has_value()) [[unlikely]]
+                return unexpected(count.error());
+            if (*count > reader.remaining() / sizeof(double)) [[unlikely]]
+                return unexpected(SerializationError::UnexpectedEnd);
+
+            detail::IrrChunk chunk{*offset, {}};
+            chunk.values.reserve(static_cast<std::size_t>(*count));
+            for (uint64_t i = 0; i < *count; ++i)
+                chunk.values.push_back(*reader.read_double());
+            state._chunks.push_back(std::move(chunk));
+        }
+        if (reader.remaining() != 0) [[unlikely]]
+            return unexpected(SerializationError::InvalidData);
+        return state;
+    }
+
+    // IRR of the cashflows collected so far
+    expected<double, IRRError> finalize(std::optional<double> guess) const
+    {
+        // Evaluated on the coalesced chunks, so the result does not depend on the merge order
+        const auto runs = _chunks.size() == 1 ? std::vector<detail::IrrChunk>{} : coalesced();
+        const auto chunks = _chunks.size() == 1 ? std::span(_chunks) : std::span(runs);
+        if (auto error = validate(chunks)) [[unlikely]]
+            return unexpected(*error);
+
+        const double guess_value = guess.value_or(0.1);
+        // A single chunk (the common case) is exactly irr() of its values
+        auto res = [&]
+        {
+            if (chunks.size() != 1)
+                return rate_solver(detail::OffsetChunksNpvCalculator{chunks}, guess_value);
+            if (const auto structure = irr_root_structure(chunks[0].values, guess_value))
+                return rate_solver(NpvCalculator(chunks[0].values), guess_value, *structure);
+            return rate_solver(NpvCalculator(chunks[0].values), guess_value);
+        }();
+        if (res.has_value()) [[likely]]
+            return res.value();
+        return unexpected(res.error());
+    }
+
+private:
+    // The chunks ordered by offset, adjacent ones joined and empty ones dropped
+    std::vector<detail::IrrChunk> coalesced() const
+    {
+        std::vector<const detail::IrrChunk *> ordered;
+        ordered.reserve(_chunks.size());
+        for (const auto & chunk : _chunks)
+            if (!chunk.values.empty())
+                ordered.push_back(&chunk);
+        std::ranges::stable_sort(ordered, {}, [](const detail::IrrChunk * chunk) { return chunk->offset; });
+
+        std::vector<detail::IrrChunk> runs;
+        for (const auto * chunk : ordered)
+        {
+            if (!runs.empty() && runs.back().end() == chunk->offset)
+                runs.back().values.insert(runs.back().values.end(), chunk->values.begin(), chunk->values.end());
+            else
+                runs.push_back(*chunk);
+        }
+        return runs;
+    }
+
+    static std::optional<IRRErrorCode> validate(std::span<const detail::IrrChunk> chunks)
+    {
+        std::size_t n = 0;
+        bool has_positive = false;
+        bool has_negative = false;
+        for (const auto & chunk : chunks)
+        {
+            n += chunk.values.size();
+            for (const double cf : chunk.values)
+            {
+                has_positive |= cf > 0;
+                has_negative |= cf < 0;
+            }
+        }
+        if (n <= 1) [[unlikely]]
+            return IRRErrorCode::NotEnoughCashflows;
+        if (not(has_negative && has_positive)) [[unlikely]]
+            return IRRErrorCode::SameSignCashflows;
+        return std::nullopt;
+    }
+
+    std::vector<detail::IrrChunk> _chunks;
+    uint64_t _next;
+};
+
+}
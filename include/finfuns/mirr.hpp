@@ -0,0 +1,196 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/expected.hpp>
+#include <finfuns/mirr_kernels.hpp>
+#include <finfuns/npv_calculator.hpp>
+#include <finfuns/preprocessor.hpp>
+#include <finfuns/simd.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+
+// MIRR: the rate at which the negative cashflows, discounted at the finance rate to the start, grow
+// into the positive ones compounded at the reinvestment rate to the horizon,
+// (FV(positive, reinvest_rate) / -PV(negative, finance_rate))^(1 / horizon) - 1.
+//
+// Both sums come from one pass over the cashflows (see mirr_kernels.hpp) and the result is closed
+// form: no root solve. FV(positive) is (1 + reinvest_rate)^horizon times the PV of the positive
+// cashflows, so the power is taken in log space together with the final root. A sum whose first
+// cashflow comes late in a long series is discounted to that cashflow and moved to period 0 in log
+// space as well, so that it stays in the double range.
+
+namespace finfuns
+{
+
+enum class MIRRError : int32_t
+{
+    NotEnoughCashflows, //!< At least two cashflows are required
+    SameSignCashflows, //!< All cashflows have the same sign (all positive or all negative)
+    InvalidRate, //!< finance or reinvestment rate is NaN/infinity or <= -1
+};
+
+constexpr std::string_view error_to_sv(MIRRError error)
+{
+    switch (error)
+    {
+        case MIRRError::NotEnoughCashflows:
+            return "Not enough cashflows: at least two are required";
+        case MIRRError::SameSignCashflows:
+            return "All cashflows have the same sign (all positive or all negative)";
+        case MIRRError::InvalidRate:
+            return "Invalid rate: NaN, infinity or not greater than -1";
+        default:
+            return "Unknown MIRR error";
+    }
+}
+
+namespace detail
+{
+
+inline bool valid_mirr_rate(double rate)
+{
+    return std::isfinite(rate) && rate > -1.0;
+}
+
+inline bool has_both_signs(std::span<const double> cashflows)
+{
+    bool has_positive = false;
+    bool has_negative = false;
+    for (double cf : cashflows)
+    {
+        if (cf > 0)
+            has_positive = true;
+        if (cf < 0)
+            has_negative = true;
+        if (has_positive && has_negative)
+            return true;
+    }
+    return false;
+}
+
+// The MIRR from the logs of the sums of the cashflows discounted to the start - log(-negative) at
+// the finance rate, log(positive) at the reinvestment rate - with the terminal value at horizon and
+// log_reinvest = log(1 + reinvest_rate)
+inline double mirr_from_log_sums(double log_negative, double log_positive, double horizon, double log_reinvest)
+{
+    return std::expm1(log_reinvest + (log_positive - log_negative) / horizon);
+}
+
+inline double mirr_from_sums(double negative, double positive, double horizon, double log_reinvest)
+{
+    return mirr_from_log_sums(std::log(-negative), std::log(positive), horizon, log_reinvest);
+}
+
+// log(-negative), log(positive) of the split sums with each sum discounted to its own first cashflow:
+// [first, second) holds cashflows of the sign of cashflows[first] only, from second on that sum
+// continues at v^(second - first) and the other one starts at 1
+template <simd::Isa isa>
+FINFUNS_NOINLINE std::pair<double, double> split_log_sums_from_first(
+    std::span<const double> cashflows, std::size_t first_negative, std::size_t first_positive, double finance_discount, double reinvest_discount)
+{
+    const bool negative_first = first_negative < first_positive;
+    const std::size_t first = negative_first ? first_negative : first_positive;
+    const std::size_t second = negative_first ? first_positive : first_negative;
+    const auto [lead_negative, lead_positive]
+        = split_discounted_sums<isa>(cashflows.data() + first, second - first, finance_discount, reinvest_discount);
+    const double carried = std::pow(negative_first ? finance_discount : reinvest_discount, static_cast<double>(second - first));
+    const auto [negative, positive] = split_discounted_sums<isa>(
+        cashflows.data() + second,
+        cashflows.size() - second,
+        finance_discount,
+        reinvest_discount,
+        negative_first ? carried : 1.0,
+        negative_first ? 1.0 : carried);
+    return {std::log(-(lead_negative + negative)), std::log(lead_positive + positive)};
+}
+
+// Whether the power chains of mirr can start at period 0: the first cashflow of either sign comes early
+// enough that its discount factor stays far from discount_flush_threshold (and from overflow for
+// negative rates)
+inline bool mirr_sums_from_start(std::size_t first_negative, std::size_t first_positive, double finance_discount, double reinvest_discount)
+{
+    constexpr std::size_t max_first = 64;
+    const auto moderate = [](double v) { return v > 0x1p-8 && v < 0x1p8; };
+    return first_negative < max_first && first_positive < max_first && moderate(finance_discount) && moderate(reinvest_discount);
+}
+
+// Indices of the first negative and the first positive cashflow, reading up to the later of the two
+// (cashflows has both signs)
+inline std::pair<std::size_t, std::size_t> first_of_each_sign(std::span<const double> cashflows)
+{
+    const std::size_t n = cashflows.size();
+    std::size_t negative = n;
+    std::size_t positive = n;
+    for (std::size_t i = 0; i < n && (negative == n || positive == n); ++i)
+    {
+        if (cashflows[i] < 0 && negative == n)
+            negative = i;
+        if (cashflows[i] > 0 && positive == n)
+            positive = i;
+    }
+    return {negative, positive};
+}
+
+}
+
+// Input checks shared by mirr() and the batch kernels
+inline std::optional<MIRRError> validate_mirr_cashflows(std::span<const double> cashflows, double finance_rate, double reinvest_rate)
+{
+    if (!detail::valid_mirr_rate(finance_rate) || !detail::valid_mirr_rate(reinvest_rate)) [[unlikely]]
+        return MIRRError::InvalidRate;
+    if (cashflows.size() <= 1) [[unlikely]]
+        return MIRRError::NotEnoughCashflows;
+    if (!detail::has_both_signs(cashflows)) [[unlikely]]
+        return MIRRError::SameSignCashflows;
+    return std::nullopt;
+}
+
+// index_mode follows npv(): ZeroBased puts cashflows[i] at period i and the horizon at n - 1 (Excel
+// MIRR), OneBased at period i + 1 with the horizon at n
+template <IndexMode index_mode = IndexMode::ZeroBased, simd::Isa isa = simd::compiled_isa>
+expected<double, MIRRError> mirr(std::span<const double> cashflows, double finance_rate, double reinvest_rate)
+{
+    if (auto error = validate_mirr_cashflows(cashflows, finance_rate, reinvest_rate)) [[unlikely]]
+        return unexpected(*error);
+
+    const double finance_discount = 1.0 / (1.0 + finance_rate);
+    const double reinvest_discount = 1.0 / (1.0 + reinvest_rate);
+    const double log_reinvest = std::log1p(reinvest_rate);
+    constexpr std::size_t period_shift = index_mode == IndexMode::ZeroBased ? 0 : 1;
+    const double horizon = static_cast<double>(cashflows.size() - 1 + period_shift);
+
+    const auto [first_negative, first_positive] = detail::first_of_each_sign(cashflows);
+    if (detail::mirr_sums_from_start(first_negative, first_positive, finance_discount, reinvest_discount)) [[likely]]
+    {
+        const auto [negative, positive]
+            = detail::split_discounted_sums<isa>(cashflows.data(), cashflows.size(), finance_discount, reinvest_discount);
+        if constexpr (index_mode == IndexMode::ZeroBased)
+            return detail::mirr_from_sums(negative, positive, horizon, log_reinvest);
+        else
+            return detail::mirr_from_sums(negative * finance_discount, positive * reinvest_discount, horizon, log_reinvest);
+    }
+
+    // Rare: a sum whose first cashflow comes late, discounted to that cashflow and moved to period 0 in
+    // log space
+    const auto [log_negative, log_positive]
+        = detail::split_log_sums_from_first<isa>(cashflows, first_negative, first_positive, finance_discount, reinvest_discount);
+    return detail::mirr_from_log_sums(
+        log_negative - static_cast<double>(first_negative + period_shift) * std::log1p(finance_rate),
+        log_positive - static_cast<double>(first_positive + period_shift) * log_reinvest,
+        horizon,
+        log_reinvest);
+}
+
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/exp_kernels.hpp>
+#include <finfuns/npv_kernels.hpp>
+#include <finfuns/preprocessor.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// The two sums of MIRR / XMIRR in one pass over the cashflows: the negative cashflows discounted at
+// the finance rate and the positive ones at the reinvestment rate, {sum(min(cf[i], 0) * vn^t[i]),
+// sum(max(cf[i], 0) * vp^t[i])}. Every cashflow is read once and, in the dated kernel, goes through one
+// exp with the log rate of its sign selected per lane.
+
+namespace finfuns::detail
+{
+
+// t[i] = i: vn, vp = 1 / (1 + rate), cf[0] weighted by pn, pp (the powers carried over from the
+// cashflows before cf), powers below discount_flush_threshold flushed to 0 like discounted_profile_serial
+// does
+inline std::pair<double, double> split_discounted_sums_serial(const double * cf, std::size_t n, double vn, double vp, double pn, double pp)
+{
+    double negative = 0.0;
+    double positive = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const double c = cf[i];
+        negative += c < 0.0 ? c * pn : 0.0;
+        positive += c > 0.0 ? c * pp : 0.0;
+        pn *= vn;
+        pp *= vp;
+        pn = pn < profile_flush_threshold ? 0.0 : pn;
+        pp = pp < profile_flush_threshold ? 0.0 : pp;
+    }
+    return {negative, positive};
+}
+
+// The sums over t[i] = year fractions, given the logs of 1 + rate
+inline std::pair<double, double>
+split_exp_discounted_sums_serial(const double * cf, const double * t, std::size_t n, double log_negative, double log_positive)
+{
+    double negative = 0.0;
+    double positive = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const double c = cf[i];
+        const double term = c * std::exp(-t[i] * (c < 0.0 ? log_negative : log_positive));
+        negative += c < 0.0 ? term : 0.0;
+        positive += c < 0.0 ? 0.0 : term;
+    }
+    return {negative, positive};
+}
+
+#ifdef FINFUNS_VECTOR_EXTENSIONS
+
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpsabi"
+
+// split_discounted_sums_serial with the power chains of discounted_sums_kernel: lane l of the two W wide
+// vectors of each rate starts at p * v^l and p * v^(W+l), and all advance by v^(2W) per step
+template <std::size_t W>
+FINFUNS_ALWAYS_INLINE std::pair<double, double>
+split_discounted_sums_kernel(const double * cf, std::size_t n, double vn, double vp, double pn, double pp)
+{
+    using V = simd::Vec<double, W>;
+
+    const V threshold = simd::splat<V>(discount_flush_threshold<double>);
+    const V zero = simd::splat<V>(0.0);
+
+    V pn0;
+    V pp0;
+    double pwn = 1.0;
+    double pwp = 1.0;
+    for (std::size_t l = 0; l < W; ++l)
+    {
+        pn0[l] = pn * pwn;
+        pp0[l] = pp * pwp;
+        pwn *= vn;
+        pwp *= vp;
+    }
+    V pn1 = pn0 * simd::splat<V>(pwn);
+    V pp1 = pp0 * simd::splat<V>(pwp);
+    const V step_n = simd::splat<V>(pwn * pwn);
+    const V step_p = simd::splat<V>(pwp * pwp);
+
+    V n0 = zero;
+    V n1 = zero;
+    V s0 = zero;
+    V s1 = zero;
+
+    const std::size_t flush_interval = std::min(discount_flush_interval(pwn * pwn), discount_flush_interval(pwp * pwp));
+    std::size_t i = 0;
+    std::size_t steps = 0;
+    for (; i + 2 * W <= n; i += 2 * W)
+    {
+        const V c0 = simd::load<V>(cf + i);
+        const V c1 = simd::load<V>(cf + i + W);
+        n0 += (c0 < 0.0 ? c0 : zero) * pn0;
+        n1 += (c1 < 0.0 ? c1 : zero) * pn1;
+        s0 += (c0 > 0.0 ? c0 : zero) * pp0;
+        s1 += (c1 > 0.0 ? c1 : zero) * pp1;
+        pn0 *= step_n;
+        pn1 *= step_n;
+        pp0 *= step_p;
+        pp1 *= step_p;
+        if (++steps == flush_interval) [[unlikely]]
+        {
+            pn0 = pn0 < threshold ? zero : pn0;
+            pn1 = pn1 < threshold ? zero : pn1;
+            pp0 = pp0 < threshold ? zero : pp0;
+            pp1 = pp1 < threshold ? zero : pp1;
+            steps = 0;
+        }
+    }
+
+    double negative = simd::reduce_add<double>(n0 + n1);
+    double positive = simd::reduce_add<double>(s0 + s1);
+
+    // Tail: lane 0 holds the powers of i
+    double dn = pn0[0];
+    double dp = pp0[0];
+    for (; i < n; ++i)
+    {
+        const double c = cf[i];
+        negative += c < 0.0 ? c * dn : 0.0;
+        positive += c > 0.0 ? c * dp : 0.0;
+        dn *= vn;
+        dp *= vp;
+    }
+    return {negative, positive};
+}
+
+// One vector of cashflows c at year fractions time into the negative / positive sums
+template <ExpAccuracy accuracy, std::size_t W>
+FINFUNS_ALWAYS_INLINE void split_exp_accumulate(
+    const simd::Vec<double, W> & c,
+    const simd::Vec<double, W> & time,
+    const simd::Vec<double, W> & minus_log_negative,
+    const simd::Vec<double, W> & minus_log_positive,
+    simd::Vec<double, W> & negative,
+    simd::Vec<double, W> & positive)
+{
+    using V = simd::Vec<double, W>;
+    const V zero = simd::splat<V>(0.0);
+    const auto is_negative = c < 0.0;
+    V e = time * (is_negative ? minus_log_negative : minus_log_positive);
+    exp_kernel<accuracy, W>(e);
+    const V term = c * e;
+    negative += is_negative ? term : zero;
+    positive += is_negative ? zero : term;
+}
+
+// split_exp_discounted_sums_serial through exp_kernel, 2 * W cashflows per step
+template <ExpAccuracy accuracy, std::size_t W>
+FINFUNS_ALWAYS_INLINE std::pair<double, double>
+split_exp_discounted_sums_kernel(const double * cf, const double * t, std::size_t n, double log_negative, double log_positive)
+{
+    using V = simd::Vec<double, W>;
+
+    const V minus_log_negative = simd::splat<V>(-log_negative);
+    const V minus_log_positive = simd::splat<V>(-log_positive);
+    const V zero = simd::splat<V>(0.0);
+    V n0 = zero;
+    V n1 = zero;
+    V s0 = zero;
+    V s1 = zero;
+
+    std::size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W)
+    {
+        split_exp_accumulate<accuracy, W>(simd::load<V>(cf + i), simd::load<V>(t + i), minus_log_negative, minus_log_positive, n0, s0);
+        split_exp_accumulate<accuracy, W>(simd::load<V>(cf + i + W), simd::load<V>(t + i + W), minus_log_negative, minus_log_positive, n1, s1);
+    }
+
+    // Tail: zero padded, so every element goes through the same exp
+    for (; i < n; i += W)
+    {
+        alignas(sizeof(V)) double cf_tail[W] = {};
+        alignas(sizeof(V)) double t_tail[W] = {};
+        for (std::size_t l = 0; l < W && i + l < n; ++l)
+        {
+            cf_tail[l] = cf[i + l];
+            t_tail[l] = t[i + l];
+        }
+        split_exp_accumulate<accuracy, W>(simd::load<V>(cf_tail), simd::load<V>(t_tail), minus_log_negative, minus_log_positive, n0, s0);
+    }
+
+    return {simd::reduce_add<double>(n0 + n1), simd::reduce_add<double>(s0 + s1)};
+}
+
+#    pragma GCC diagnostic pop
+
+#endif
+
+#ifdef FINFUNS_X86_SIMD
+
+FINFUNS_TARGET_AVX2 inline std::pair<double, double>
+split_discounted_sums_avx2(const double * cf, std::size_t n, double vn, double vp, double pn, double pp)
+{
+    return split_discounted_sums_kernel<4>(cf, n, vn, vp, pn, pp);
+}
+
+FINFUNS_TARGET_AVX512 inline std::pair<double, double>
+split_discounted_sums_avx512(const double * cf, std::size_t n, double vn, double vp, double pn, double pp)
+{
+    return split_discounted_sums_kernel<8>(cf, n, vn, vp, pn, pp);
+}
+
+template <ExpAccuracy accuracy>
+FINFUNS_TARGET_AVX2 inline std::pair<double, double>
+split_exp_discounted_sums_avx2(const double * cf, const double * t, std::size_t n, double log_negative, double log_positive)
+{
+    return split_exp_discounted_sums_kernel<accuracy, 4>(cf, t, n, log_negative, log_positive);
+}
+
+template <ExpAccuracy accuracy>
+FINFUNS_TARGET_AVX512 inline std::pair<double, double>
+split_exp_discounted_sums_avx512(const double * cf, const double * t, std::size_t n, double log_negative, double log_positive)
+{
+    return split_exp_discounted_sums_kernel<accuracy, 8>(cf, t, n, log_negative, log_positive);
+}
+
+#endif
+
+template <simd::Isa isa>
+FINFUNS_ALWAYS_INLINE std::pair<double, double>
+split_discounted_sums(const double * cf, std::size_t n, double vn, double vp, double pn = 1.0, double pp = 1.0)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        return split_discounted_sums_avx512(cf, n, vn, vp, pn, pp);
+    else if constexpr (isa == simd::Isa::Avx2)
+        return split_discounted_sums_avx2(cf, n, vn, vp, pn, pp);
+    else
+#endif
+    {
+        static_assert(isa == simd::Isa::Scalar, "Unsupported Isa");
+        return split_discounted_sums_serial(cf, n, vn, vp, pn, pp);
+    }
+}
+
+// The scalar kernel set always uses std::exp, regardless of the requested accuracy
+template <simd::Isa isa, ExpAccuracy accuracy>
+FINFUNS_ALWAYS_INLINE std::pair<double, double>
+split_exp_discounted_sums(const double * cf, const double * t, std::size_t n, double log_negative, double log_positive)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        return split_exp_discounted_sums_avx512<accuracy>(cf, t, n, log_negative, log_positive);
+    else if constexpr (isa == simd::Isa::Avx2)
+        return split_exp_discounted_sums_avx2<accuracy>(cf, t, n, log_negative, log_positive);
+    else
+#endif
+    {
+        static_assert(isa == simd::Isa::Scalar, "Unsupported Isa");
+        return split_exp_discounted_sums_serial(cf, t, n, log_negative, log_positive);
+    }
+}
+
+}
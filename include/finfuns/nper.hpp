@@ -0,0 +1,51 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/payment_due_type.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace finfuns
+{
+
+// Number of periods (generally fractional) after which payments of pmt turn present_value into
+// future_value, same sign convention as pv / fv. NaN if there is no such number: rate <= -1, pmt == 0
+// at rate 0, or payments that never reach future_value.
+template <PaymentDueType due_type>
+inline double nper(double rate, double pmt, double present_value, double future_value = 0.0)
+{
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    if (rate <= -1.0) [[unlikely]]
+        return nan;
+
+    double periods;
+    if (rate == 0.)
+    {
+        periods = -(present_value + future_value) / pmt;
+    }
+    else
+    {
+        double due_pmt;
+        if constexpr (due_type == PaymentDueType::EndOfPeriod)
+            due_pmt = pmt;
+        else if constexpr (due_type == PaymentDueType::BeginningOfPeriod)
+            due_pmt = pmt * (1.0 + rate);
+        else
+            []<bool flag = false>() { static_assert(flag, "Unsupported PaymentDueType"); }();
+
+        // (1 + rate)^n = (due_pmt - fv * rate) / (due_pmt + pv * rate), as log1p of the difference to 1
+        // so that rates close to 0 don't cancel
+        const double growth = -(present_value + future_value) * rate / (due_pmt + present_value * rate);
+        periods = std::log1p(growth) / std::log1p(rate);
+    }
+    return std::isfinite(periods) ? periods : nan;
+}
+
+}
@@ -9,7 +9,9 @@
 
 #include <finfuns/expected.hpp>
 #include <finfuns/npv_calculator.hpp>
+#include <finfuns/simd.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <expected>
@@ -22,6 +24,8 @@ enum class NPVError : int32_t
 {
     InvalidRate, //!< rate is NaN/infinity
     EmptyCashflows, //!< cashflows.empty()
+    ResultsSizeMismatch, //!< results size does not match rates size (npv_profile) or window count (rolling_npv)
+    InvalidWindow, //!< window is 0 or longer than the cashflows (rolling_npv)
 };
 
 constexpr std::string_view error_to_sv(NPVError error)
@@ -32,12 +36,16 @@ constexpr std::string_view error_to_sv(NPVError error)
             return "Invalid rate: NaN or infinity";
         case NPVError::EmptyCashflows:
             return "Cashflows array is empty";
+        case NPVError::ResultsSizeMismatch:
+            return "Results array size does not match the number of rates/windows";
+        case NPVError::InvalidWindow:
+            return "Window must be non-zero and not longer than the cashflows";
         default:
             return "Unknown NPV error";
     }
 }
 
-template <IndexMode index_mode>
+template <IndexMode index_mode, simd::Isa isa = simd::compiled_isa>
 expected<double, NPVError> npv(double rate, std::span<const double> cashflows)
 {
     if (std::isnan(rate) || std::isinf(rate)) [[unlikely]]
@@ -45,7 +53,23 @@ expected<double, NPVError> npv(double rate, std::span<const double> cashflows)
     if (cashflows.empty()) [[unlikely]]
         return unexpected(NPVError::EmptyCashflows);
     auto calc = NpvCalculator(cashflows);
-    return calc.template calculate<index_mode>(rate);
+    return calc.template calculate<index_mode, isa>(rate);
+}
+
+// NPV of the cashflows at every rate of rates (e.g. an NPV / rate chart), results[j] is the NPV at rates[j].
+// Equivalent to calling npv() per rate, but the cashflows are read once for all the rates.
+template <IndexMode index_mode, simd::Isa isa = simd::compiled_isa>
+expected<void, NPVError> npv_profile(std::span<const double> rates, std::span<const double> cashflows, std::span<double> results)
+{
+    if (std::ranges::any_of(rates, [](double rate) { return std::isnan(rate) || std::isinf(rate); })) [[unlikely]]
+        return unexpected(NPVError::InvalidRate);
+    if (cashflows.empty()) [[unlikely]]
+        return unexpected(NPVError::EmptyCashflows);
+    if (rates.size() != results.size()) [[unlikely]]
+        return unexpected(NPVError::ResultsSizeMismatch);
+    auto calc = NpvCalculator(cashflows);
+    calc.template calculate_profile<index_mode, isa>(rates, results);
+    return {};
 }
 
 }
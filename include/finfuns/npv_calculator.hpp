@@ -7,7 +7,13 @@
 //  1.0. (See accompanying file LICENSE_1_0.txt or copy at
 //  http://www.boost.org/LICENSE_1_0.txt)
 
+#include <finfuns/npv_kernels.hpp>
+#include <finfuns/simd.hpp>
+#include <finfuns/small_buffer.hpp>
+
+#include <algorithm>
 #include <cmath>
+#include <concepts>
 #include <cstdint>
 #include <expected>
 #include <limits>
@@ -23,32 +29,130 @@ enum class IndexMode : int32_t
     OneBased //!< Cashflows are indexed starting from 1 (Excel style)
 };
 
+// Float: the type the NPV is computed in. NpvCalculator<float> (over float cashflows) runs the SIMD
+// kernels with twice the lanes of double - see irr<NpvEvaluation::MixedPrecision>.
+template <std::floating_point Float = double>
 struct NpvCalculator
 {
-    std::span<const double> _cashflows;
+    std::span<const Float> _cashflows;
 
-    explicit NpvCalculator(std::span<const double> cashflows)
+    explicit NpvCalculator(std::span<const Float> cashflows)
         : _cashflows{cashflows}
     {
     }
 
-    template <IndexMode index_mode = IndexMode::ZeroBased>
-    double calculate(double rate) const
+    template <IndexMode index_mode = IndexMode::ZeroBased, simd::Isa isa = simd::compiled_isa>
+    Float calculate(Float rate) const
     {
         if (rate == 0)
-            return std::accumulate(std::begin(_cashflows), std::end(_cashflows), 0.0);
-        if (rate <= -1.0) [[unlikely]]
-            return std::numeric_limits<double>::infinity();
+            return std::accumulate(std::begin(_cashflows), std::end(_cashflows), Float{0});
+        if (rate <= -1) [[unlikely]]
+            return std::numeric_limits<Float>::infinity();
 
-        double npv = 0.0;
-        const double growth_factor = 1.0 + rate;
+        if constexpr (isa == simd::Isa::Scalar)
+        {
+            return calculate_scalar<index_mode>(rate);
+        }
+        else
+        {
+            // sum(cf[i] * v^i) with v = 1/(1+r): one division per call instead of one per cashflow
+            const Float v = 1 / (1 + rate);
+            const Float npv = detail::discounted_sum<isa>(_cashflows.data(), _cashflows.size(), v);
+            if constexpr (index_mode == IndexMode::ZeroBased)
+                return npv;
+            else
+                return npv * v;
+        }
+    }
+
+    // ZeroBased with the kernel set given, like calculate_with_derivative (see IsaCalculator)
+    template <simd::Isa isa>
+    Float calculate(Float rate) const
+    {
+        return calculate<IndexMode::ZeroBased, isa>(rate);
+    }
+
+    // Used only for IRR calculation, hence just ZeroBased
+    template <simd::Isa isa = simd::compiled_isa>
+    std::pair<Float, Float> calculate_with_derivative(Float rate) const
+    {
+        if (rate == 0)
+        {
+            Float sum = std::accumulate(std::begin(_cashflows), std::end(_cashflows), Float{0});
+            Float derivative = 0;
+            for (size_t i = 1; i < _cashflows.size(); ++i)
+            {
+                derivative -= _cashflows[i] * static_cast<Float>(i);
+            }
+            return {sum, derivative};
+        }
+
+        if (rate <= -1) [[unlikely]]
+            return {std::numeric_limits<Float>::infinity(), std::numeric_limits<Float>::quiet_NaN()};
+
+        if constexpr (isa == simd::Isa::Scalar)
+        {
+            return calculate_with_derivative_scalar(rate);
+        }
+        else
+        {
+            // d/dr sum(cf[i] * v^i) = -v * sum(i * cf[i] * v^i)
+            const Float v = 1 / (1 + rate);
+            const auto [npv, weighted] = detail::discounted_sums<isa>(_cashflows.data(), _cashflows.size(), v);
+            return {npv, -v * weighted};
+        }
+    }
+
+    // NPV at every rate of rates into results (of the same size).
+    //
+    // The cashflows are streamed once, in blocks of profile_block_size, and every block updates the
+    // accumulators of all rates - instead of one full pass over the cashflows per rate.
+    template <IndexMode index_mode = IndexMode::ZeroBased, simd::Isa isa = simd::compiled_isa>
+        requires std::same_as<Float, double>
+    void calculate_profile(std::span<const double> rates, std::span<double> results) const
+    {
+        const size_t n_rates = rates.size();
+        // v = 1/(1+r) and the running discount factor v^i of every rate
+        auto v = SmallBuffer<double, 256>(n_rates);
+        auto discount = SmallBuffer<double, 256>(n_rates);
+        for (size_t j = 0; j < n_rates; ++j)
+        {
+            v.data()[j] = rates[j] <= -1.0 ? 0.0 : 1.0 / (1.0 + rates[j]);
+            discount.data()[j] = 1.0;
+            results[j] = 0.0;
+        }
+
+        for (size_t begin = 0; begin < _cashflows.size(); begin += profile_block_size)
+        {
+            const size_t n = std::min(profile_block_size, _cashflows.size() - begin);
+            detail::discounted_profile<isa>(_cashflows.data() + begin, n, v.data(), discount.data(), results.data(), n_rates);
+        }
+
+        for (size_t j = 0; j < n_rates; ++j)
+        {
+            if (rates[j] <= -1.0) [[unlikely]]
+                results[j] = std::numeric_limits<double>::infinity();
+            else if constexpr (index_mode == IndexMode::OneBased)
+                results[j] *= v.data()[j];
+        }
+    }
+
+    // Cashflows per block of calculate_profile - 8KB, stays in L1 while all the rates pass over it
+    static constexpr size_t profile_block_size = 1024;
+
+private:
+    template <IndexMode index_mode>
+    Float calculate_scalar(Float rate) const
+    {
+        Float npv = 0;
+        const Float growth_factor = 1 + rate;
         if constexpr (index_mode == IndexMode::ZeroBased)
         {
             // First cashflow (t=0) is not discounted
             npv = _cashflows[0];
 
             // Discount subsequent cashflows (t=1, t=2, ...)
-            double discount_factor = growth_factor; // (1+r)^1
+            Float discount_factor = growth_factor; // (1+r)^1
             for (size_t i = 1; i < _cashflows.size(); ++i)
             {
                 npv += _cashflows[i] / discount_factor;
@@ -59,7 +163,7 @@ struct NpvCalculator
         {
             // IndexMode::OneBased
             // All cashflows are discounted (t=1, t=2, ...)
-            double discount_factor = growth_factor; // Start with (1+r)^1 for t=1
+            Float discount_factor = growth_factor; // Start with (1+r)^1 for t=1
             for (const auto cf : _cashflows)
             {
                 npv += cf / discount_factor;
@@ -69,35 +173,72 @@ struct NpvCalculator
         return npv;
     }
 
-    // Used only for IRR calculation, hence just ZeroBased
-    std::pair<double, double> calculate_with_derivative(double rate) const
+    std::pair<Float, Float> calculate_with_derivative_scalar(Float rate) const
     {
-        if (rate == 0)
+        Float npv = _cashflows[0]; // First cashflow (t=0) is not discounted
+        Float derivative = 0;
+        Float compound = (1 + rate); // (1+r)^1 for t=1
+
+        for (size_t i = 1; i < _cashflows.size(); ++i)
         {
-            double sum = std::accumulate(std::begin(_cashflows), std::end(_cashflows), 0.0);
-            double derivative = 0.0;
-            for (size_t i = 1; i < _cashflows.size(); ++i)
-            {
-                derivative -= _cashflows[i] * static_cast<double>(i);
-            }
-            return {sum, derivative};
+            npv += _cashflows[i] / compound;
+            derivative -= _cashflows[i] * static_cast<Float>(i) / (compound * (1 + rate));
+            compound *= (1 + rate); // becomes (1+r)^(i+1) for next iteration
         }
 
+        return {npv, derivative};
+    }
+};
+
+NpvCalculator(std::span<const double>) -> NpvCalculator<double>;
+NpvCalculator(std::span<const float>) -> NpvCalculator<float>;
+
+// NPV as a polynomial in v = 1/(1+r), evaluated with the Horner scheme from the last cashflow back:
+//   NPV(v) = c0 + v * (c1 + v * (c2 + ...))
+// One reciprocal per call and no division per cashflow; for r >= 0 the partial sums never
+// exceed sum(|c|), so long series don't overflow like a growing (1+r)^i discount factor does.
+struct HornerNpvCalculator
+{
+    std::span<const double> _cashflows;
+
+    explicit HornerNpvCalculator(std::span<const double> cashflows)
+        : _cashflows{cashflows}
+    {
+    }
+
+    template <IndexMode index_mode = IndexMode::ZeroBased>
+    double calculate(double rate) const
+    {
         if (rate <= -1.0) [[unlikely]]
-            return {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+            return std::numeric_limits<double>::infinity();
 
-        double npv = _cashflows[0]; // First cashflow (t=0) is not discounted
-        double derivative = 0.0;
-        double compound = (1.0 + rate); // (1+r)^1 for t=1
+        const double v = 1.0 / (1.0 + rate);
+        double npv = 0.0;
+        for (size_t i = _cashflows.size(); i-- > 0;)
+            npv = npv * v + _cashflows[i];
 
-        for (size_t i = 1; i < _cashflows.size(); ++i)
+        if constexpr (index_mode == IndexMode::ZeroBased)
+            return npv;
+        else
+            return npv * v;
+    }
+
+    // Value and derivative in the same reverse pass (ZeroBased, as used by IRR)
+    std::pair<double, double> calculate_with_derivative(double rate) const
+    {
+        if (rate <= -1.0) [[unlikely]]
+            return {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+
+        const double v = 1.0 / (1.0 + rate);
+        double npv = 0.0;
+        double npv_dv = 0.0; // d NPV / dv
+        for (size_t i = _cashflows.size(); i-- > 0;)
         {
-            npv += _cashflows[i] / compound;
-            derivative -= _cashflows[i] * static_cast<double>(i) / (compound * (1.0 + rate));
-            compound *= (1.0 + rate); // becomes (1+r)^(i+1) for next iteration
+            npv_dv = npv_dv * v + npv;
+            npv = npv * v + _cashflows[i];
         }
-
-        return {npv, derivative};
+        // dv/dr = -v^2
+        return {npv, -npv_dv * v * v};
     }
 };
 
@@ -0,0 +1,330 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/preprocessor.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace finfuns::detail
+{
+
+// Discount factors below profile_flush_threshold are flushed to 0, at the latest every
+// profile_flush_interval cashflows. Without that a v in (0.5, 1) keeps v^i at the smallest subnormal
+// forever (it rounds up) and every further step runs at subnormal speed. The dropped terms are below
+// 1e-270 of the cashflow.
+inline constexpr std::size_t profile_flush_interval = 32;
+inline constexpr double profile_flush_threshold = 0x1p-900;
+
+// The same for the discounted sums, where float reaches subnormals after a few thousand cashflows
+// already (0.99^9000). The dropped terms are below 1e-18 of the cashflow in float.
+template <typename T>
+inline constexpr T discount_flush_threshold = std::is_same_v<T, float> ? T(0x1p-60f) : T(profile_flush_threshold);
+
+// Binary orders of magnitude between discount_flush_threshold and the smallest normal number
+template <typename T>
+inline constexpr int discount_flush_headroom = std::is_same_v<T, float> ? 126 - 60 : 1022 - 900;
+
+// Steps of a discount factor multiplied by step each, between two flushes: few enough that it
+// cannot get from above the threshold down to subnormals in between
+template <typename T>
+FINFUNS_ALWAYS_INLINE std::size_t discount_flush_interval(T step)
+{
+    if (!(step < 1))
+        return profile_flush_interval;
+    if (!(step > 0))
+        return 1;
+    // step >= 2^-bits
+    const int bits = -std::ilogb(step);
+    return std::clamp<std::size_t>(static_cast<std::size_t>(discount_flush_headroom<T> / bits), 1, profile_flush_interval);
+}
+
+// One rate of the rate profile, see discounted_profile_kernel
+template <typename T>
+FINFUNS_ALWAYS_INLINE void discounted_profile_serial(const T * cf, std::size_t n, T v, T & p, T & acc)
+{
+    T pj = p;
+    T aj = acc;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        aj += cf[i] * pj;
+        pj *= v;
+        if (pj < static_cast<T>(profile_flush_threshold))
+            pj = 0;
+    }
+    p = pj;
+    acc = aj;
+}
+
+#ifdef FINFUNS_VECTOR_EXTENSIONS
+
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpsabi"
+
+// Computes {sum(cf[i] * v^i), sum(i * cf[i] * v^i)} for i = 0..n-1 (the second sum only if with_derivative).
+//
+// Lane l of the two W wide power vectors starts at v^l and v^(W+l) and both advance by v^(2W) per step,
+// so the serial `discount_factor *= growth_factor` chain becomes 2W independent ones and no division
+// is needed - the caller passes v = 1 / (1 + rate). Powers below discount_flush_threshold are
+// flushed to 0 (see profile_flush_threshold).
+template <typename T, std::size_t W, bool with_derivative>
+FINFUNS_ALWAYS_INLINE std::pair<T, T> discounted_sums_kernel(const T * cf, std::size_t n, T v)
+{
+    using V = simd::Vec<T, W>;
+
+    const V threshold = simd::splat<V>(discount_flush_threshold<T>);
+    const V zero = simd::splat<V>(T{0});
+
+    V p0;
+    T pw = 1;
+    for (std::size_t l = 0; l < W; ++l)
+    {
+        p0[l] = pw;
+        pw *= v;
+    }
+    // pw == v^W
+    V p1 = p0 * simd::splat<V>(pw);
+    const V step = simd::splat<V>(pw * pw);
+
+    V idx0 = simd::iota<V, T>();
+    V idx1 = idx0 + simd::splat<V>(static_cast<T>(W));
+    const V idx_step = simd::splat<V>(static_cast<T>(2 * W));
+
+    V s0 = simd::splat<V>(T{0});
+    V s1 = s0;
+    V d0 = s0;
+    V d1 = s0;
+
+    const std::size_t flush_interval = discount_flush_interval(pw * pw);
+    std::size_t i = 0;
+    std::size_t steps = 0;
+    for (; i + 2 * W <= n; i += 2 * W)
+    {
+        const V t0 = simd::load<V>(cf + i) * p0;
+        const V t1 = simd::load<V>(cf + i + W) * p1;
+        s0 += t0;
+        s1 += t1;
+        if constexpr (with_derivative)
+        {
+            d0 += t0 * idx0;
+            d1 += t1 * idx1;
+            idx0 += idx_step;
+            idx1 += idx_step;
+        }
+        p0 *= step;
+        p1 *= step;
+        // Off the multiply chain most of the time: the check every iteration would double its latency
+        if (++steps == flush_interval) [[unlikely]]
+        {
+            p0 = p0 < threshold ? zero : p0;
+            p1 = p1 < threshold ? zero : p1;
+            steps = 0;
+        }
+    }
+
+    T sum = simd::reduce_add<T>(s0 + s1);
+    T derivative_sum = simd::reduce_add<T>(d0 + d1);
+
+    // Tail: p0[0] == v^i
+    T discount = p0[0];
+    for (; i < n; ++i)
+    {
+        const T t = cf[i] * discount;
+        sum += t;
+        if constexpr (with_derivative)
+            derivative_sum += t * static_cast<T>(i);
+        discount *= v;
+    }
+    return {sum, derivative_sum};
+}
+
+// G groups of W rates (consecutive in v, p and acc) over one cashflow block
+template <typename T, std::size_t W, std::size_t G>
+FINFUNS_ALWAYS_INLINE void discounted_profile_groups(const T * cf, std::size_t n, const T * v, T * p, T * acc)
+{
+    using V = simd::Vec<T, W>;
+
+    const V threshold = simd::splat<V>(static_cast<T>(profile_flush_threshold));
+    const V zero = simd::splat<V>(T{0});
+
+    V vg[G];
+    V pg[G];
+    V ag[G];
+#    pragma GCC unroll 8
+    for (std::size_t g = 0; g < G; ++g)
+    {
+        vg[g] = simd::load<V>(v + g * W);
+        pg[g] = simd::load<V>(p + g * W);
+        ag[g] = simd::load<V>(acc + g * W);
+    }
+    for (std::size_t chunk = 0; chunk < n; chunk += profile_flush_interval)
+    {
+        const std::size_t chunk_end = std::min(n, chunk + profile_flush_interval);
+        for (std::size_t i = chunk; i < chunk_end; ++i)
+        {
+            const V c = simd::splat<V>(cf[i]);
+#    pragma GCC unroll 8
+            for (std::size_t g = 0; g < G; ++g)
+            {
+                ag[g] += c * pg[g];
+                pg[g] *= vg[g];
+            }
+        }
+#    pragma GCC unroll 8
+        for (std::size_t g = 0; g < G; ++g)
+            pg[g] = pg[g] < threshold ? zero : pg[g];
+    }
+#    pragma GCC unroll 8
+    for (std::size_t g = 0; g < G; ++g)
+    {
+        simd::store(p + g * W, pg[g]);
+        simd::store(acc + g * W, ag[g]);
+    }
+}
+
+// Rate profile step over one cashflow block, for n_rates rates at once:
+// acc[j] += sum(cf[i] * p[j] * v[j]^i) for i = 0..n-1, then p[j] *= v[j]^n.
+//
+// p[j] carries the discount factor of rate j across blocks, so the block is streamed once for all
+// rates. Each lane holds one rate; four W wide rate groups are interleaved to hide the latency of
+// the accumulate and power chains.
+template <typename T, std::size_t W>
+FINFUNS_ALWAYS_INLINE void discounted_profile_kernel(const T * cf, std::size_t n, const T * v, T * p, T * acc, std::size_t n_rates)
+{
+    constexpr std::size_t groups = 4;
+
+    std::size_t j = 0;
+    for (; j + groups * W <= n_rates; j += groups * W)
+        discounted_profile_groups<T, W, groups>(cf, n, v + j, p + j, acc + j);
+
+    // Rates tail: zero padded, v = p = 0 keeps the padded lanes at 0
+    for (; j < n_rates; j += W)
+    {
+        T v_lanes[W] = {};
+        T p_lanes[W] = {};
+        T acc_lanes[W] = {};
+        const std::size_t lanes = std::min(W, n_rates - j);
+        std::copy_n(v + j, lanes, v_lanes);
+        std::copy_n(p + j, lanes, p_lanes);
+        std::copy_n(acc + j, lanes, acc_lanes);
+        discounted_profile_groups<T, W, 1>(cf, n, v_lanes, p_lanes, acc_lanes);
+        std::copy_n(p_lanes, lanes, p + j);
+        std::copy_n(acc_lanes, lanes, acc + j);
+    }
+}
+
+#    pragma GCC diagnostic pop
+
+#endif
+
+#ifdef FINFUNS_X86_SIMD
+
+FINFUNS_TARGET_AVX2 inline double discounted_sum_avx2(const double * cf, std::size_t n, double v)
+{
+    return discounted_sums_kernel<double, 4, false>(cf, n, v).first;
+}
+
+FINFUNS_TARGET_AVX2 inline std::pair<double, double> discounted_sums_avx2(const double * cf, std::size_t n, double v)
+{
+    return discounted_sums_kernel<double, 4, true>(cf, n, v);
+}
+
+FINFUNS_TARGET_AVX512 inline double discounted_sum_avx512(const double * cf, std::size_t n, double v)
+{
+    return discounted_sums_kernel<double, 8, false>(cf, n, v).first;
+}
+
+FINFUNS_TARGET_AVX512 inline std::pair<double, double> discounted_sums_avx512(const double * cf, std::size_t n, double v)
+{
+    return discounted_sums_kernel<double, 8, true>(cf, n, v);
+}
+
+// Single precision: the same register width holds twice the lanes
+FINFUNS_TARGET_AVX2 inline float discounted_sum_avx2(const float * cf, std::size_t n, float v)
+{
+    return discounted_sums_kernel<float, 8, false>(cf, n, v).first;
+}
+
+FINFUNS_TARGET_AVX2 inline std::pair<float, float> discounted_sums_avx2(const float * cf, std::size_t n, float v)
+{
+    return discounted_sums_kernel<float, 8, true>(cf, n, v);
+}
+
+FINFUNS_TARGET_AVX512 inline float discounted_sum_avx512(const float * cf, std::size_t n, float v)
+{
+    return discounted_sums_kernel<float, 16, false>(cf, n, v).first;
+}
+
+FINFUNS_TARGET_AVX512 inline std::pair<float, float> discounted_sums_avx512(const float * cf, std::size_t n, float v)
+{
+    return discounted_sums_kernel<float, 16, true>(cf, n, v);
+}
+
+FINFUNS_TARGET_AVX2 inline void
+discounted_profile_avx2(const double * cf, std::size_t n, const double * v, double * p, double * acc, std::size_t n_rates)
+{
+    discounted_profile_kernel<double, 4>(cf, n, v, p, acc, n_rates);
+}
+
+FINFUNS_TARGET_AVX512 inline void
+discounted_profile_avx512(const double * cf, std::size_t n, const double * v, double * p, double * acc, std::size_t n_rates)
+{
+    discounted_profile_kernel<double, 8>(cf, n, v, p, acc, n_rates);
+}
+
+#endif
+
+template <simd::Isa isa, typename T>
+FINFUNS_ALWAYS_INLINE T discounted_sum(const T * cf, std::size_t n, T v)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        return discounted_sum_avx512(cf, n, v);
+    else if constexpr (isa == simd::Isa::Avx2)
+        return discounted_sum_avx2(cf, n, v);
+    else
+#endif
+        []<bool flag = false>() { static_assert(flag, "Unsupported Isa"); }();
+}
+
+template <simd::Isa isa, typename T>
+FINFUNS_ALWAYS_INLINE std::pair<T, T> discounted_sums(const T * cf, std::size_t n, T v)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        return discounted_sums_avx512(cf, n, v);
+    else if constexpr (isa == simd::Isa::Avx2)
+        return discounted_sums_avx2(cf, n, v);
+    else
+#endif
+        []<bool flag = false>() { static_assert(flag, "Unsupported Isa"); }();
+}
+
+template <simd::Isa isa>
+FINFUNS_ALWAYS_INLINE void discounted_profile(const double * cf, std::size_t n, const double * v, double * p, double * acc, std::size_t n_rates)
+{
+#ifdef FINFUNS_X86_SIMD
+    if constexpr (isa == simd::Isa::Avx512)
+        discounted_profile_avx512(cf, n, v, p, acc, n_rates);
+    else if constexpr (isa == simd::Isa::Avx2)
+        discounted_profile_avx2(cf, n, v, p, acc, n_rates);
+    else
+#endif
+    {
+        static_assert(isa == simd::Isa::Scalar, "Unsupported Isa");
+        for (std::size_t j = 0; j < n_rates; ++j)
+            discounted_profile_serial(cf, n, v[j], p[j], acc[j]);
+    }
+}
+
+}
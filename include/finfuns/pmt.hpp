@@ -0,0 +1,53 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/payment_due_type.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace finfuns
+{
+
+namespace detail
+{
+
+// (1 + rate)^periods - 1, accurate for rates close to 0 where the pow form cancels
+inline double compound_growth(double rate, double periods)
+{
+    return std::expm1(periods * std::log1p(rate));
+}
+
+}
+
+// Payment per period that pays off present_value (and leaves future_value) after periods payments.
+// Same sign convention as pv / fv: a loan received (present_value > 0) gives a negative payment.
+// NaN for rate <= -1 or periods == 0.
+template <PaymentDueType due_type>
+inline double pmt(double rate, uint32_t periods, double present_value, double future_value = 0.0)
+{
+    if (rate <= -1.0 || periods == 0) [[unlikely]]
+        return std::numeric_limits<double>::quiet_NaN();
+    if (rate == 0.)
+        return -(present_value + future_value) / periods;
+
+    // -rate * (pv * (1 + rate)^n + fv) / ((1 + rate)^n - 1), without the large terms that cancel
+    const double growth = detail::compound_growth(rate, periods);
+    const double payment = -rate * (present_value + (present_value + future_value) / growth);
+
+    if constexpr (due_type == PaymentDueType::EndOfPeriod)
+        return payment;
+    else if constexpr (due_type == PaymentDueType::BeginningOfPeriod)
+        return payment / (1.0 + rate);
+    else
+        []<bool flag = false>() { static_assert(flag, "Unsupported PaymentDueType"); }();
+}
+
+}
@@ -15,3 +15,24 @@
 #else
 #    define FINFUNS_NOINLINE
 #endif
+
+#if defined(_MSC_VER)
+#    define FINFUNS_ALWAYS_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#    define FINFUNS_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#    define FINFUNS_ALWAYS_INLINE inline
+#endif
+
+// GCC/Clang vector extensions - used to write the SIMD kernels once for every lane width
+#if defined(__GNUC__) || defined(__clang__)
+#    define FINFUNS_VECTOR_EXTENSIONS 1
+#endif
+
+// x86 kernels are compiled with per function target attributes, so they are available
+// regardless of the -m flags the translation unit is built with
+#if defined(FINFUNS_VECTOR_EXTENSIONS) && (defined(__x86_64__) || defined(__i386__))
+#    define FINFUNS_X86_SIMD 1
+#    define FINFUNS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#    define FINFUNS_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx2,fma")))
+#endif
@@ -0,0 +1,210 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/expected.hpp>
+#include <finfuns/payment_due_type.hpp>
+#include <finfuns/pmt.hpp>
+#include <finfuns/rate_solver.hpp>
+#include <finfuns/root_check.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+// RATE: the periodic rate at which periods payments of pmt turn present_value into future_value,
+// same sign convention as pv / fv / pmt.
+//
+// The annuity is a cashflow series - pv (plus pmt if due at the beginning) at 0, pmt at 1 .. n - 1,
+// fv (plus pmt if due at the end) at n - so its NPV is solved by rate_solver like irr(), but evaluated
+// in closed form: O(1) per evaluation whatever the number of periods, with an analytic derivative.
+// The three distinct cashflows also give the root structure (see root_check.hpp), which for loans and
+// savings plans (one sign change) makes the solve a bracketed Newton.
+
+namespace finfuns
+{
+
+enum class AnnuityRateErrorCode : int32_t
+{
+    ZeroPeriods, //!< At least one period is required
+    SameSignCashflows, //!< pv, pmt and fv all have the same sign (or are all 0)
+    InvalidDueType, //!< Payment due type is not a PaymentDueType (batch inputs)
+};
+
+using AnnuityRateError = std::variant<AnnuityRateErrorCode, SolverErrorCode>;
+
+constexpr std::string_view error_to_sv(AnnuityRateErrorCode error)
+{
+    switch (error)
+    {
+        case AnnuityRateErrorCode::ZeroPeriods:
+            return "Zero periods: at least one is required";
+        case AnnuityRateErrorCode::SameSignCashflows:
+            return "Present value, payment and future value all have the same sign";
+        case AnnuityRateErrorCode::InvalidDueType:
+            return "Invalid payment due type";
+        default:
+            return "Unknown RATE error";
+    }
+}
+
+constexpr std::string_view error_to_sv(const AnnuityRateError & error)
+{
+    return std::visit([](const auto & e) { return error_to_sv(e); }, error);
+}
+
+// pv + pmt * (1 + rate * type) * (1 - (1 + rate)^-n) / rate + fv * (1 + rate)^-n: the NPV of the annuity's
+// cashflows, 0 at the rate RATE returns
+template <PaymentDueType due_type>
+struct AnnuityRateCalculator
+{
+    double _periods;
+    double _pmt;
+    double _present_value;
+    double _future_value;
+
+    static constexpr double due_factor = due_type == PaymentDueType::BeginningOfPeriod ? 1.0 : 0.0;
+
+    AnnuityRateCalculator(uint32_t periods, double pmt, double present_value, double future_value)
+        : _periods{static_cast<double>(periods)}
+        , _pmt{pmt}
+        , _present_value{present_value}
+        , _future_value{future_value}
+    {
+        static_assert(
+            due_type == PaymentDueType::EndOfPeriod || due_type == PaymentDueType::BeginningOfPeriod, "Unsupported PaymentDueType");
+    }
+
+    double calculate(double rate) const
+    {
+        if (rate <= -1.0) [[unlikely]]
+            return std::numeric_limits<double>::infinity();
+
+        // (1 + rate)^-n and its complement through log1p / expm1, so that rates close to 0 don't cancel
+        const double log_discount = -_periods * std::log1p(rate);
+        const double discount = std::exp(log_discount);
+        const double due = 1.0 + rate * due_factor;
+        if (!std::isfinite(discount)) [[unlikely]]
+            return overflow_value(rate, due, discount);
+        const double annuity = rate == 0.0 ? _periods : -std::expm1(log_discount) / rate;
+        return _present_value + _pmt * due * annuity + _future_value * discount;
+    }
+
+    std::pair<double, double> calculate_with_derivative(double rate) const
+    {
+        if (rate <= -1.0) [[unlikely]]
+            return {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+
+        const double n = _periods;
+        const double log_discount = -n * std::log1p(rate);
+        const double discount = std::exp(log_discount);
+        const double due = 1.0 + rate * due_factor;
+        const double discount_derivative = -n * discount / (1.0 + rate);
+        if (!std::isfinite(discount)) [[unlikely]]
+            return {overflow_value(rate, due, discount), overflow_value(rate, due, discount_derivative)};
+        const double annuity = rate == 0.0 ? n : -std::expm1(log_discount) / rate;
+        // d/dr of the annuity factor is (n * (1 + rate)^(-n - 1) - annuity) / rate, whose difference
+        // cancels for small n * rate: there the first two terms of its Taylor series at 0 are exact enough
+        const double annuity_derivative = std::abs(n * rate) < 1e-4
+            ? -n * (n + 1.0) / 2.0 + n * (n + 1.0) * (n + 2.0) / 3.0 * rate
+            : (-discount_derivative - annuity) / rate;
+
+        const double value = _present_value + _pmt * due * annuity + _future_value * discount;
+        const double derivative = _pmt * (due_factor * annuity + due * annuity_derivative) + _future_value * discount_derivative;
+        return {value, derivative};
+    }
+
+private:
+    // Close to rate -1 (1 + rate)^-n overflows: then the terms in it, whose sum would be inf - inf apart,
+    // dominate the value (factor the discount) and the derivative (factor its derivative)
+    double overflow_value(double rate, double due, double factor) const { return factor * (_future_value - _pmt * due / rate); }
+};
+
+namespace detail
+{
+
+// The distinct cashflows of the annuity in time order: at 0, at 1 .. n - 1 (if n > 1), at n
+template <PaymentDueType due_type>
+std::pair<std::array<double, 3>, std::size_t> annuity_cashflows(uint32_t periods, double pmt, double present_value, double future_value)
+{
+    constexpr bool begin = due_type == PaymentDueType::BeginningOfPeriod;
+    const double first = begin ? present_value + pmt : present_value;
+    const double last = begin ? future_value : future_value + pmt;
+    if (periods == 1)
+        return {{first, last, 0.0}, 2};
+    return {{first, pmt, last}, 3};
+}
+
+// Closed form estimate of the rate, to start the solve from.
+//
+// In the payment equation pmt * (1 + rate * type) = -pv * rate - (pv + fv) / s(rate), with
+// s(rate) = ((1 + rate)^n - 1) / rate, 1 / s(rate) is replaced by its tangent at 0,
+// (1 - (n - 1) / 2 * rate) / n, leaving a linear equation (for a plain loan the textbook
+// 2 * (n * pmt / pv - 1) / (n + 1) approximation). It is good while n * rate is small; for loans (pv
+// the larger lump sum), where s(rate) flattens out at larger rates, one step of the fixed point
+// iteration of the payment equation in rate follows - typically leaving Newton 2-4 steps.
+template <PaymentDueType due_type>
+double annuity_rate_guess(uint32_t periods, double pmt, double present_value, double future_value)
+{
+    constexpr double type = due_type == PaymentDueType::BeginningOfPeriod ? 1.0 : 0.0;
+    constexpr double default_guess = 0.1;
+    const double n = static_cast<double>(periods);
+    const double total = present_value + future_value;
+
+    const double guess = -(pmt + total / n) / (present_value - total * (n - 1.0) / (2.0 * n) + type * pmt);
+    if (!(guess > RateSolverLimits::lower_bound && guess < RateSolverLimits::upper_bound))
+        return default_guess;
+    if (present_value == 0.0 || std::abs(present_value) < std::abs(future_value))
+        return guess;
+
+    const double s = guess == 0.0 ? n : compound_growth(guess, n) / guess;
+    const double refined = (-pmt * (1.0 + type * guess) - total / s) / present_value;
+    return refined > RateSolverLimits::lower_bound && refined < RateSolverLimits::upper_bound ? refined : guess;
+}
+
+}
+
+// The periodic rate of an annuity of periods payments of pmt from present_value to future_value
+// (Excel RATE). guess defaults to a closed form estimate (see detail::annuity_rate_guess); stats
+// (optional) receives the solver diagnostics, see SolverStats.
+template <PaymentDueType due_type>
+expected<double, AnnuityRateError> rate(
+    uint32_t periods,
+    double pmt,
+    double present_value,
+    double future_value = 0.0,
+    std::optional<double> guess = std::nullopt,
+    SolverStats * stats = nullptr)
+{
+    if (periods == 0) [[unlikely]]
+        return unexpected(AnnuityRateErrorCode::ZeroPeriods);
+    if (!std::isfinite(pmt) || !std::isfinite(present_value) || !std::isfinite(future_value)) [[unlikely]]
+        return unexpected(SolverErrorCode::CANNOT_EVALUATE_VALUE);
+
+    const auto [cashflows, size] = detail::annuity_cashflows<due_type>(periods, pmt, present_value, future_value);
+    const auto flows = std::span<const double>(cashflows.data(), size);
+    if (count_sign_changes(flows) == 0) [[unlikely]]
+        return unexpected(AnnuityRateErrorCode::SameSignCashflows);
+
+    const double guess_value = guess ? *guess : detail::annuity_rate_guess<due_type>(periods, pmt, present_value, future_value);
+    auto calculator = AnnuityRateCalculator<due_type>(periods, pmt, present_value, future_value);
+    const auto structure = descartes_root_structure(flows);
+    auto res = structure ? rate_solver(calculator, guess_value, *structure, stats) : rate_solver(calculator, guess_value, stats);
+    if (res.has_value()) [[likely]]
+        return res.value();
+    return unexpected(res.error());
+}
+
+}
@@ -8,12 +8,15 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <finfuns/expected.hpp>
+#include <finfuns/simd.hpp>
 
-#include <boost/math/tools/roots.hpp>
-
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace finfuns
@@ -53,12 +56,12 @@ struct CachedFunction
     double _last_rate = std::numeric_limits<double>::quiet_NaN();
     std::pair<double, double> _last_result;
 
-    explicit CachedFunction(Calculator & c)
+    explicit CachedFunction(Calculator & c) noexcept
         : _calculator{c}
     {
     }
 
-    std::pair<double, double> operator()(double rate)
+    std::pair<double, double> operator()(double rate) noexcept
     {
         if (rate != _last_rate)
         {
@@ -69,65 +72,514 @@ struct CachedFunction
     }
 };
 
+// Diagnostics of one rate_solver call
+struct SolverStats
+{
+    int32_t newton_iterations = 0; //!< Newton steps taken
+    int32_t bracket_iterations = 0; //!< Brent steps taken (0 unless used_fallback)
+    int32_t function_evaluations = 0; //!< calculate + calculate_with_derivative calls
+    bool used_fallback = false; //!< Newton did not end on a root and the bracketed solve ran
+    double residual = std::numeric_limits<double>::quiet_NaN(); //!< f at the last point of the solve
+    double bracket_lower = std::numeric_limits<double>::quiet_NaN(); //!< Final bracket (the search bounds if Newton succeeded)
+    double bracket_upper = std::numeric_limits<double>::quiet_NaN();
+    int32_t low_precision_iterations = 0; //!< Single precision Newton steps before the solve (mixed precision IRR only)
+};
+
+// Interval for the bracketed solve to try before the full search bounds
+struct RateBracket
+{
+    double lower;
+    double upper;
+};
+
+// Bracket around a warm start guess, e.g. the previous result of a recurring computation whose inputs
+// moved a little: +-(1% + 10% of the guess)
+constexpr RateBracket warm_start_bracket(double guess) noexcept
+{
+    const double half_width = 0.01 + 0.1 * (guess < 0.0 ? -guess : guess);
+    return {guess - half_width, guess + half_width};
+}
+
+// What is known about the roots of f before solving (see root_check.hpp): f changes sign at most
+// once on (lower, inf) and, above that root, has the sign of sign_above.
+struct SingleSignChange
+{
+    double lower; //!< The interval starts here (-1 for the whole domain)
+    bool root_above_lower; //!< The root is known to exist (and to be above lower)
+    double sign_above; //!< +1.0 or -1.0, the sign of f above the root
+};
+
+namespace detail
+{
+
+struct RateSolverLimits
+{
+    static constexpr int max_iterations = 100;
+    static constexpr double lower_bound = -0.999999; // Avoid the rate of -1.
+    static constexpr double upper_bound = 100.0; // Reasonable upper bound for financial applications IRR/XIRR
+    static constexpr double residual_tolerance = 1e-6; // Tolerance for the result check
+    // 53 - 4 bits of precision => ~14.75 decimal digits - accurate enough for our purpose
+    static constexpr double relative_precision = 0x1p-49;
+    static constexpr double absolute_precision = std::numeric_limits<double>::epsilon();
+
+    static constexpr double step_tolerance(double x) noexcept { return relative_precision * std::abs(x) + absolute_precision; }
+};
+
+// Forwards to Calculator and counts the evaluations - only used when stats are requested
 template <typename Calculator>
-expected<double, SolverErrorCode> rate_solver(Calculator && calculator, double guess)
+struct CountingCalculator
+{
+    Calculator & _calculator;
+    int32_t & _evaluations;
+
+    double calculate(double rate) const
+    {
+        ++_evaluations;
+        return _calculator.calculate(rate);
+    }
+
+    std::pair<double, double> calculate_with_derivative(double rate) const
+    {
+        ++_evaluations;
+        return _calculator.calculate_with_derivative(rate);
+    }
+};
+
+struct NewtonResult
+{
+    double rate;
+    int32_t iterations;
+};
+
+// Newton-Raphson kept inside [lower_bound, upper_bound]: a step leaving the bounds is replaced by
+// a bisection towards the violated bound. Stops on a non finite value/derivative or a zero derivative.
+// Returns the last point f was evaluated at, so its value is still in the cache.
+template <typename L = RateSolverLimits, typename Function>
+NewtonResult newton_iterate(Function & f, double guess) noexcept
 {
-    constexpr int max_iterations = 100;
-    constexpr double start_lower_bound = -0.999999; // Avoid the rate of -1.
-    constexpr double start_upper_bound = 100.0; // Reasonable upper bound for financial applications IRR/XIRR
-    constexpr double tolerance = 1e-6; // Tolerance for the result check
-    try
+
+    double x = std::clamp(guess, L::lower_bound, L::upper_bound);
+    int32_t iteration = 0;
+    for (; iteration < L::max_iterations; ++iteration)
     {
-        boost::uintmax_t max_iter = max_iterations;
+        const auto [value, derivative] = f(x);
+        if (value == 0.0 || !std::isfinite(value) || !std::isfinite(derivative) || derivative == 0.0)
+            break;
+
+        const double delta = value / derivative;
+        if (std::abs(delta) <= L::step_tolerance(x))
+            break;
 
-        // 53 - 4 bits of precision => ~14.75 decimal digits - accurate enough for our purpose
-        constexpr auto binary_precision = std::numeric_limits<double>::digits - 4;
+        double next = x - delta;
+        if (next <= L::lower_bound)
+            next = 0.5 * (x + L::lower_bound);
+        else if (next >= L::upper_bound)
+            next = 0.5 * (x + L::upper_bound);
+        x = next;
+    }
+    return {x, iteration};
+}
 
-        auto cached_fun = CachedFunction(calculator);
-        auto f0 = [&cached_fun](double rate) { return cached_fun(rate).first; };
-        auto f1 = [&cached_fun](double rate) { return cached_fun(rate).second; };
+// Brent's method on [a, b] with f(a) and f(b) of opposite signs.
+template <bool with_stats, typename Function>
+expected<double, SolverErrorCode> brent_solve(Function & f, double a, double b, double fa, double fb, SolverStats * stats) noexcept
+{
+    using L = RateSolverLimits;
 
-        double result = boost::math::tools::newton_raphson_iterate(
-            [&f0, &f1](double x) { return std::make_tuple(f0(x), f1(x)); },
-            guess,
-            start_lower_bound,
-            start_upper_bound,
-            binary_precision,
-            max_iter);
+    double c = a;
+    double fc = fa;
+    double d = b - a;
+    double e = d;
+    auto record = [&](int32_t iterations)
+    {
+        if constexpr (with_stats)
+        {
+            stats->bracket_iterations = iterations;
+            stats->residual = fb;
+            stats->bracket_lower = std::min(b, c);
+            stats->bracket_upper = std::max(b, c);
+        }
+    };
 
-        auto fun = [&calculator](double rate) { return calculator.calculate(rate); };
-        if (result >= start_lower_bound && result <= start_upper_bound && std::abs(fun(result)) < tolerance)
-            return result;
+    for (int32_t iteration = 0; iteration < L::max_iterations; ++iteration)
+    {
+        if ((fb > 0.0) == (fc > 0.0))
+        {
+            // Keep the root between b and c
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (std::abs(fc) < std::abs(fb))
+        {
+            // b is the best estimate so far
+            a = b;
+            b = c;
+            c = a;
+            fa = fb;
+            fb = fc;
+            fc = fa;
+        }
 
-        // Fallback to TOMS748
-        const double f_lower = fun(start_lower_bound);
-        const double f_upper = fun(start_upper_bound);
+        const double tol = 0.5 * L::step_tolerance(b);
+        const double m = 0.5 * (c - b);
+        if (std::abs(m) <= tol || fb == 0.0)
+        {
+            record(iteration);
+            return b;
+        }
 
-        if (f_lower * f_upper >= 0.0) [[unlikely]]
-            return unexpected(SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+        if (std::abs(e) >= tol && std::abs(fa) > std::abs(fb))
+        {
+            // Secant (a == c) or inverse quadratic interpolation
+            double p;
+            double q;
+            const double s = fb / fa;
+            if (a == c)
+            {
+                p = 2.0 * m * s;
+                q = 1.0 - s;
+            }
+            else
+            {
+                const double r = fb / fc;
+                const double t = fa / fc;
+                p = s * (2.0 * m * t * (t - r) - (b - a) * (r - 1.0));
+                q = (t - 1.0) * (r - 1.0) * (s - 1.0);
+            }
+            if (p > 0.0)
+                q = -q;
+            else
+                p = -p;
 
-        max_iter = max_iterations;
-        boost::math::tools::eps_tolerance<double> tol(std::numeric_limits<double>::digits - 4);
-        auto toms_result = boost::math::tools::toms748_solve(fun, start_lower_bound, start_upper_bound, tol, max_iter);
+            if (2.0 * p < std::min(3.0 * m * q - std::abs(tol * q), std::abs(e * q)))
+            {
+                e = d;
+                d = p / q;
+            }
+            else
+            {
+                d = m;
+                e = m;
+            }
+        }
+        else
+        {
+            d = m;
+            e = m;
+        }
 
-        return toms_result.first;
+        a = b;
+        fa = fb;
+        b += std::abs(d) > tol ? d : (m > 0.0 ? tol : -tol);
+        fb = f(b);
+        if (std::isnan(fb)) [[unlikely]]
+        {
+            record(iteration + 1);
+            return unexpected(SolverErrorCode::CANNOT_EVALUATE_VALUE);
+        }
     }
-    catch (const boost::math::evaluation_error &)
+
+    record(L::max_iterations);
+    if (std::abs(fb) < L::residual_tolerance)
+        return b;
+    return unexpected(SolverErrorCode::CANNOT_CONVERGE_DUE_TO_ROUNDING_ERRORS);
+}
+
+// Brent's method on [lower, upper] if f changes sign there
+template <bool with_stats, typename Function>
+expected<double, SolverErrorCode> bracketed_solve(Function & f, double lower, double upper, SolverStats * stats) noexcept
+{
+    if constexpr (with_stats)
     {
+        stats->bracket_lower = lower;
+        stats->bracket_upper = upper;
+    }
+    const double f_lower = f(lower);
+    const double f_upper = f(upper);
+
+    if (std::isnan(f_lower) || std::isnan(f_upper)) [[unlikely]]
         return unexpected(SolverErrorCode::CANNOT_EVALUATE_VALUE);
+    if (f_lower == 0.0)
+        return lower;
+    if (f_upper == 0.0)
+        return upper;
+    if ((f_lower > 0.0) == (f_upper > 0.0)) [[unlikely]]
+        return unexpected(SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+
+    return brent_solve<with_stats>(f, lower, upper, f_lower, f_upper, stats);
+}
+
+template <bool with_stats, typename Calculator>
+expected<double, SolverErrorCode>
+rate_solver_impl(Calculator & calculator, double guess, const RateBracket * bracket, SolverStats * stats) noexcept
+{
+    using L = RateSolverLimits;
+
+    auto cached_fun = CachedFunction(calculator);
+    const auto [result, newton_iterations] = newton_iterate(cached_fun, guess);
+
+    // newton_iterate returns the point it evaluated last, so this is a cache hit
+    const double residual = cached_fun(result).first;
+    if constexpr (with_stats)
+    {
+        stats->newton_iterations = newton_iterations;
+        stats->residual = residual;
+        stats->bracket_lower = L::lower_bound;
+        stats->bracket_upper = L::upper_bound;
+    }
+    if (std::abs(residual) < L::residual_tolerance)
+        return result;
+
+    // Fallback to a bracketed solve
+    if constexpr (with_stats)
+        stats->used_fallback = true;
+    auto fun = [&calculator](double rate) { return calculator.calculate(rate); };
+
+    if (bracket != nullptr)
+    {
+        // A narrow bracket needs far fewer Brent steps - if it holds a root
+        const double lower = std::max(bracket->lower, L::lower_bound);
+        const double upper = std::min(bracket->upper, L::upper_bound);
+        if (lower < upper)
+        {
+            auto res = bracketed_solve<with_stats>(fun, lower, upper, stats);
+            if (res.has_value())
+                return res;
+        }
     }
-    catch (const boost::math::rounding_error &)
+    return bracketed_solve<with_stats>(fun, L::lower_bound, L::upper_bound, stats);
+}
+
+// Newton kept inside a bracket that shrinks with every evaluation, given that f changes sign at most
+// once: the sign of f(x) tells on which side of the root x is, without evaluating the bracket ends.
+// A step leaving the bracket (or not halving the step before last) is replaced by a bisection. The
+// search bounds are evaluated only before the first bisection (when Newton converges, never) - if f
+// at a bound is on the wrong side of the root, there is provably no root within the bounds.
+template <bool with_stats, typename L = RateSolverLimits, typename Calculator>
+expected<double, SolverErrorCode>
+single_sign_change_solve(Calculator & calculator, double guess, SingleSignChange structure, SolverStats * stats) noexcept
+{
+
+    const bool positive_above = structure.sign_above > 0.0;
+    const auto above_root = [positive_above](double value) { return (value > 0.0) == positive_above; };
+
+    double lo = std::max(structure.lower, L::lower_bound);
+    double hi = L::upper_bound;
+    // Whether the root is known to be above lo / below hi
+    bool lo_known = structure.root_above_lower && structure.lower >= L::lower_bound;
+    bool hi_known = false;
+    double x = std::clamp(guess, lo, hi);
+    double value = std::numeric_limits<double>::quiet_NaN();
+    double step_before_last = hi - lo;
+    double last_step = step_before_last;
+
+    auto record = [&](int32_t iterations)
+    {
+        if constexpr (with_stats)
+        {
+            stats->newton_iterations = iterations;
+            stats->residual = value;
+            stats->bracket_lower = lo;
+            stats->bracket_upper = hi;
+        }
+    };
+
+    for (int32_t iteration = 0; iteration < L::max_iterations; ++iteration)
+    {
+        const auto [fx, derivative] = calculator.calculate_with_derivative(x);
+        value = fx;
+        if (value == 0.0)
+        {
+            record(iteration);
+            return x;
+        }
+        if (std::isnan(value)) [[unlikely]]
+        {
+            record(iteration);
+            return unexpected(SolverErrorCode::CANNOT_EVALUATE_VALUE);
+        }
+        if (above_root(value))
+        {
+            hi = x;
+            hi_known = true;
+        }
+        else
+        {
+            lo = x;
+            lo_known = true;
+        }
+
+        const double delta = value / derivative;
+        if (std::abs(delta) <= L::step_tolerance(x))
+        {
+            record(iteration);
+            return x;
+        }
+
+        double next = x - delta;
+        if (!(next > lo && next < hi) || std::abs(delta) > 0.5 * std::abs(step_before_last))
+        {
+            // Bisection needs the root between lo and hi: check the search bounds not evaluated yet,
+            // the one Newton was heading for first - a root beyond it is rejected right away
+            const bool upper_first = next > x;
+            for (const bool upper : {upper_first, !upper_first})
+            {
+                if (upper ? hi_known : lo_known)
+                    continue;
+                const double bound = upper ? hi : lo;
+                const double f_bound = calculator.calculate(bound);
+                if (f_bound == 0.0)
+                {
+                    record(iteration + 1);
+                    return bound;
+                }
+                if (std::isnan(f_bound) || above_root(f_bound) != upper) [[unlikely]]
+                {
+                    record(iteration + 1);
+                    return unexpected(std::isnan(f_bound) ? SolverErrorCode::CANNOT_EVALUATE_VALUE : SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+                }
+                (upper ? hi_known : lo_known) = true;
+            }
+            next = 0.5 * (lo + hi);
+            if (hi - lo <= 2.0 * L::step_tolerance(next))
+            {
+                record(iteration + 1);
+                return next;
+            }
+        }
+        step_before_last = last_step;
+        last_step = next - x;
+        x = next;
+    }
+
+    record(L::max_iterations);
+    if (std::abs(value) < L::residual_tolerance)
+        return x;
+    return unexpected(SolverErrorCode::CANNOT_CONVERGE_DUE_TO_ROUNDING_ERRORS);
+}
+
+}
+
+// A calculator whose SIMD kernel set is a template parameter of calculate / calculate_with_derivative
+// (NpvCalculator, XnpvCalculator, PreparedXnpvCalculator), pinned to isa instead of simd::compiled_isa
+// - e.g. to the kernels finfunslib picks for the CPU at run time
+template <typename Calculator, simd::Isa isa>
+struct IsaCalculator
+{
+    const Calculator & _calculator;
+
+    template <typename Float>
+    auto calculate(Float rate) const
+    {
+        return _calculator.template calculate<isa>(rate);
+    }
+
+    template <typename Float>
+    auto calculate_with_derivative(Float rate) const
     {
-        return unexpected(SolverErrorCode::CANNOT_CONVERGE_DUE_TO_ROUNDING_ERRORS);
+        return _calculator.template calculate_with_derivative<isa>(rate);
     }
-    catch (const std::domain_error &)
+};
+
+namespace detail
+{
+
+// Tolerances of the low precision pass of a mixed precision solve: ~1e-6
+struct LowPrecisionLimits : RateSolverLimits
+{
+    static constexpr double relative_precision = 0x1p-20;
+    static constexpr double absolute_precision = 0x1p-20;
+
+    static constexpr double step_tolerance(double x) noexcept { return relative_precision * std::abs(x) + absolute_precision; }
+};
+
+// A calculator working in a narrower floating type (e.g. NpvCalculator<float>), evaluated at double rates
+template <typename Calculator>
+struct WideningCalculator
+{
+    const Calculator & _calculator;
+
+    using Float = decltype(std::declval<const Calculator &>().calculate_with_derivative(0.0F).first);
+
+    double calculate(double rate) const { return static_cast<double>(_calculator.calculate(static_cast<Float>(rate))); }
+
+    std::pair<double, double> calculate_with_derivative(double rate) const
     {
-        return unexpected(SolverErrorCode::CANNOT_CONVERGE_DUE_TO_INVALID_ARGUMENTS);
+        const auto [value, derivative] = _calculator.calculate_with_derivative(static_cast<Float>(rate));
+        return {static_cast<double>(value), static_cast<double>(derivative)};
     }
-    catch (...)
+};
+
+// Root of a calculator working in a narrower floating type, as the starting point of a double solve:
+// Newton (bracketed if the root structure is known) with LowPrecisionLimits, without the Brent
+// fallback - that is left to the double solve. nullopt if it fails.
+template <typename Calculator>
+std::optional<double> low_precision_root(
+    const Calculator & calculator, double guess, const std::optional<SingleSignChange> & structure, int32_t & iterations) noexcept
+{
+    auto widened = WideningCalculator<Calculator>{calculator};
+    if (structure)
     {
-        return unexpected(SolverErrorCode::OTHER_ERROR);
+        SolverStats stats;
+        const auto res = single_sign_change_solve<true, LowPrecisionLimits>(widened, guess, *structure, &stats);
+        iterations = stats.newton_iterations;
+        return res.has_value() ? std::optional(res.value()) : std::nullopt;
     }
+
+    auto cached = CachedFunction(widened);
+    const auto [x, newton_iterations] = newton_iterate<LowPrecisionLimits>(cached, guess);
+    iterations = newton_iterations;
+    // newton_iterate returns the point it evaluated last, so this is a cache hit
+    if (!std::isfinite(cached(x).first))
+        return std::nullopt;
+    return x;
+}
+
+}
+
+// Newton-Raphson from guess, falling back to Brent's method on [-0.999999, 100] when Newton does not
+// end on a root. Failures are reported through SolverErrorCode - nothing here throws.
+//
+// If stats is not null it is filled with the diagnostics of the call. Without stats the solve is
+// instantiated without any bookkeeping.
+template <typename Calculator>
+expected<double, SolverErrorCode> rate_solver(Calculator && calculator, double guess, SolverStats * stats = nullptr) noexcept
+{
+    if (stats == nullptr) [[likely]]
+        return detail::rate_solver_impl<false>(calculator, guess, nullptr, nullptr);
+
+    *stats = SolverStats{};
+    auto counting = detail::CountingCalculator<std::remove_reference_t<Calculator>>{calculator, stats->function_evaluations};
+    return detail::rate_solver_impl<true>(counting, guess, nullptr, stats);
+}
+
+// Solve for a function known to change sign at most once (see SingleSignChange): a bracketed Newton
+// iteration, which rejects a root outside [-0.999999, 100] after evaluating just that bound.
+template <typename Calculator>
+expected<double, SolverErrorCode>
+rate_solver(Calculator && calculator, double guess, SingleSignChange structure, SolverStats * stats = nullptr) noexcept
+{
+    if (stats == nullptr) [[likely]]
+        return detail::single_sign_change_solve<false>(calculator, guess, structure, nullptr);
+
+    *stats = SolverStats{};
+    auto counting = detail::CountingCalculator<std::remove_reference_t<Calculator>>{calculator, stats->function_evaluations};
+    return detail::single_sign_change_solve<true>(counting, guess, structure, stats);
+}
+
+// Same, but if Newton fails the bracketed solve tries bracket (clipped to the search bounds) before
+// the full bounds. Meant for warm starts, see warm_start_bracket.
+template <typename Calculator>
+expected<double, SolverErrorCode>
+rate_solver(Calculator && calculator, double guess, RateBracket bracket, SolverStats * stats = nullptr) noexcept
+{
+    if (stats == nullptr) [[likely]]
+        return detail::rate_solver_impl<false>(calculator, guess, &bracket, nullptr);
+
+    *stats = SolverStats{};
+    auto counting = detail::CountingCalculator<std::remove_reference_t<Calculator>>{calculator, stats->function_evaluations};
+    return detail::rate_solver_impl<true>(counting, guess, &bracket, stats);
 }
 
 }
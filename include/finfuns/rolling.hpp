@@ -0,0 +1,268 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/expected.hpp>
+#include <finfuns/irr.hpp>
+#include <finfuns/npv.hpp>
+#include <finfuns/npv_calculator.hpp>
+#include <finfuns/preprocessor.hpp>
+#include <finfuns/rate_solver.hpp>
+#include <finfuns/root_check.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+
+// Window functions: NPV / IRR of every window of `window` consecutive cashflows, i.e. of
+// cashflows[k, k + window) for k = 0 .. cashflows.size() - window, one result per window.
+
+namespace finfuns
+{
+
+// Number of windows (and results) of a rolling computation, 0 if window is 0 or too long
+constexpr std::size_t rolling_window_count(std::size_t n_cashflows, std::size_t window)
+{
+    return window == 0 || window > n_cashflows ? 0 : n_cashflows - window + 1;
+}
+
+// ZeroBased NPV of a window sliding over the cashflows, at a fixed rate > -1.
+//
+// Moving the window by one is O(1): drop the outgoing cashflow, rescale by (1+r) and add the
+// incoming one discounted by v^(window-1). The rescaling also scales up the rounding errors of the
+// previous steps when r > 0, so the NPV is recomputed from scratch after at most window steps, and
+// as soon as the errors could have grown by 2^10. A recompute only sums the prefix of the window
+// discounted by more than 2^-60, extended when the largest cashflow seen so far could make the rest
+// exceed 2^-60 of the discounted |cashflows| of the prefix. By the next recompute the dropped
+// cashflows are still below 2^-50 of the discounted |cashflows| of the window, however much the NPV
+// itself cancels out - like the rounding errors of the steps, relative to the windows since the last
+// recompute (a huge cashflow leaving the window leaves its rounding error behind). The prefix is
+// O(1 / log1p(r)) long (plus O(log(largest / prefix magnitude) / log1p(r))), the same order as the
+// recompute interval - so a step is O(1), amortized, at any rate.
+class SlidingNpv
+{
+public:
+    // Precondition: 0 < window <= cashflows.size(). The setup helpers are out of line, so that the
+    // constructor inlines and the sliding state stays in registers.
+    SlidingNpv(std::span<const double> cashflows, std::size_t window, double rate)
+        : _cashflows{cashflows}
+        , _window{window}
+        , _rate{rate}
+        , _growth{1.0 + rate}
+        , _incoming_discount{std::pow(1.0 + rate, -static_cast<double>(window - 1))}
+        , _recompute_interval{recompute_interval(window, rate)}
+        , _recompute_length{recompute_length(window, rate)}
+        , _largest{_recompute_length < window ? largest_magnitude(cashflows.first(window)) : 0.0}
+        , _tail_factor{_recompute_length < window ? tail_factor(rate, _recompute_length) : 0.0}
+        , _log1p_rate{std::log1p(rate)}
+    {
+        recompute();
+    }
+
+    // NPV of cashflows[position(), position() + window)
+    double value() const { return _npv; }
+    std::size_t position() const { return _begin; }
+
+    // Moves the window by one cashflow, false (and no move) if it already ends at the last cashflow
+    bool advance()
+    {
+        if (_begin + _window >= _cashflows.size())
+            return false;
+        ++_begin;
+        const double incoming = _cashflows[_begin + _window - 1];
+        _largest = std::max(_largest, std::abs(incoming));
+        if (--_steps_left == 0)
+            recompute();
+        else
+            _npv = (_npv - _cashflows[_begin - 1]) * _growth + incoming * _incoming_discount;
+        return true;
+    }
+
+private:
+    static std::size_t recompute_interval(std::size_t window, double rate)
+    {
+        if (rate <= 0.0)
+            return window;
+        const double steps = 10.0 * std::numbers::ln2 / std::log1p(rate);
+        return steps >= static_cast<double>(window) ? window : std::max<std::size_t>(1, static_cast<std::size_t>(steps));
+    }
+
+    // Cashflows of the window discounted by at least 2^-60
+    static std::size_t recompute_length(std::size_t window, double rate)
+    {
+        if (rate <= 0.0)
+            return window;
+        const double length = std::ceil(60.0 * std::numbers::ln2 / std::log1p(rate));
+        return length >= static_cast<double>(window) ? window : static_cast<std::size_t>(length);
+    }
+
+    // max(|cf|) on the bit patterns - an integer max vectorizes, a floating point one does not
+    FINFUNS_NOINLINE static double largest_magnitude(std::span<const double> cashflows)
+    {
+        int64_t largest_bits = 0;
+        for (const double cashflow : cashflows)
+            largest_bits = std::max(largest_bits, std::bit_cast<int64_t>(cashflow) & std::numeric_limits<int64_t>::max());
+        return std::bit_cast<double>(largest_bits);
+    }
+
+    // 2^60 * v^length / (1 - v): discounted, cashflows of at most largest past the first length ones sum
+    // to less than 2^-60 of largest * tail_factor
+    FINFUNS_NOINLINE static double tail_factor(double rate, std::size_t length)
+    {
+        const double v = 1.0 / (1.0 + rate);
+        return std::ldexp(std::pow(v, static_cast<double>(length)) / (1.0 - v), 60);
+    }
+
+    // sum(|cashflows[i]| * v^i), in lanes of independent discounts (a bound only, so their rounding does not matter)
+    static double discounted_magnitude(std::span<const double> cashflows, double v)
+    {
+        constexpr std::size_t lanes = 8;
+        double discounts[lanes];
+        double sums[lanes] = {};
+        discounts[0] = 1.0;
+        for (std::size_t j = 1; j < lanes; ++j)
+            discounts[j] = discounts[j - 1] * v;
+        const double step = discounts[lanes - 1] * v;
+        std::size_t i = 0;
+        for (; i + lanes <= cashflows.size(); i += lanes)
+        {
+            for (std::size_t j = 0; j < lanes; ++j)
+            {
+                sums[j] += std::abs(cashflows[i + j]) * discounts[j];
+                discounts[j] *= step;
+            }
+        }
+        for (std::size_t j = 0; i + j < cashflows.size(); ++j)
+            sums[j] += std::abs(cashflows[i + j]) * discounts[j];
+        double magnitude = 0.0;
+        for (const double sum : sums)
+            magnitude += sum;
+        return magnitude;
+    }
+
+    // Cashflows of the window to sum: the prefix, unless the rest could exceed 2^-60 of the discounted
+    // |cashflows| of the prefix (less than covered) - then longer by the log of the shortfall. Out of
+    // line and on values, like the setup helpers.
+    FINFUNS_NOINLINE static std::size_t
+    covering_length(std::span<const double> prefix, std::size_t window, double v, double covered, double log1p_rate)
+    {
+        const double magnitude = discounted_magnitude(prefix, v);
+        if (magnitude >= covered) [[likely]]
+            return prefix.size();
+        if (!(magnitude > 0.0))
+            return window;
+        const double length = static_cast<double>(prefix.size()) + std::ceil(std::log(covered / magnitude) / log1p_rate);
+        return length >= static_cast<double>(window) ? window : static_cast<std::size_t>(length);
+    }
+
+    void recompute()
+    {
+        const auto prefix = _cashflows.subspan(_begin, _recompute_length);
+        const double covered = _largest * _tail_factor;
+        const std::size_t length
+            = _recompute_length == _window ? _window : covering_length(prefix, _window, 1.0 / _growth, covered, _log1p_rate);
+        _npv = NpvCalculator(_cashflows.subspan(_begin, length)).calculate(_rate);
+        _steps_left = _recompute_interval;
+    }
+
+    std::span<const double> _cashflows;
+    std::size_t _window;
+    double _rate;
+    double _growth;
+    double _incoming_discount;
+    std::size_t _recompute_interval;
+    std::size_t _recompute_length;
+    // If a recompute may not sum the whole window: the rest of the window is at most
+    // _largest * v^_recompute_length / (1 - v), i.e. below 2^-60 of a prefix of at least _largest * _tail_factor
+    double _largest; //!< max(|cashflow|) of the cashflows the windows reached so far
+    double _tail_factor;
+    double _log1p_rate;
+    std::size_t _begin = 0;
+    std::size_t _steps_left = 0;
+    double _npv = 0.0;
+};
+
+// NPV of every window at rate into results (rolling_window_count elements), O(1) per window
+template <IndexMode index_mode>
+expected<void, NPVError> rolling_npv(double rate, std::span<const double> cashflows, std::size_t window, std::span<double> results)
+{
+    if (std::isnan(rate) || std::isinf(rate)) [[unlikely]]
+        return unexpected(NPVError::InvalidRate);
+    if (cashflows.empty()) [[unlikely]]
+        return unexpected(NPVError::EmptyCashflows);
+    const std::size_t n_windows = rolling_window_count(cashflows.size(), window);
+    if (n_windows == 0) [[unlikely]]
+        return unexpected(NPVError::InvalidWindow);
+    if (results.size() != n_windows) [[unlikely]]
+        return unexpected(NPVError::ResultsSizeMismatch);
+
+    // Like NpvCalculator: no discounting is defined at rate <= -1
+    if (rate <= -1.0) [[unlikely]]
+    {
+        std::ranges::fill(results, std::numeric_limits<double>::infinity());
+        return {};
+    }
+
+    const double scale = index_mode == IndexMode::OneBased ? 1.0 / (1.0 + rate) : 1.0;
+    auto sliding = SlidingNpv(cashflows, window, rate);
+    for (std::size_t k = 0; k < n_windows; ++k, sliding.advance())
+        results[k] = sliding.value() * scale;
+    return {};
+}
+
+// IRR of every window into results (rolling_window_count elements).
+//
+// Consecutive windows share all but one cashflow, so every window starts Newton from the root of the
+// previous window (with warm_start_bracket for the bracketed solve); guess is used for the first
+// window and after a failed one. Like batch::irr, failed windows get NaN and are reported through
+// on_error(window_index, code), code being IRRErrorCode or SolverErrorCode.
+template <simd::Isa isa = simd::compiled_isa, typename ErrorSink>
+void rolling_irr(std::span<const double> cashflows, std::size_t window, double guess, std::span<double> results, ErrorSink && on_error)
+{
+    const std::size_t n_windows = rolling_window_count(cashflows.size(), window);
+    double previous = std::numeric_limits<double>::quiet_NaN();
+    for (std::size_t k = 0; k < n_windows; ++k)
+    {
+        const auto window_cashflows = cashflows.subspan(k, window);
+        if (auto error = validate_irr_cashflows(window_cashflows)) [[unlikely]]
+        {
+            results[k] = previous = std::numeric_limits<double>::quiet_NaN();
+            on_error(k, *error);
+            continue;
+        }
+
+        const auto npv_calculator = NpvCalculator(window_cashflows);
+        const auto calculator = IsaCalculator<NpvCalculator<double>, isa>{npv_calculator};
+        auto res = [&]
+        {
+            const double start = std::isfinite(previous) ? previous : guess;
+            if (const auto structure = irr_root_structure(window_cashflows, start))
+                return rate_solver(calculator, start, *structure);
+            if (std::isfinite(previous))
+                return rate_solver(calculator, previous, warm_start_bracket(previous));
+            return rate_solver(calculator, guess);
+        }();
+        if (res.has_value()) [[likely]]
+        {
+            results[k] = previous = res.value();
+        }
+        else
+        {
+            results[k] = previous = std::numeric_limits<double>::quiet_NaN();
+            on_error(k, res.error());
+        }
+    }
+}
+
+}
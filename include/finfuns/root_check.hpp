@@ -0,0 +1,165 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/rate_solver.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <span>
+
+// O(N) pre-solve checks on the number of IRR/XIRR roots.
+//
+// NPV(r) = sum(cf[i] * (1+r)^-t[i]) with non-decreasing t is a (generalized) polynomial in 1/(1+r), so
+// by Descartes' rule of signs it has at most as many roots in (-1, inf) as the cashflows have sign
+// changes. With a single sign change the root, if any, is unique and the sign of NPV on either side
+// of it is known (the sign of the first cashflow above the root, of the last one below it), which lets
+// rate_solver(..., SingleSignChange) bracket the root without any extra evaluation, and reject series
+// whose root lies outside the search bounds after evaluating just one bound.
+//
+// For periodic cashflows with more sign changes, Norstrom's criterion still proves a unique positive
+// root if the running sums of the cashflows change sign exactly once. It says nothing about the roots
+// in (-1, 0), so it is only used for a guess >= 0: a negative guess keeps the unbracketed solve, which
+// may end on a negative root.
+
+namespace finfuns
+{
+
+// Sign changes between consecutive non-zero values
+inline std::size_t count_sign_changes(std::span<const double> values)
+{
+    if (values.empty())
+        return 0;
+
+    // Branch free, vectorizable pass over neighbours - exact unless there are zeros (or NaNs) to skip
+    std::size_t changes = 0;
+    std::size_t zeros = !(values[0] < 0.0 || values[0] > 0.0);
+    for (std::size_t i = 1; i < values.size(); ++i)
+    {
+        const double a = values[i - 1];
+        const double b = values[i];
+        changes += static_cast<std::size_t>((a < 0.0) & (b > 0.0)) + static_cast<std::size_t>((a > 0.0) & (b < 0.0));
+        zeros += static_cast<std::size_t>(!(b < 0.0 || b > 0.0));
+    }
+    if (zeros == 0) [[likely]]
+        return changes;
+
+    changes = 0;
+    int previous = 0;
+    for (const double value : values)
+    {
+        const int sign = (value > 0.0) - (value < 0.0);
+        changes += static_cast<std::size_t>(sign != 0 && previous != 0 && sign != previous);
+        previous = sign != 0 ? sign : previous;
+    }
+    return changes;
+}
+
+// Sign changes of the running sums cf[0], cf[0] + cf[1], ...
+inline std::size_t count_cumulative_sign_changes(std::span<const double> values)
+{
+    std::size_t changes = 0;
+    int previous = 0;
+    double sum = 0.0;
+    for (const double value : values)
+    {
+        sum += value;
+        const int sign = (sum > 0.0) - (sum < 0.0);
+        changes += static_cast<std::size_t>(sign != 0 && previous != 0 && sign != previous);
+        previous = sign != 0 ? sign : previous;
+    }
+    return changes;
+}
+
+namespace detail
+{
+
+inline double first_nonzero_sign(std::span<const double> values)
+{
+    for (const double value : values)
+        if (value != 0.0)
+            return value > 0.0 ? 1.0 : -1.0;
+    return 0.0;
+}
+
+}
+
+// Root structure of NPV(r) for cashflows in time order, nullopt if it cannot be established.
+// Cashflows sharing a date are fine: summing them never adds sign changes.
+inline std::optional<SingleSignChange> descartes_root_structure(std::span<const double> cashflows)
+{
+    if (count_sign_changes(cashflows) != 1)
+        return std::nullopt;
+    // Above the root (r -> inf) the earliest cashflow dominates
+    return SingleSignChange{-1.0, false, detail::first_nonzero_sign(cashflows)};
+}
+
+// Root structure of the periodic NPV of irr(): Descartes' rule, else (for guess >= 0) Norstrom's
+// criterion, which only covers r > 0: f(0) is the sum of the cashflows, opposite in sign to the first
+// cashflow
+inline std::optional<SingleSignChange> irr_root_structure(std::span<const double> cashflows, double guess)
+{
+    const std::size_t sign_changes = count_sign_changes(cashflows);
+    if (sign_changes == 1)
+        return SingleSignChange{-1.0, false, detail::first_nonzero_sign(cashflows)};
+    if (sign_changes > 1 && guess >= 0.0 && cashflows.front() != 0.0 && count_cumulative_sign_changes(cashflows) == 1
+        && std::accumulate(cashflows.begin(), cashflows.end(), 0.0) != 0.0)
+        return SingleSignChange{0.0, true, cashflows.front() > 0.0 ? 1.0 : -1.0};
+    return std::nullopt;
+}
+
+// Root structure of the XNPV of xirr(), in any date order. In time order a single sign change means
+// that all the cashflows of one sign come before all those of the other, which the date range of each
+// sign shows without sorting. Otherwise (e.g. ties across the sign boundary) Descartes' rule if the
+// dates are in order. xirr() passes the year fractions as the dates: they are the exponents, which a
+// 30/360 day count can tie where the dates differ.
+template <typename DateType>
+std::optional<SingleSignChange> xirr_root_structure(std::span<const double> cashflows, std::span<const DateType> dates)
+{
+    // Branch free, vectorizable passes: the date range, then the range of each sign, starting from the opposite end
+    // of the date range (so a sign without cashflows ends up with first > last, unless all the dates
+    // are the same, which no range check below passes anyway)
+    DateType earliest = dates[0];
+    DateType latest = dates[0];
+    for (const DateType date : dates)
+    {
+        earliest = date < earliest ? date : earliest;
+        latest = latest < date ? date : latest;
+    }
+    DateType negative_first = latest;
+    DateType negative_last = earliest;
+    DateType positive_first = latest;
+    DateType positive_last = earliest;
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+    {
+        const DateType date = dates[i];
+        const DateType negative_date_first = cashflows[i] < 0.0 ? date : latest;
+        const DateType negative_date_last = cashflows[i] < 0.0 ? date : earliest;
+        const DateType positive_date_first = cashflows[i] > 0.0 ? date : latest;
+        const DateType positive_date_last = cashflows[i] > 0.0 ? date : earliest;
+        negative_first = negative_date_first < negative_first ? negative_date_first : negative_first;
+        negative_last = negative_last < negative_date_last ? negative_date_last : negative_last;
+        positive_first = positive_date_first < positive_first ? positive_date_first : positive_first;
+        positive_last = positive_last < positive_date_last ? positive_date_last : positive_last;
+    }
+    if (negative_first <= negative_last && positive_first <= positive_last)
+    {
+        // Above the root (r -> inf) the earliest cashflow dominates
+        if (negative_last < positive_first)
+            return SingleSignChange{-1.0, false, -1.0};
+        if (positive_last < negative_first)
+            return SingleSignChange{-1.0, false, 1.0};
+    }
+    if (!std::ranges::is_sorted(dates))
+        return std::nullopt;
+    return descartes_root_structure(cashflows);
+}
+
+}
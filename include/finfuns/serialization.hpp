@@ -0,0 +1,141 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/expected.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Building blocks of the binary format of the aggregate states (IrrState, XirrState).
+//
+// Integers are LEB128 varints and doubles are 8 little endian bytes (IEEE-754 bit pattern),
+// so the format does not depend on the endianness of the machine.
+
+namespace finfuns
+{
+
+enum class SerializationError : int32_t
+{
+    UnsupportedVersion, //!< Written by a newer (or unknown) version of the format
+    UnexpectedEnd, //!< Input ends in the middle of the state
+    InvalidData, //!< Malformed input (bad varint, trailing bytes, inconsistent sizes)
+};
+
+constexpr std::string_view error_to_sv(SerializationError error)
+{
+    switch (error)
+    {
+        case SerializationError::UnsupportedVersion:
+            return "Unsupported serialization format version";
+        case SerializationError::UnexpectedEnd:
+            return "Unexpected end of serialized data";
+        case SerializationError::InvalidData:
+            return "Invalid serialized data";
+        default:
+            return "Unknown serialization error";
+    }
+}
+
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::vector<std::byte> & out)
+        : _out{out}
+    {
+    }
+
+    void write_u8(uint8_t value) { _out.push_back(static_cast<std::byte>(value)); }
+
+    void write_varint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            _out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        _out.push_back(static_cast<std::byte>(value));
+    }
+
+    void write_double(double value)
+    {
+        const auto bits = std::bit_cast<uint64_t>(value);
+        for (int shift = 0; shift < 64; shift += 8)
+            _out.push_back(static_cast<std::byte>((bits >> shift) & 0xFF));
+    }
+
+    void write_varint_signed(int64_t value)
+    {
+        // Zigzag: small negative numbers stay short
+        write_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+private:
+    std::vector<std::byte> & _out;
+};
+
+class BinaryReader
+{
+public:
+    explicit BinaryReader(std::span<const std::byte> in)
+        : _in{in}
+    {
+    }
+
+    std::size_t remaining() const { return _in.size() - _pos; }
+
+    expected<uint8_t, SerializationError> read_u8()
+    {
+        if (remaining() < 1) [[unlikely]]
+            return unexpected(SerializationError::UnexpectedEnd);
+        return static_cast<uint8_t>(_in[_pos++]);
+    }
+
+    expected<uint64_t, SerializationError> read_varint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (remaining() < 1) [[unlikely]]
+                return unexpected(SerializationError::UnexpectedEnd);
+            const auto byte = static_cast<uint8_t>(_in[_pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        return unexpected(SerializationError::InvalidData);
+    }
+
+    expected<int64_t, SerializationError> read_varint_signed()
+    {
+        auto value = read_varint();
+        if (!value.has_value()) [[unlikely]]
+            return unexpected(value.error());
+        return static_cast<int64_t>(*value >> 1) ^ -static_cast<int64_t>(*value & 1);
+    }
+
+    expected<double, SerializationError> read_double()
+    {
+        if (remaining() < 8) [[unlikely]]
+            return unexpected(SerializationError::UnexpectedEnd);
+        uint64_t bits = 0;
+        for (int shift = 0; shift < 64; shift += 8)
+            bits |= static_cast<uint64_t>(static_cast<uint8_t>(_in[_pos++])) << shift;
+        return std::bit_cast<double>(bits);
+    }
+
+private:
+    std::span<const std::byte> _in;
+    std::size_t _pos = 0;
+};
+
+}
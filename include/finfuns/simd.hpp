@@ -0,0 +1,131 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/preprocessor.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace finfuns::simd
+{
+
+enum class Isa : int32_t
+{
+    Scalar, //!< Plain C++ loops
+    Avx2, //!< AVX2 + FMA, 256-bit lanes
+    Avx512, //!< AVX-512F/DQ, 512-bit lanes
+};
+
+constexpr std::string_view isa_to_string(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::Scalar:
+            return "scalar";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+// The best kernel set the current translation unit is compiled for
+#if defined(FINFUNS_X86_SIMD) && defined(__AVX512F__) && defined(__AVX512DQ__)
+inline constexpr Isa compiled_isa = Isa::Avx512;
+#elif defined(FINFUNS_X86_SIMD) && defined(__AVX2__) && defined(__FMA__)
+inline constexpr Isa compiled_isa = Isa::Avx2;
+#else
+inline constexpr Isa compiled_isa = Isa::Scalar;
+#endif
+
+// Whether the CPU we run on can execute kernels built for the given Isa
+inline bool cpu_supports(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::Scalar:
+            return true;
+#ifdef FINFUNS_X86_SIMD
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::Avx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+#endif
+        default:
+            return false;
+    }
+}
+
+#ifdef FINFUNS_VECTOR_EXTENSIONS
+
+// The helpers below are always inlined into target specific kernels, so the ABI of passing
+// wide vectors by value never matters
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wpsabi"
+
+template <typename T, std::size_t W>
+struct VecType
+{
+    typedef T type __attribute__((vector_size(sizeof(T) * W)));
+};
+
+// W lanes of T; the instructions used depend on the target of the function it ends up in
+template <typename T, std::size_t W>
+using Vec = typename VecType<T, W>::type;
+
+template <typename V, typename T>
+FINFUNS_ALWAYS_INLINE V splat(T x)
+{
+    V v;
+    for (std::size_t l = 0; l < sizeof(V) / sizeof(T); ++l)
+        v[l] = x;
+    return v;
+}
+
+template <typename V, typename T>
+FINFUNS_ALWAYS_INLINE V load(const T * p)
+{
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template <typename V, typename T>
+FINFUNS_ALWAYS_INLINE void store(T * p, V v)
+{
+    std::memcpy(p, &v, sizeof(V));
+}
+
+template <typename T, typename V>
+FINFUNS_ALWAYS_INLINE T reduce_add(V v)
+{
+    T sum = 0;
+    for (std::size_t l = 0; l < sizeof(V) / sizeof(T); ++l)
+        sum += v[l];
+    return sum;
+}
+
+// {0, 1, ..., W-1}
+template <typename V, typename T>
+FINFUNS_ALWAYS_INLINE V iota()
+{
+    V v;
+    for (std::size_t l = 0; l < sizeof(V) / sizeof(T); ++l)
+        v[l] = static_cast<T>(l);
+    return v;
+}
+
+#    pragma GCC diagnostic pop
+
+#endif
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace finfuns
+{
+
+// Scratch array of a size known at construction: kept inline up to N elements, on the heap above that.
+// Meant for short lived per-call buffers, so typical inputs don't allocate at all.
+template <typename T, std::size_t N>
+class SmallBuffer
+{
+public:
+    explicit SmallBuffer(std::size_t size)
+        : _size{size}
+    {
+        if (size > N)
+        {
+            _heap = std::make_unique_for_overwrite<T[]>(size);
+            _data = _heap.get();
+        }
+        else
+        {
+            _data = _inline.data();
+        }
+    }
+
+    SmallBuffer(const SmallBuffer &) = delete;
+    SmallBuffer & operator=(const SmallBuffer &) = delete;
+
+    T * data() { return _data; }
+    const T * data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+    std::span<T> span() { return {_data, _size}; }
+    std::span<const T> span() const { return {_data, _size}; }
+
+private:
+    std::size_t _size;
+    T * _data;
+    std::unique_ptr<T[]> _heap;
+    std::array<T, N> _inline;
+};
+
+}
@@ -9,8 +9,14 @@
 
 #include <finfuns/expected.hpp>
 #include <finfuns/rate_solver.hpp>
+#include <finfuns/root_check.hpp>
+#include <finfuns/simd.hpp>
+#include <finfuns/small_buffer.hpp>
 #include <finfuns/xnpv_calculator.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string_view>
 #include <variant>
@@ -50,48 +56,78 @@ constexpr std::string_view error_to_sv(const XIRRError & error)
     return std::visit([](const auto & e) { return error_to_sv(e); }, error);
 }
 
-template <DayCountConvention day_count, typename DateType>
-expected<double, XIRRError> xirr(std::span<const double> cashflows, std::span<const DateType> dates, std::optional<double> guess)
+// Input checks shared by xirr() and the batch kernels
+template <typename DateType>
+std::optional<XIRRErrorCode> validate_xirr_cashflows(std::span<const double> cashflows, std::span<const DateType> dates)
 {
     if (cashflows.size() <= 1) [[unlikely]]
-        return unexpected(XIRRErrorCode::NotEnoughCashflows);
+        return XIRRErrorCode::NotEnoughCashflows;
 
     if (cashflows.size() != dates.size()) [[unlikely]]
-        return unexpected(XIRRErrorCode::CashflowsDatesSizeMismatch);
-
-    bool has_positive = false;
-    bool has_negative = false;
-
-    for (double cf : cashflows)
+        return XIRRErrorCode::CashflowsDatesSizeMismatch;
+
+    // Blocks of branch free (vectorized) sign checks, so that the opposite sign anywhere in unsorted
+    // cashflows is found at the vector rate, while the usual series stop after the first block
+    constexpr std::size_t sign_block = 64;
+    constexpr uint32_t both_signs = 3;
+    uint32_t signs = 0;
+    for (std::size_t begin = 0; begin < cashflows.size() && signs != both_signs; begin += sign_block)
     {
-        if (cf > 0)
-            has_positive = true;
-        if (cf < 0)
-            has_negative = true;
-        if (has_positive && has_negative)
-            break;
+        const std::size_t end = std::min(begin + sign_block, cashflows.size());
+        for (std::size_t i = begin; i < end; ++i)
+            signs |= static_cast<uint32_t>(cashflows[i] > 0) | static_cast<uint32_t>(cashflows[i] < 0) << 1;
     }
-    if (not(has_negative && has_positive)) [[unlikely]]
-        return unexpected(XIRRErrorCode::SameSignCashflows);
+    if (signs != both_signs) [[unlikely]]
+        return XIRRErrorCode::SameSignCashflows;
+    return std::nullopt;
+}
 
-    const double guess_value = guess.value_or(0.1);
-    auto xnpv = XnpvCalculator<DateType, day_count>(cashflows, dates);
+// accuracy selects the exp kernel used by the SIMD paths (ExpAccuracy::Screening trades ~1e-12 relative
+// error per discount factor for speed), unit the unit of integer dates (see DateUnit), isa the kernel
+// set, stats (optional) receives the solver diagnostics, see SolverStats
+template <
+    DayCountConvention day_count,
+    ExpAccuracy accuracy = ExpAccuracy::Full,
+    DateUnit unit = DateUnit::Days,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateType>
+expected<double, XIRRError>
+xirr(std::span<const double> cashflows, std::span<const DateType> dates, std::optional<double> guess, SolverStats * stats = nullptr)
+{
+    if (auto error = validate_xirr_cashflows(cashflows, dates)) [[unlikely]]
+        return unexpected(*error);
 
-    auto res = rate_solver(std::move(xnpv), guess_value);
+    const double guess_value = guess.value_or(0.1);
+    // Year fractions are computed once per solve rather than once per iteration, from the earliest date
+    // as in xnpv(): the sums don't depend on the order of the cashflows, so the dates can come in any order
+    auto times = SmallBuffer<double, 256>(cashflows.size());
+    auto xnpv = XnpvCalculator<DateType, day_count, accuracy, double, unit>(cashflows, dates, earliest_date(dates)).prepare(times.span());
+
+    // A provably unique root goes straight to the bracketed Newton, see root_check.hpp
+    const auto structure = xirr_root_structure(cashflows, xnpv._times);
+    const auto calculator = IsaCalculator<decltype(xnpv), isa>{xnpv};
+    auto res = structure ? rate_solver(calculator, guess_value, *structure, stats) : rate_solver(calculator, guess_value, stats);
     if (res.has_value()) [[likely]]
         return res.value();
     return unexpected(res.error());
 }
 
-template <DayCountConvention day_count, typename DateContainer>
-expected<double, XIRRError> xirr(std::span<const double> cashflows, DateContainer && dates, std::optional<double> guess)
+template <
+    DayCountConvention day_count,
+    ExpAccuracy accuracy = ExpAccuracy::Full,
+    DateUnit unit = DateUnit::Days,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateContainer>
+expected<double, XIRRError>
+xirr(std::span<const double> cashflows, DateContainer && dates, std::optional<double> guess, SolverStats * stats = nullptr)
 {
     using ContainedType = std::remove_cvref_t<decltype(*std::begin(dates))>;
 
-    return xirr<day_count>(
+    return xirr<day_count, accuracy, unit, isa>(
         cashflows,
         std::span<const ContainedType>{dates.data(), static_cast<std::size_t>(std::distance(std::begin(dates), std::end(dates)))},
-        guess);
+        guess,
+        stats);
 }
 
 }
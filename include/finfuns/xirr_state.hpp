@@ -0,0 +1,288 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/day_count.hpp>
+#include <finfuns/expected.hpp>
+#include <finfuns/rate_solver.hpp>
+#include <finfuns/serialization.hpp>
+#include <finfuns/small_buffer.hpp>
+#include <finfuns/xirr.hpp>
+#include <finfuns/xnpv.hpp>
+#include <finfuns/xnpv_calculator.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace finfuns
+{
+
+namespace detail
+{
+
+template <typename DateType>
+constexpr int64_t to_day_number(DateType date)
+{
+    if constexpr (ChronoDayType<DateType>)
+        return std::chrono::duration_cast<std::chrono::days>(date.time_since_epoch()).count();
+    else
+        return static_cast<int64_t>(date);
+}
+
+// nullopt if day is not representable as DateType
+template <typename DateType>
+constexpr std::optional<DateType> from_day_number(int64_t day)
+{
+    if constexpr (ChronoDayType<DateType>)
+    {
+        return DateType{std::chrono::days{day}};
+    }
+    else
+    {
+        if (day < std::numeric_limits<DateType>::min() || day > std::numeric_limits<DateType>::max())
+            return std::nullopt;
+        return static_cast<DateType>(day);
+    }
+}
+
+}
+
+// Streaming, mergeable XIRR/XNPV input - the state of an XIRR aggregate function.
+//
+// (date, cashflow) pairs are kept as a date sorted list with one entry per date: cashflows booked on
+// the same date are summed. Groups with many rows but few distinct dates (daily bookings) thus keep
+// a small state, and the solver walks the distinct dates only.
+//
+// add() in date order appends (or sums into the last entry) in O(1). Out of order pairs go to an
+// unsorted tail, which is sorted and merged into the list once it outgrows it - amortized O(log n)
+// per add(). merge() takes the pairs of another state in any order; as same-date cashflows are added
+// up in a different order, results may differ in the last bits between merge orders.
+//
+// DateType is int (days since epoch) or a std::chrono day type (e.g. std::chrono::sys_days).
+template <typename DateType>
+    requires std::integral<DateType> || ChronoDayType<DateType>
+class XirrState
+{
+public:
+    static constexpr uint8_t serialization_version = 1;
+
+    struct Entry
+    {
+        DateType date;
+        double cashflow;
+    };
+
+    void add(DateType date, double cashflow)
+    {
+        if (_sorted == _entries.size())
+        {
+            if (!_entries.empty() && _entries.back().date == date)
+            {
+                _entries.back().cashflow += cashflow;
+                return;
+            }
+            if (_entries.empty() || _entries.back().date < date)
+            {
+                _entries.push_back({date, cashflow});
+                ++_sorted;
+                return;
+            }
+        }
+        _entries.push_back({date, cashflow});
+        if (_entries.size() - _sorted > std::max(_sorted, min_unsorted_tail))
+            compact(_entries, _sorted);
+    }
+
+    void merge(const XirrState & other)
+    {
+        if (&other == this) [[unlikely]]
+            return merge(XirrState(other));
+        _entries.insert(_entries.end(), other._entries.begin(), other._entries.end());
+        compact(_entries, _sorted);
+    }
+
+    // Number of distinct dates (after compaction)
+    std::size_t size() const
+    {
+        return with_compacted([](std::span<const Entry> entries) { return entries.size(); });
+    }
+
+    // Date sorted, one entry per date
+    std::vector<Entry> entries() const
+    {
+        return with_compacted([](std::span<const Entry> entries) { return std::vector<Entry>(entries.begin(), entries.end()); });
+    }
+
+    // Format (version 1): u8 version, varint entry count, then per entry the date and the cashflow
+    // (double). Dates are days since epoch: the first one as a zigzag varint, the others as the
+    // (positive) varint distance from the previous one.
+    void serialize(std::vector<std::byte> & out) const
+    {
+        with_compacted(
+            [&out](std::span<const Entry> entries)
+            {
+                auto writer = BinaryWriter(out);
+                writer.write_u8(serialization_version);
+                writer.write_varint(entries.size());
+                int64_t previous = 0;
+                for (std::size_t i = 0; i < entries.size(); ++i)
+                {
+                    const int64_t day = detail::to_day_number(entries[i].date);
+                    if (i == 0)
+                        writer.write_varint_signed(day);
+                    else
+                        writer.write_varint(static_cast<uint64_t>(day - previous));
+                    writer.write_double(entries[i].cashflow);
+                    previous = day;
+                }
+            });
+    }
+
+    static expected<XirrState, SerializationError> deserialize(std::span<const std::byte> in)
+    {
+        auto reader = BinaryReader(in);
+        auto version = reader.read_u8();
+        if (!version.has_value()) [[unlikely]]
+            return unexpected(version.error());
+        if (*version != serialization_version) [[unlikely]]
+            return unexpected(SerializationError::UnsupportedVersion);
+
+        auto count = reader.read_varint();
+        if (!count.has_value()) [[unlikely]]
+            return unexpected(count.error());
+        // Every entry takes at least 9 bytes
+        if (*count > reader.remaining() / 9) [[unlikely]]
+            return unexpected(SerializationError::UnexpectedEnd);
+
+        XirrState state;
+        state._entries.reserve(static_cast<std::size_t>(*count));
+        int64_t day = 0;
+        for (uint64_t i = 0; i < *count; ++i)
+        {
+            if (i == 0)
+            {
+                auto first = reader.read_varint_signed();
+                if (!first.has_value()) [[unlikely]]
+                    return unexpected(first.error());
+                day = *first;
+            }
+            else
+            {
+                auto distance = reader.read_varint();
+                if (!distance.has_value()) [[unlikely]]
+                    return unexpected(distance.error());
+                // Dates are strictly increasing
+                if (*distance == 0 || *distance > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() - day)) [[unlikely]]
+                    return unexpected(SerializationError::InvalidData);
+                day += static_cast<int64_t>(*distance);
+            }
+            auto cashflow = reader.read_double();
+            if (!cashflow.has_value()) [[unlikely]]
+                return unexpected(cashflow.error());
+            auto date = detail::from_day_number<DateType>(day);
+            if (!date.has_value()) [[unlikely]]
+                return unexpected(SerializationError::InvalidData);
+            state._entries.push_back({*date, *cashflow});
+        }
+        if (reader.remaining() != 0) [[unlikely]]
+            return unexpected(SerializationError::InvalidData);
+        state._sorted = state._entries.size();
+        return state;
+    }
+
+    // XIRR of the coalesced cashflows - coalescing does not change the XNPV at any rate, so this is
+    // the root xirr() finds over the raw pairs
+    template <DayCountConvention day_count, ExpAccuracy accuracy = ExpAccuracy::Full>
+    expected<double, XIRRError> finalize(std::optional<double> guess, SolverStats * stats = nullptr) const
+    {
+        return with_compacted(
+            [guess, stats](std::span<const Entry> entries) -> expected<double, XIRRError>
+            {
+                const auto n = entries.size();
+                auto cashflows = SmallBuffer<double, 256>(n);
+                auto dates = SmallBuffer<DateType, 256>(n);
+                split(entries, cashflows.span(), dates.span());
+                return xirr<day_count, accuracy>(std::span<const double>(cashflows.span()), std::span<const DateType>(dates.span()), guess, stats);
+            });
+    }
+
+    // XNPV of the coalesced cashflows at rate, discounted to the earliest date
+    template <DayCountConvention day_count>
+    expected<double, XNPVError> finalize_xnpv(double rate) const
+    {
+        return with_compacted(
+            [rate](std::span<const Entry> entries) -> expected<double, XNPVError>
+            {
+                const auto n = entries.size();
+                auto cashflows = SmallBuffer<double, 256>(n);
+                auto dates = SmallBuffer<DateType, 256>(n);
+                split(entries, cashflows.span(), dates.span());
+                return xnpv<day_count>(rate, std::span<const double>(cashflows.span()), std::span<const DateType>(dates.span()));
+            });
+    }
+
+private:
+    // Smallest unsorted tail that triggers a compaction, so short out of order runs don't sort each time
+    static constexpr std::size_t min_unsorted_tail = 256;
+
+    // Sorts the tail entries[sorted..] into the sorted head and sums up same-date cashflows
+    static void compact(std::vector<Entry> & entries, std::size_t & sorted)
+    {
+        if (sorted == entries.size())
+            return;
+        const auto by_date = [](const Entry & a, const Entry & b) { return a.date < b.date; };
+        const auto middle = entries.begin() + static_cast<std::ptrdiff_t>(sorted);
+        std::stable_sort(middle, entries.end(), by_date);
+        std::inplace_merge(entries.begin(), middle, entries.end(), by_date);
+
+        std::size_t out = 0;
+        for (std::size_t i = 1; i < entries.size(); ++i)
+        {
+            if (entries[i].date == entries[out].date)
+                entries[out].cashflow += entries[i].cashflow;
+            else
+                entries[++out] = entries[i];
+        }
+        entries.resize(out + 1);
+        sorted = entries.size();
+    }
+
+    // Calls fn with the compacted entries, copying only if there is an unsorted tail
+    template <typename Fn>
+    decltype(auto) with_compacted(Fn && fn) const
+    {
+        if (_sorted == _entries.size())
+            return fn(std::span<const Entry>(_entries));
+        auto entries = _entries;
+        auto sorted = _sorted;
+        compact(entries, sorted);
+        return fn(std::span<const Entry>(entries));
+    }
+
+    static void split(std::span<const Entry> entries, std::span<double> cashflows, std::span<DateType> dates)
+    {
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            cashflows[i] = entries[i].cashflow;
+            dates[i] = entries[i].date;
+        }
+    }
+
+    std::vector<Entry> _entries;
+    std::size_t _sorted = 0; //!< _entries[0, _sorted) is date sorted with distinct dates
+};
+
+}
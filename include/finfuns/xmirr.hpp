@@ -0,0 +1,156 @@
+#pragma once
+
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/day_count.hpp>
+#include <finfuns/exp_kernels.hpp>
+#include <finfuns/expected.hpp>
+#include <finfuns/mirr.hpp>
+#include <finfuns/mirr_kernels.hpp>
+#include <finfuns/simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+// XMIRR: MIRR over dated cashflows. Cashflow i sits at the year fraction t[i] from dates[0]; the
+// negative ones are discounted to dates[0] at the finance rate, the positive ones compounded at the
+// reinvestment rate to the horizon, the latest of the dates.
+//
+// The year fractions are computed a block at a time into a stack buffer and consumed by the split
+// exp kernel straight away, so cashflows and dates are read once, nothing is allocated and there is
+// one exp per cashflow.
+
+namespace finfuns
+{
+
+enum class XMIRRError : int32_t
+{
+    NotEnoughCashflows, //!< At least two cashflows are required
+    SameSignCashflows, //!< All cashflows have the same sign (all positive or all negative)
+    InvalidRate, //!< finance or reinvestment rate is NaN/infinity or <= -1
+    CashflowsDatesSizeMismatch, //!< cashflows size does not match dates size
+    ZeroHorizon, //!< no date is after the first one
+    UnsupportedDayCountConvention, //!< unsupported day count convention
+};
+
+constexpr std::string_view error_to_sv(XMIRRError error)
+{
+    switch (error)
+    {
+        case XMIRRError::NotEnoughCashflows:
+            return "Not enough cashflows: at least two are required";
+        case XMIRRError::SameSignCashflows:
+            return "All cashflows have the same sign (all positive or all negative)";
+        case XMIRRError::InvalidRate:
+            return "Invalid rate: NaN, infinity or not greater than -1";
+        case XMIRRError::CashflowsDatesSizeMismatch:
+            return "Cashflows and dates arrays must have the same size";
+        case XMIRRError::ZeroHorizon:
+            return "No date is after the first one";
+        case XMIRRError::UnsupportedDayCountConvention:
+            return "Unsupported day count convention";
+        default:
+            return "Unknown XMIRR error";
+    }
+}
+
+// Input checks shared by xmirr() and the batch kernels (the horizon is only known after the pass)
+template <typename DateType>
+std::optional<XMIRRError>
+validate_xmirr_cashflows(std::span<const double> cashflows, std::span<const DateType> dates, double finance_rate, double reinvest_rate)
+{
+    if (!detail::valid_mirr_rate(finance_rate) || !detail::valid_mirr_rate(reinvest_rate)) [[unlikely]]
+        return XMIRRError::InvalidRate;
+    if (cashflows.size() <= 1) [[unlikely]]
+        return XMIRRError::NotEnoughCashflows;
+    if (cashflows.size() != dates.size()) [[unlikely]]
+        return XMIRRError::CashflowsDatesSizeMismatch;
+    if (!detail::has_both_signs(cashflows)) [[unlikely]]
+        return XMIRRError::SameSignCashflows;
+    return std::nullopt;
+}
+
+namespace detail
+{
+
+// Cashflows per block of year fractions
+inline constexpr std::size_t xmirr_block = 64;
+
+// The split discounted sums of validated inputs and the horizon
+template <DayCountConvention day_count, ExpAccuracy accuracy, simd::Isa isa, typename DateType>
+expected<double, XMIRRError> xmirr_unchecked(
+    std::span<const double> cashflows, std::span<const DateType> dates, double finance_rate, double reinvest_rate)
+{
+    const double log_finance = std::log1p(finance_rate);
+    const double log_reinvest = std::log1p(reinvest_rate);
+    const auto year_fraction_from_first = YearFractionFrom<day_count, DateUnit::Days, DateType>(dates[0]);
+
+    alignas(64) double times[xmirr_block];
+    double negative = 0.0;
+    double positive = 0.0;
+    double horizon = 0.0;
+    for (std::size_t begin = 0; begin < cashflows.size(); begin += xmirr_block)
+    {
+        const std::size_t size = std::min(xmirr_block, cashflows.size() - begin);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            times[i] = year_fraction_from_first(dates[begin + i]);
+            horizon = std::max(horizon, times[i]);
+        }
+        const auto [block_negative, block_positive]
+            = split_exp_discounted_sums<isa, accuracy>(cashflows.data() + begin, times, size, log_finance, log_reinvest);
+        negative += block_negative;
+        positive += block_positive;
+    }
+
+    if (!(horizon > 0.0)) [[unlikely]]
+        return unexpected(XMIRRError::ZeroHorizon);
+    return mirr_from_sums(negative, positive, horizon, log_reinvest);
+}
+
+}
+
+// accuracy selects the exp kernel used by the SIMD paths (ExpAccuracy::Screening trades ~1e-12 relative
+// error per discount factor for speed)
+template <
+    DayCountConvention day_count,
+    ExpAccuracy accuracy = ExpAccuracy::Full,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateType>
+expected<double, XMIRRError>
+xmirr(std::span<const double> cashflows, std::span<const DateType> dates, double finance_rate, double reinvest_rate)
+{
+    if (auto error = validate_xmirr_cashflows(cashflows, dates, finance_rate, reinvest_rate)) [[unlikely]]
+        return unexpected(*error);
+    return detail::xmirr_unchecked<day_count, accuracy, isa>(cashflows, dates, finance_rate, reinvest_rate);
+}
+
+template <
+    DayCountConvention day_count,
+    ExpAccuracy accuracy = ExpAccuracy::Full,
+    simd::Isa isa = simd::compiled_isa,
+    typename DateContainer>
+expected<double, XMIRRError> xmirr(std::span<const double> cashflows, DateContainer && dates, double finance_rate, double reinvest_rate)
+{
+    using ContainedType = std::remove_cvref_t<decltype(*std::begin(dates))>;
+
+    return xmirr<day_count, accuracy, isa>(
+        cashflows,
+        std::span<const ContainedType>{dates.data(), static_cast<std::size_t>(std::distance(std::begin(dates), std::end(dates)))},
+        finance_rate,
+        reinvest_rate);
+}
+
+}
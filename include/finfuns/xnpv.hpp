@@ -9,8 +9,10 @@
 
 #include <finfuns/day_count.hpp>
 #include <finfuns/expected.hpp>
+#include <finfuns/simd.hpp>
 #include <finfuns/xnpv_calculator.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <string_view>
@@ -24,6 +26,7 @@ enum class XNPVError : int32_t
     EmptyCashflows, //!< cashflows.empty()
     CashflowsDatesSizeMismatch, //!< cashflows size does not match dates size
     UnsupportedDayCountConvention, //!< unsupported day count convention
+    ResultsSizeMismatch, //!< results size does not match rates size (xnpv_profile)
 };
 
 constexpr std::string_view error_to_sv(XNPVError error)
@@ -38,12 +41,17 @@ constexpr std::string_view error_to_sv(XNPVError error)
             return "Cashflows and dates arrays must have the same size";
         case XNPVError::UnsupportedDayCountConvention:
             return "Unsupported day count convention";
+        case XNPVError::ResultsSizeMismatch:
+            return "Rates and results arrays must have the same size";
         default:
             return "Unknown XNPV error";
     }
 }
 
-template <DayCountConvention day_count, typename DateType>
+// Year fractions are measured from the earliest date (the first one for the dates Excel accepts), as
+// in xirr(), so that xnpv() at the xirr() rate is ~0 in any date order and day count convention.
+// unit: the unit of integer dates, see DateUnit
+template <DayCountConvention day_count, DateUnit unit = DateUnit::Days, simd::Isa isa = simd::compiled_isa, typename DateType>
 expected<double, XNPVError> xnpv(double rate, std::span<const double> cashflows, std::span<const DateType> dates)
 {
     if (std::isnan(rate) || std::isinf(rate)) [[unlikely]]
@@ -52,19 +60,51 @@ expected<double, XNPVError> xnpv(double rate, std::span<const double> cashflows,
         return unexpected(XNPVError::EmptyCashflows);
     if (cashflows.size() != dates.size()) [[unlikely]]
         return unexpected(XNPVError::CashflowsDatesSizeMismatch);
-    auto calc = XnpvCalculator<DateType, day_count>(cashflows, dates);
-    return calc.calculate(rate);
+    auto calc = XnpvCalculator<DateType, day_count, ExpAccuracy::Full, double, unit>(cashflows, dates, earliest_date(dates));
+    return calc.template calculate<isa>(rate);
 }
 
-template <DayCountConvention day_count, typename DateContainer>
+template <DayCountConvention day_count, DateUnit unit = DateUnit::Days, simd::Isa isa = simd::compiled_isa, typename DateContainer>
 expected<double, XNPVError> xnpv(double rate, std::span<const double> cashflows, DateContainer && dates)
 {
     using ContainedType = std::remove_cvref_t<decltype(*std::begin(dates))>;
 
-    return xnpv<day_count>(
+    return xnpv<day_count, unit, isa>(
         rate,
         cashflows,
         std::span<const ContainedType>{dates.data(), static_cast<std::size_t>(std::distance(std::begin(dates), std::end(dates)))});
 }
 
+// XNPV of the cashflows at every rate of rates, results[j] is the XNPV at rates[j].
+// Equivalent to calling xnpv() per rate, but the cashflows are read (and the year fractions computed) once.
+template <DayCountConvention day_count, DateUnit unit = DateUnit::Days, simd::Isa isa = simd::compiled_isa, typename DateType>
+expected<void, XNPVError>
+xnpv_profile(std::span<const double> rates, std::span<const double> cashflows, std::span<const DateType> dates, std::span<double> results)
+{
+    if (std::ranges::any_of(rates, [](double rate) { return std::isnan(rate) || std::isinf(rate); })) [[unlikely]]
+        return unexpected(XNPVError::InvalidRate);
+    if (cashflows.empty()) [[unlikely]]
+        return unexpected(XNPVError::EmptyCashflows);
+    if (cashflows.size() != dates.size()) [[unlikely]]
+        return unexpected(XNPVError::CashflowsDatesSizeMismatch);
+    if (rates.size() != results.size()) [[unlikely]]
+        return unexpected(XNPVError::ResultsSizeMismatch);
+    auto calc = XnpvCalculator<DateType, day_count, ExpAccuracy::Full, double, unit>(cashflows, dates, earliest_date(dates));
+    calc.template calculate_profile<isa>(rates, results);
+    return {};
+}
+
+template <DayCountConvention day_count, DateUnit unit = DateUnit::Days, simd::Isa isa = simd::compiled_isa, typename DateContainer>
+expected<void, XNPVError>
+xnpv_profile(std::span<const double> rates, std::span<const double> cashflows, DateContainer && dates, std::span<double> results)
+{
+    using ContainedType = std::remove_cvref_t<decltype(*std::begin(dates))>;
+
+    return xnpv_profile<day_count, unit, isa>(
+        rates,
+        cashflows,
+        std::span<const ContainedType>{dates.data(), static_cast<std::size_t>(std::distance(std::begin(dates), std::end(dates)))},
+        results);
+}
+
 }
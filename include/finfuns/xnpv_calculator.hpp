@@ -8,39 +8,248 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <finfuns/day_count.hpp>
+#include <finfuns/exp_kernels.hpp>
+#include <finfuns/simd.hpp>
+#include <finfuns/small_buffer.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <concepts>
 #include <expected>
+#include <limits>
 #include <span>
+#include <utility>
 
 namespace finfuns
 {
 
-template <typename DateType, DayCountConvention day_count>
+namespace detail
+{
+
+// Rate profile setup: -log(1+r) per rate and zeroed accumulators (rates <= -1 get 0 and are fixed up
+// by finish_exp_profile)
+inline void start_exp_profile(std::span<const double> rates, std::span<double> minus_log1pr, std::span<double> results)
+{
+    for (size_t j = 0; j < rates.size(); ++j)
+    {
+        minus_log1pr[j] = rates[j] <= -1.0 ? 0.0 : -std::log1p(rates[j]);
+        results[j] = 0.0;
+    }
+}
+
+inline void finish_exp_profile(std::span<const double> rates, std::span<double> results)
+{
+    for (size_t j = 0; j < rates.size(); ++j)
+        if (rates[j] <= -1.0) [[unlikely]]
+            results[j] = std::numeric_limits<double>::infinity();
+}
+
+}
+
+// XNPV over precomputed year fractions (times[i] is the year fraction of cashflows[i]).
+//
+// The year fractions do not depend on the rate, so a solver can compute them once and every
+// iteration becomes a pure exp(-t * log(1+r)) stream - no date arithmetic or int->double
+// conversions in the hot loop.
+//
+// Float: the type the XNPV is computed in (float: twice the SIMD lanes, see NpvCalculator)
+template <ExpAccuracy accuracy = ExpAccuracy::Full, std::floating_point Float = double>
+struct PreparedXnpvCalculator
+{
+    std::span<const Float> _cashflows;
+    std::span<const Float> _times;
+
+    PreparedXnpvCalculator(std::span<const Float> cashflows, std::span<const Float> times)
+        : _cashflows(cashflows)
+        , _times(times)
+    {
+    }
+
+    template <simd::Isa isa = simd::compiled_isa>
+    Float calculate(Float rate) const
+    {
+        if (rate <= -1)
+            return std::numeric_limits<Float>::infinity();
+
+        const Float log1pr = std::log1p(rate);
+        return detail::exp_discounted_sums<isa, accuracy, false>(_cashflows.data(), _times.data(), _cashflows.size(), log1pr).first;
+    }
+
+    template <simd::Isa isa = simd::compiled_isa>
+    std::pair<Float, Float> calculate_with_derivative(Float rate) const
+    {
+        if (rate <= -1)
+            return {std::numeric_limits<Float>::infinity(), std::numeric_limits<Float>::infinity()};
+
+        // d/dr cf * (1+r)^-t = -t * cf * (1+r)^-t / (1+r)
+        const Float log1pr = std::log1p(rate);
+        const auto [npv, weighted]
+            = detail::exp_discounted_sums<isa, accuracy, true>(_cashflows.data(), _times.data(), _cashflows.size(), log1pr);
+        return {npv, -weighted / (1 + rate)};
+    }
+
+    // XNPV at every rate of rates into results (of the same size), streaming the cashflows and year
+    // fractions once in blocks of profile_block_size for all rates
+    template <simd::Isa isa = simd::compiled_isa>
+        requires std::same_as<Float, double>
+    void calculate_profile(std::span<const double> rates, std::span<double> results) const
+    {
+        auto minus_log1pr = SmallBuffer<double, 256>(rates.size());
+        detail::start_exp_profile(rates, minus_log1pr.span(), results);
+        for (size_t begin = 0; begin < _cashflows.size(); begin += profile_block_size)
+        {
+            const size_t n = std::min(profile_block_size, _cashflows.size() - begin);
+            detail::exp_profile<isa, accuracy>(
+                _cashflows.data() + begin, _times.data() + begin, n, minus_log1pr.data(), results.data(), rates.size());
+        }
+        detail::finish_exp_profile(rates, results);
+    }
+
+    // Cashflows + year fractions per block of calculate_profile - 8KB, stays in L1 while all the rates pass over it
+    static constexpr size_t profile_block_size = 512;
+};
+
+// The earliest of the dates, in one branch free (for integer dates vectorized) pass
+template <typename DateType>
+DateType earliest_date(std::span<const DateType> dates)
+{
+    DateType earliest = dates[0];
+    for (const DateType date : dates)
+        earliest = date < earliest ? date : earliest;
+    return earliest;
+}
+
+// Year fractions are measured from the base date: the first date by default, or any anchor, e.g. the
+// earliest date (see earliest_date), which xnpv() and xirr() use so that unsorted dates need no sort -
+// the sums don't depend on the order of the cashflows. The base matters beyond a constant factor for
+// the day counts that are not shift invariant (30/360, ACT/365L).
+//
+// unit: the unit of integer dates (see DateUnit), so that e.g. ClickHouse DateTime columns (seconds) are
+// read as they are
+template <
+    typename DateType,
+    DayCountConvention day_count,
+    ExpAccuracy accuracy = ExpAccuracy::Full,
+    std::floating_point Float = double,
+    DateUnit unit = DateUnit::Days>
 struct XnpvCalculator
 {
-    std::span<const double> _cashflows;
+    // Year fractions are computed in blocks of this size for the SIMD kernels
+    static constexpr size_t block_size = 64;
+
+    std::span<const Float> _cashflows;
     std::span<const DateType> _dates;
+    DateType _base;
+    YearFractionFrom<day_count, unit, DateType> _year_fraction_from; //!< From _base, resolved once
 
-    XnpvCalculator(std::span<const double> cashflows, std::span<const DateType> dates)
+    XnpvCalculator(std::span<const Float> cashflows, std::span<const DateType> dates)
+        : XnpvCalculator(cashflows, dates, dates.empty() ? DateType{} : dates[0])
+    {
+    }
+
+    XnpvCalculator(std::span<const Float> cashflows, std::span<const DateType> dates, DateType base)
         : _cashflows(cashflows)
         , _dates(dates)
+        , _base(base)
+        , _year_fraction_from(base)
+    {
+    }
+
+    template <simd::Isa isa = simd::compiled_isa>
+    Float calculate(Float rate) const
     {
+        if (rate <= -1)
+            return std::numeric_limits<Float>::infinity();
+
+        if constexpr (isa == simd::Isa::Scalar)
+            return calculate_scalar(rate);
+        else
+            return calculate_blocked<isa, false>(rate).first;
     }
 
-    double calculate(double rate) const
+    template <simd::Isa isa = simd::compiled_isa>
+    std::pair<Float, Float> calculate_with_derivative(Float rate) const
     {
-        if (rate <= -1.0)
-            return std::numeric_limits<double>::infinity();
+        if (rate <= -1)
+            return {std::numeric_limits<Float>::infinity(), std::numeric_limits<Float>::infinity()};
 
-        double npv = 0.0;
-        const double one_plus_rate = 1.0 + rate;
-        const double log1pr = std::log(one_plus_rate);
+        if constexpr (isa == simd::Isa::Scalar)
+        {
+            return calculate_with_derivative_scalar(rate);
+        }
+        else
+        {
+            const auto [npv, weighted] = calculate_blocked<isa, true>(rate);
+            return {npv, -weighted / (1 + rate)};
+        }
+    }
+
+    // XNPV at every rate of rates into results (of the same size). The year fractions of a block are
+    // computed once and shared by all rates.
+    template <simd::Isa isa = simd::compiled_isa>
+        requires std::same_as<Float, double>
+    void calculate_profile(std::span<const double> rates, std::span<double> results) const
+    {
+        auto minus_log1pr = SmallBuffer<double, 256>(rates.size());
+        detail::start_exp_profile(rates, minus_log1pr.span(), results);
+        double times[block_size];
+        for (size_t begin = 0; begin < _cashflows.size(); begin += block_size)
+        {
+            const size_t n = std::min(block_size, _cashflows.size() - begin);
+            for (size_t i = 0; i < n; ++i)
+                times[i] = _year_fraction_from(_dates[begin + i]);
+            detail::exp_profile<isa, accuracy>(_cashflows.data() + begin, times, n, minus_log1pr.data(), results.data(), rates.size());
+        }
+        detail::finish_exp_profile(rates, results);
+    }
+
+    // Year fraction of every cashflow, measured from the base date
+    void year_fractions(std::span<Float> times) const
+    {
+        for (size_t i = 0; i < _dates.size(); ++i)
+            times[i] = static_cast<Float>(_year_fraction_from(_dates[i]));
+    }
+
+    // Computes the year fractions into times (caller supplied, at least _cashflows.size() elements)
+    // and returns a calculator evaluating over them
+    PreparedXnpvCalculator<accuracy, Float> prepare(std::span<Float> times) const
+    {
+        year_fractions(times);
+        return PreparedXnpvCalculator<accuracy, Float>(_cashflows, times.first(_cashflows.size()));
+    }
+
+private:
+    // Year fractions of a block go to a stack buffer and then through the SIMD exp kernel
+    template <simd::Isa isa, bool with_derivative>
+    std::pair<Float, Float> calculate_blocked(Float rate) const
+    {
+        const Float log1pr = std::log1p(rate);
+        Float times[block_size];
+        Float npv = 0;
+        Float weighted = 0;
+        for (size_t begin = 0; begin < _cashflows.size(); begin += block_size)
+        {
+            const size_t n = std::min(block_size, _cashflows.size() - begin);
+            for (size_t i = 0; i < n; ++i)
+                times[i] = static_cast<Float>(_year_fraction_from(_dates[begin + i]));
+            const auto [block_npv, block_weighted]
+                = detail::exp_discounted_sums<isa, accuracy, with_derivative>(_cashflows.data() + begin, times, n, log1pr);
+            npv += block_npv;
+            weighted += block_weighted;
+        }
+        return {npv, weighted};
+    }
+
+    Float calculate_scalar(Float rate) const
+    {
+        Float npv = 0;
+        const Float one_plus_rate = 1 + rate;
+        const Float log1pr = std::log(one_plus_rate);
 
         for (size_t i = 0; i < _cashflows.size(); ++i)
         {
-            double time = year_fraction<day_count>(_dates[0], _dates[i]);
-            if (time == 0.0)
+            const auto time = static_cast<Float>(_year_fraction_from(_dates[i]));
+            if (time == 0)
                 npv += _cashflows[i];
             else
                 npv += _cashflows[i] / std::exp(time * log1pr);
@@ -49,26 +258,23 @@ struct XnpvCalculator
         return npv;
     }
 
-    std::pair<double, double> calculate_with_derivative(double rate) const
+    std::pair<Float, Float> calculate_with_derivative_scalar(Float rate) const
     {
-        if (rate <= -1.0)
-            return {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
-
-        double npv = 0.0;
-        double derivative = 0.0;
-        const double one_plus_rate = 1.0 + rate;
-        const double log1pr = std::log(one_plus_rate);
+        Float npv = 0;
+        Float derivative = 0;
+        const Float one_plus_rate = 1 + rate;
+        const Float log1pr = std::log(one_plus_rate);
 
         for (size_t i = 0; i < _cashflows.size(); ++i)
         {
-            double time = year_fraction<day_count>(_dates[0], _dates[i]);
-            if (time == 0.0)
+            const auto time = static_cast<Float>(_year_fraction_from(_dates[i]));
+            if (time == 0)
             {
                 npv += _cashflows[i];
             }
             else
             {
-                const double discount_factor = std::exp(time * log1pr);
+                const Float discount_factor = std::exp(time * log1pr);
                 npv += _cashflows[i] / discount_factor;
                 derivative -= _cashflows[i] * time / (one_plus_rate * discount_factor);
             }
@@ -10,6 +10,7 @@
 
 #include "shared/finfunslib_export.h"
 
+#include <cstddef>
 #include <cstdint>
 
 #ifdef __cplusplus
@@ -85,6 +86,181 @@ FINFUNSLIB_EXPORT double finfuns_fv_due_end(double rate, uint32_t periods, doubl
  */
 FINFUNSLIB_EXPORT double finfuns_fv_due_begin(double rate, uint32_t periods, double pmt, double present_value) noexcept;
 
+// NOLINTBEGIN
+/**
+ * @brief When the payments of an annuity are due
+ */
+typedef enum
+{
+    FINFUNS_DUE_END, ///< Payment at the end of each period
+    FINFUNS_DUE_BEGIN ///< Payment at the beginning of each period
+} FinFunsPaymentDue;
+// NOLINTEND
+
+/**
+ * @brief Calculates the present value (PV) of an annuity for every row of a table
+ *
+ * out_results[i] = PV of rates[i * rates_stride], periods[i * periods_stride], ... - same as
+ * finfuns_pv_due_end / finfuns_pv_due_begin (chosen by the row's due type) up to rounding.
+ * Every input is a column with its own stride in elements: 1 for a contiguous array, 0 to use
+ * the one pointed to value for all rows.
+ *
+ * @param rates Periodic interest rates
+ * @param rates_stride Stride of rates in elements (0 to broadcast)
+ * @param periods Numbers of payment periods
+ * @param periods_stride Stride of periods in elements (0 to broadcast)
+ * @param pmts Payments per period
+ * @param pmts_stride Stride of pmts in elements (0 to broadcast)
+ * @param future_values Future value lump sums
+ * @param future_values_stride Stride of future_values in elements (0 to broadcast)
+ * @param due_types Payment due types (see FinFunsPaymentDue)
+ * @param due_types_stride Stride of due_types in elements (0 to broadcast)
+ * @param n Number of rows
+ * @param[out] out_results PV per row, n elements (NaN for rate <= -1 or an unknown due type)
+ *
+ * @note (1 + rate)^periods is evaluated by SIMD exponentiation by squaring and the special cases
+ *       without branches, so tables mixing zero, invalid and regular rates run at full speed.
+ */
+FINFUNSLIB_EXPORT void finfuns_pv_batch(
+    const double * rates,
+    size_t rates_stride,
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * pmts,
+    size_t pmts_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results) noexcept;
+
+/**
+ * @brief Calculates the future value (FV) of an annuity for every row of a table
+ *
+ * See finfuns_pv_batch; same as finfuns_fv_due_end / finfuns_fv_due_begin per row up to rounding.
+ *
+ * @param rates Periodic interest rates
+ * @param rates_stride Stride of rates in elements (0 to broadcast)
+ * @param periods Numbers of payment periods
+ * @param periods_stride Stride of periods in elements (0 to broadcast)
+ * @param pmts Payments per period
+ * @param pmts_stride Stride of pmts in elements (0 to broadcast)
+ * @param present_values Present value lump sums
+ * @param present_values_stride Stride of present_values in elements (0 to broadcast)
+ * @param due_types Payment due types (see FinFunsPaymentDue)
+ * @param due_types_stride Stride of due_types in elements (0 to broadcast)
+ * @param n Number of rows
+ * @param[out] out_results FV per row, n elements (NaN for rate <= -1 or an unknown due type)
+ */
+FINFUNSLIB_EXPORT void finfuns_fv_batch(
+    const double * rates,
+    size_t rates_stride,
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * pmts,
+    size_t pmts_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results) noexcept;
+
+/**
+ * @brief Calculates the payment per period (PMT) of an annuity
+ *
+ * The payment that turns present_value into future_value after periods payments, same sign
+ * convention as finfuns_pv_due_end: a loan received (present_value > 0) gives a negative payment.
+ *
+ * @param rate           The periodic interest rate (as a decimal, e.g., 0.05 for 5%).
+ * @param periods        The total number of payment periods.
+ * @param present_value  The present value (e.g. the loan amount).
+ * @param future_value   The balance left after the last payment (0 to pay off the loan).
+ * @param due_type       When the payments are due (see FinFunsPaymentDue).
+ *
+ * @return The payment per period (NaN for rate <= -1, periods == 0 or an unknown due type).
+ */
+FINFUNSLIB_EXPORT double
+finfuns_pmt(double rate, uint32_t periods, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept;
+
+/**
+ * @brief Calculates the interest part (IPMT) of payment per of an annuity
+ *
+ * @param rate           The periodic interest rate (as a decimal, e.g., 0.05 for 5%).
+ * @param per            The payment, 1 .. periods.
+ * @param periods        The total number of payment periods.
+ * @param present_value  The present value (e.g. the loan amount).
+ * @param future_value   The balance left after the last payment (0 to pay off the loan).
+ * @param due_type       When the payments are due (see FinFunsPaymentDue).
+ *
+ * @return The interest paid with payment per (NaN if finfuns_pmt is NaN or per is out of range).
+ */
+FINFUNSLIB_EXPORT double finfuns_ipmt(
+    double rate, uint32_t per, uint32_t periods, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept;
+
+/**
+ * @brief Calculates the principal part (PPMT) of payment per of an annuity: finfuns_pmt - finfuns_ipmt
+ *
+ * @param rate           The periodic interest rate (as a decimal, e.g., 0.05 for 5%).
+ * @param per            The payment, 1 .. periods.
+ * @param periods        The total number of payment periods.
+ * @param present_value  The present value (e.g. the loan amount).
+ * @param future_value   The balance left after the last payment (0 to pay off the loan).
+ * @param due_type       When the payments are due (see FinFunsPaymentDue).
+ *
+ * @return The principal repaid with payment per (NaN if finfuns_pmt is NaN or per is out of range).
+ */
+FINFUNSLIB_EXPORT double finfuns_ppmt(
+    double rate, uint32_t per, uint32_t periods, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept;
+
+/**
+ * @brief Calculates the number of periods (NPER) of an annuity
+ *
+ * @param rate           The periodic interest rate (as a decimal, e.g., 0.05 for 5%).
+ * @param pmt            The payment per period.
+ * @param present_value  The present value (e.g. the loan amount).
+ * @param future_value   The balance to reach.
+ * @param due_type       When the payments are due (see FinFunsPaymentDue).
+ *
+ * @return The (generally fractional) number of periods, NaN if the payments never reach future_value,
+ *         rate <= -1 or an unknown due type.
+ */
+FINFUNSLIB_EXPORT double
+finfuns_nper(double rate, double pmt, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept;
+
+/**
+ * @brief Calculates the payment per period (PMT) of an annuity for every row of a table
+ *
+ * See finfuns_pv_batch; same as finfuns_pmt per row up to rounding.
+ *
+ * @param rates Periodic interest rates
+ * @param rates_stride Stride of rates in elements (0 to broadcast)
+ * @param periods Numbers of payment periods
+ * @param periods_stride Stride of periods in elements (0 to broadcast)
+ * @param present_values Present values
+ * @param present_values_stride Stride of present_values in elements (0 to broadcast)
+ * @param future_values Balances left after the last payment
+ * @param future_values_stride Stride of future_values in elements (0 to broadcast)
+ * @param due_types Payment due types (see FinFunsPaymentDue)
+ * @param due_types_stride Stride of due_types in elements (0 to broadcast)
+ * @param n Number of rows
+ * @param[out] out_results Payment per row, n elements (NaN where finfuns_pmt is NaN)
+ */
+FINFUNSLIB_EXPORT void finfuns_pmt_batch(
+    const double * rates,
+    size_t rates_stride,
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results) noexcept;
+
 // NOLINTBEGIN
 /**
  * @brief Error codes for finfuns calculations
@@ -101,8 +277,12 @@ typedef enum
     FINFUNS_CODE_SAME_SIGN_CASHFLOWS, ///< All cashflows have the same sign
     FINFUNS_CODE_INVALID_RATE, ///< Rate is NaN, infinite, or otherwise invalid
     FINFUNS_CODE_EMPTY_CASHFLOWS, ///< No cashflows provided (nullptr or zero length)
-    FINFUNS_CODE_SIZE_MISMATCH, ///< Cashflows/dates size mismatch
+    FINFUNS_CODE_SIZE_MISMATCH, ///< Cashflows/dates (or rates/results) size mismatch
     FINFUNS_CODE_UNSUPPORTED_DAYCOUNT, ///< Unsupported or invalid day count convention
+    FINFUNS_CODE_INVALID_WINDOW, ///< Window is 0 or longer than the cashflows
+    FINFUNS_CODE_INVALID_DUE_TYPE, ///< Payment due type is not a FinFunsPaymentDue
+    FINFUNS_CODE_ZERO_HORIZON, ///< No date is after the first one (XMIRR)
+    FINFUNS_CODE_INVALID_DATE_UNIT, ///< Date unit is not a FinFunsDateUnit
 
     // Numerical errors
     FINFUNS_CODE_CANNOT_EVALUATE_VALUE = 100, ///< Numerical instability during evaluation
@@ -133,6 +313,38 @@ typedef enum
 FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode
 finfuns_irr(const double * cashflows, unsigned num_cashflows, double guess, double * out_result) noexcept;
 
+// NOLINTBEGIN
+/**
+ * @brief Diagnostics of one IRR/XIRR solve
+ */
+typedef struct
+{
+    int32_t newton_iterations; ///< Newton steps taken
+    int32_t bracket_iterations; ///< Bracketed (Brent) steps taken, 0 unless used_fallback
+    int32_t function_evaluations; ///< Number of NPV/XNPV evaluations
+    bool used_fallback; ///< Newton did not converge and the bracketed solver ran
+    double residual; ///< NPV/XNPV at the last point of the solve (NaN if the solver did not run)
+    double bracket_lower; ///< Final bracket lower end (the search bounds if Newton converged)
+    double bracket_upper; ///< Final bracket upper end (the search bounds if Newton converged)
+} FinFunsSolverStats;
+// NOLINTEND
+
+/**
+ * @brief Calculates Internal Rate of Return (IRR) and reports the solver diagnostics
+ *
+ * Same as finfuns_irr, additionally fills out_stats (if not NULL).
+ *
+ * @param cashflows Array of cash flows (must contain at least one negative and one positive value)
+ * @param num_cashflows Number of elements in cashflows array (must be >= 2)
+ * @param guess Initial guess for the IRR (recommended: 0.1 for 10%)
+ * @param[out] out_result Calculated IRR (valid only when return code is FINFUNS_CODE_SUCCESS)
+ * @param[out] out_stats Solver diagnostics (may be NULL), filled also when the solver fails
+ *
+ * @return FinFunsCode error code
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_irr_ex(
+    const double * cashflows, unsigned num_cashflows, double guess, double * out_result, FinFunsSolverStats * out_stats) noexcept;
+
 // NOLINTBEGIN
 /**
  * @brief Time period indexing convention
@@ -170,9 +382,32 @@ typedef enum
 {
     FINFUNS_ACT_365F, ///< Actual days / 365-day year (ISDA)
     FINFUNS_ACT_365_25, ///< Actual days / 365.25-day year (ISDA)
+    FINFUNS_ACT_360, ///< Actual days / 360-day year
+    FINFUNS_ACT_365L, ///< Actual days / 366 if the later date is in a leap year, else / 365
+    FINFUNS_ACT_ACT_ISDA, ///< Days in each calendar year / that year's length (ISDA)
+    FINFUNS_30_360_US, ///< 30/360 US (SIA), with the end of February rules
+    FINFUNS_30E_360, ///< 30E/360 (Eurobond basis)
 } FinFunsDayCount;
 // NOLINTEND
 
+// NOLINTBEGIN
+/**
+ * @brief Unit of integer dates: the count of units since 1970-01-01
+ *
+ * The ClickHouse column encodings are Date (uint16_t days), Date32 (int32_t days), DateTime (uint32_t
+ * seconds) and DateTime64 (int64_t ticks, precision 0, 3, 6 or 9). Date times are counted by the
+ * calendar day they fall on.
+ */
+typedef enum
+{
+    FINFUNS_DATE_DAYS, ///< Days
+    FINFUNS_DATE_SECONDS, ///< Seconds
+    FINFUNS_DATE_MILLISECONDS, ///< Milliseconds
+    FINFUNS_DATE_MICROSECONDS, ///< Microseconds
+    FINFUNS_DATE_NANOSECONDS, ///< Nanoseconds
+} FinFunsDateUnit;
+// NOLINTEND
+
 /**
  * @brief Calculates XNPV with dates as days since epoch (1970-01-01). Could also jus use relative days if the given date convention supports it.
  *
@@ -218,6 +453,654 @@ FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr(
     double guess,
     double * out_result) noexcept;
 
+/**
+ * @brief Calculates XIRR and reports the solver diagnostics
+ *
+ * Same as finfuns_xirr, additionally fills out_stats (if not NULL).
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Array of cash flows (must contain both positive/negative values)
+ * @param dates Array of dates (days since epoch)
+ * @param num_cashflows Length of cashflows array (must be >= 2)
+ * @param guess Initial guess for the rate (suggested: 0.1 for 10%)
+ * @param[out] out_result Calculated XIRR (valid only if return code is SUCCESS)
+ * @param[out] out_stats Solver diagnostics (may be NULL), filled also when the solver fails
+ *
+ * @return FinFunsCode error code
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_ex(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result,
+    FinFunsSolverStats * out_stats) noexcept;
+
+/**
+ * @brief Calculates IRR for many series stored in one flat buffer (columnar layout)
+ *
+ * Row i consists of cashflows[offsets[i - 1] .. offsets[i]) (the first row starts at 0),
+ * i.e. the ClickHouse Array(Float64) offsets layout.
+ *
+ * @param cashflows Flat array of cash flows of all rows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guess Initial guess for the IRR used for every row (recommended: 0.1 for 10%)
+ * @param[out] out_results IRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ */
+FINFUNSLIB_EXPORT void finfuns_irr_batch(
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Calculates XIRR for many series stored in one flat buffer (columnar layout)
+ *
+ * Row i consists of cashflows[offsets[i - 1] .. offsets[i]) and dates[offsets[i - 1] .. offsets[i])
+ * (the first row starts at 0), i.e. the ClickHouse Array offsets layout.
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Flat array of cash flows of all rows
+ * @param dates Flat array of dates (days since epoch), same layout as cashflows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guess Initial guess for the rate used for every row (suggested: 0.1 for 10%)
+ * @param[out] out_results XIRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ *
+ * @return FINFUNS_CODE_SUCCESS if the batch was processed (see out_codes for the per row status),
+ *         FINFUNS_CODE_UNSUPPORTED_DAYCOUNT otherwise, which is then also the code of every row (with a NaN result)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_batch(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Multi-threaded finfuns_irr_batch
+ *
+ * Rows are split into length balanced tasks, which are spread over n_threads threads with work stealing.
+ * Results and codes are identical to finfuns_irr_batch for any thread count.
+ *
+ * @param cashflows Flat array of cash flows of all rows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guess Initial guess for the IRR used for every row (recommended: 0.1 for 10%)
+ * @param[out] out_results IRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ * @param n_threads Number of threads (including the calling one), 0 for the number of hardware threads
+ */
+FINFUNSLIB_EXPORT void finfuns_irr_batch_mt(
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept;
+
+/**
+ * @brief Multi-threaded finfuns_xirr_batch
+ *
+ * Rows are split into length balanced tasks, which are spread over n_threads threads with work stealing.
+ * Results and codes are identical to finfuns_xirr_batch for any thread count.
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Flat array of cash flows of all rows
+ * @param dates Flat array of dates (days since epoch), same layout as cashflows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guess Initial guess for the rate used for every row (suggested: 0.1 for 10%)
+ * @param[out] out_results XIRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ * @param n_threads Number of threads (including the calling one), 0 for the number of hardware threads
+ *
+ * @return FINFUNS_CODE_SUCCESS if the batch was processed (see out_codes for the per row status),
+ *         FINFUNS_CODE_UNSUPPORTED_DAYCOUNT otherwise
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_batch_mt(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept;
+
+/**
+ * @brief finfuns_irr_batch with a warm start guess per row
+ *
+ * Meant for recurring recomputation: pass the previous results as guesses. A row starting from its
+ * own guess typically needs fewer Newton steps, and if Newton fails the bracketed solve first tries
+ * a narrow bracket around the guess. Rows with a NaN guess (e.g. failed last time) start from 0.1.
+ *
+ * @param cashflows Flat array of cash flows of all rows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guesses Initial guess per row, n_rows elements (NaN for no warm start)
+ * @param[out] out_results IRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ * @param n_threads Number of threads (including the calling one), 0 for the number of hardware threads
+ */
+FINFUNSLIB_EXPORT void finfuns_irr_batch_warm(
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    const double * guesses,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept;
+
+/**
+ * @brief finfuns_xirr_batch with a warm start guess per row
+ *
+ * See finfuns_irr_batch_warm.
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Flat array of cash flows of all rows
+ * @param dates Flat array of dates (days since epoch), same layout as cashflows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guesses Initial guess per row, n_rows elements (NaN for no warm start)
+ * @param[out] out_results XIRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ * @param n_threads Number of threads (including the calling one), 0 for the number of hardware threads
+ *
+ * @return FINFUNS_CODE_SUCCESS if the batch was processed (see out_codes for the per row status),
+ *         FINFUNS_CODE_UNSUPPORTED_DAYCOUNT otherwise
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_batch_warm(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    const double * guesses,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept;
+
+/**
+ * @brief finfuns_xnpv over dates in their column encoding (see FinFunsDateUnit)
+ *
+ * The _u16 / _u32 / _i64 variants read e.g. ClickHouse Date, DateTime and DateTime64 columns as they
+ * are, without a conversion copy. Results match finfuns_xnpv over the days of the dates.
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param rate Discount rate (must be >= -1.0 and finite)
+ * @param cashflows Array of cash flows
+ * @param dates Array of dates, unit since epoch
+ * @param unit Unit of the dates (see FinFunsDateUnit)
+ * @param num_cashflows Length of cashflows / dates array
+ * @param[out] out_result Calculated XNPV (valid only if return code is SUCCESS)
+ *
+ * @return FinFunsCode error code (FINFUNS_CODE_INVALID_DATE_UNIT for a bad unit)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xnpv_u16(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const uint16_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result) noexcept;
+
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xnpv_u32(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const uint32_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result) noexcept;
+
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xnpv_i64(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const int64_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result) noexcept;
+
+/**
+ * @brief finfuns_xirr over dates in their column encoding (see finfuns_xnpv_u16)
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Array of cash flows (must contain both positive/negative values)
+ * @param dates Array of dates, unit since epoch
+ * @param unit Unit of the dates (see FinFunsDateUnit)
+ * @param num_cashflows Length of cashflows array (must be >= 2)
+ * @param guess Initial guess for the rate (suggested: 0.1 for 10%)
+ * @param[out] out_result Calculated XIRR (valid only if return code is SUCCESS)
+ *
+ * @return FinFunsCode error code (FINFUNS_CODE_INVALID_DATE_UNIT for a bad unit)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_u16(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint16_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result) noexcept;
+
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_u32(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint32_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result) noexcept;
+
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_i64(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int64_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result) noexcept;
+
+/**
+ * @brief finfuns_xirr_batch over dates in their column encoding (see finfuns_xnpv_u16)
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Flat array of cash flows of all rows
+ * @param dates Flat array of dates (unit since epoch), same layout as cashflows
+ * @param unit Unit of the dates (see FinFunsDateUnit)
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param guess Initial guess for the rate used for every row (suggested: 0.1 for 10%)
+ * @param[out] out_results XIRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ *
+ * @return FINFUNS_CODE_SUCCESS if the batch was processed (see out_codes for the per row status),
+ *         FINFUNS_CODE_UNSUPPORTED_DAYCOUNT or FINFUNS_CODE_INVALID_DATE_UNIT otherwise, which is then also the
+ *         code of every row (with a NaN result)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_batch_u16(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint16_t * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_batch_u32(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint32_t * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xirr_batch_i64(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int64_t * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Calculates the NPV of every window of consecutive cash flows (rolling NPV)
+ *
+ * Window k covers cashflows[k .. k + window), there are num_cashflows - window + 1 windows.
+ * Moving the window costs O(1), independent of the window length.
+ *
+ * @param mode Time period convention (ZeroBased/OneBased), relative to the window start
+ * @param rate Discount rate per period (must be finite)
+ * @param cashflows Array of cash flows
+ * @param num_cashflows Length of cashflows array
+ * @param window Number of cash flows per window (1 .. num_cashflows)
+ * @param[out] out_results NPV per window, num_cashflows - window + 1 elements
+ *
+ * @return FinFunsCode error code (FINFUNS_CODE_INVALID_WINDOW for a bad window length)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_rolling_npv(
+    FinFunsIndexMode mode, double rate, const double * cashflows, size_t num_cashflows, size_t window, double * out_results) noexcept;
+
+/**
+ * @brief Calculates the IRR of every window of consecutive cash flows (rolling IRR)
+ *
+ * Window k covers cashflows[k .. k + window), there are num_cashflows - window + 1 windows.
+ * Every window starts the solver from the previous window's root.
+ *
+ * @param cashflows Array of cash flows
+ * @param num_cashflows Length of cashflows array
+ * @param window Number of cash flows per window (1 .. num_cashflows)
+ * @param guess Initial guess for the first window (and after a failed one), e.g. 0.1
+ * @param[out] out_results IRR per window, num_cashflows - window + 1 elements (NaN for windows that failed)
+ * @param[out] out_codes FinFunsCode per window, num_cashflows - window + 1 elements
+ *
+ * @return FINFUNS_CODE_SUCCESS if the windows were processed (see out_codes for the per window status),
+ *         FINFUNS_CODE_INVALID_WINDOW for a bad window length
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_rolling_irr(
+    const double * cashflows, size_t num_cashflows, size_t window, double guess, double * out_results, FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Calculates the modified internal rate of return (MIRR)
+ *
+ * The negative cashflows are discounted to the start at finance_rate, the positive ones compounded to
+ * the horizon at reinvest_rate, and the MIRR is the rate growing the former into the latter. Both sums
+ * come from one pass over the cashflows; there is no root solve.
+ *
+ * @param[in] mode Time period convention: FINFUNS_ZERO_BASED puts the horizon at num_cashflows - 1
+ *                 (Excel MIRR), FINFUNS_ONE_BASED discounts every cashflow one more period
+ * @param[in] cashflows Array of cash flows (at least one positive and one negative)
+ * @param[in] num_cashflows Number of cash flows (must be >= 2)
+ * @param[in] finance_rate Rate paid on the negative cashflows (finite, > -1)
+ * @param[in] reinvest_rate Rate earned on the positive cashflows (finite, > -1)
+ * @param[out] out_result Calculated MIRR (valid only when return code is FINFUNS_CODE_SUCCESS)
+ *
+ * @return FinFunsCode error code
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_mirr(
+    FinFunsIndexMode mode,
+    const double * cashflows,
+    unsigned num_cashflows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_result) noexcept;
+
+/**
+ * @brief Calculates the modified internal rate of return of dated cashflows (XMIRR)
+ *
+ * Like finfuns_mirr with cashflow i at the year fraction from dates[0] to dates[i]; the horizon is the
+ * latest date. The year fractions are computed in the same pass as the sums, with one exp per cashflow.
+ *
+ * @param[in] day_count Day count convention (see FinFunsDayCount)
+ * @param[in] cashflows Array of cash flows (at least one positive and one negative)
+ * @param[in] dates Dates of the cash flows (days since epoch)
+ * @param[in] num_cashflows Number of cash flows and dates (must be >= 2)
+ * @param[in] finance_rate Rate paid on the negative cashflows (finite, > -1)
+ * @param[in] reinvest_rate Rate earned on the positive cashflows (finite, > -1)
+ * @param[out] out_result Calculated XMIRR (valid only when return code is FINFUNS_CODE_SUCCESS)
+ *
+ * @return FinFunsCode error code (FINFUNS_CODE_ZERO_HORIZON if no date is after dates[0])
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xmirr(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    unsigned num_cashflows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_result) noexcept;
+
+/**
+ * @brief Calculates MIRR for many series stored in one flat buffer (columnar layout)
+ *
+ * Rows are delimited by offsets like in finfuns_irr_batch; every row uses the same rates.
+ *
+ * @param mode Time period convention (see finfuns_mirr)
+ * @param cashflows Flat array of cash flows of all rows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param finance_rate Rate paid on the negative cashflows
+ * @param reinvest_rate Rate earned on the positive cashflows
+ * @param[out] out_results MIRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ */
+FINFUNSLIB_EXPORT void finfuns_mirr_batch(
+    FinFunsIndexMode mode,
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Calculates XMIRR for many series stored in one flat buffer (columnar layout)
+ *
+ * Rows are delimited by offsets like in finfuns_xirr_batch; every row uses the same rates.
+ *
+ * @param day_count Day count convention (see FinFunsDayCount)
+ * @param cashflows Flat array of cash flows of all rows
+ * @param dates Flat array of dates (days since epoch), same layout as cashflows
+ * @param offsets End offset (exclusive) of every row, n_rows elements
+ * @param n_rows Number of rows
+ * @param finance_rate Rate paid on the negative cashflows
+ * @param reinvest_rate Rate earned on the positive cashflows
+ * @param[out] out_results XMIRR per row, n_rows elements (NaN for rows that failed)
+ * @param[out] out_codes FinFunsCode per row, n_rows elements
+ *
+ * @return FINFUNS_CODE_SUCCESS if the batch was processed (see out_codes for the per row status),
+ *         FINFUNS_CODE_UNSUPPORTED_DAYCOUNT otherwise, which is then also the code of every row (with a NaN result)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_xmirr_batch(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Calculates the periodic interest rate (RATE) of an annuity
+ *
+ * The rate at which periods payments of pmt turn present_value into future_value, same sign convention
+ * as finfuns_pmt. Solved by Newton's method on the closed form NPV of the annuity with its analytic
+ * derivative (bracketed when the cashflows change sign once), O(1) per iteration whatever the periods.
+ *
+ * @param periods        The total number of payment periods.
+ * @param pmt            The payment per period.
+ * @param present_value  The present value (e.g. the loan amount).
+ * @param future_value   The balance left after the last payment (0 to pay off the loan).
+ * @param due_type       When the payments are due (see FinFunsPaymentDue).
+ * @param guess          Starting point of the solve, NaN for a closed form estimate (recommended).
+ * @param[out] out_result The periodic rate (valid only when return code is FINFUNS_CODE_SUCCESS)
+ *
+ * @return FinFunsCode error code (FINFUNS_CODE_EMPTY_CASHFLOWS for periods == 0,
+ *         FINFUNS_CODE_SAME_SIGN_CASHFLOWS if pv, pmt and fv all have the same sign)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_rate(
+    uint32_t periods,
+    double pmt,
+    double present_value,
+    double future_value,
+    FinFunsPaymentDue due_type,
+    double guess,
+    double * out_result) noexcept;
+
+/**
+ * @brief Calculates the periodic interest rate (RATE) of an annuity for every row of a table
+ *
+ * The inputs are columns with a stride like in finfuns_pv_batch; every row starts from the closed
+ * form estimate of finfuns_rate.
+ *
+ * @param periods Numbers of payment periods
+ * @param periods_stride Stride of periods in elements (0 to broadcast)
+ * @param pmts Payments per period
+ * @param pmts_stride Stride of pmts in elements (0 to broadcast)
+ * @param present_values Present values
+ * @param present_values_stride Stride of present_values in elements (0 to broadcast)
+ * @param future_values Balances left after the last payment
+ * @param future_values_stride Stride of future_values in elements (0 to broadcast)
+ * @param due_types Payment due types (see FinFunsPaymentDue)
+ * @param due_types_stride Stride of due_types in elements (0 to broadcast)
+ * @param n Number of rows
+ * @param[out] out_results Rate per row, n elements (NaN where the row failed)
+ * @param[out] out_codes FinFunsCode per row, n elements
+ */
+FINFUNSLIB_EXPORT void finfuns_rate_batch(
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * pmts,
+    size_t pmts_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Fills the amortization schedule of a loan
+ *
+ * Period k (0 based) of the schedule is payment k + 1 of finfuns_ipmt / finfuns_ppmt, filled by an
+ * O(periods) recurrence instead of a pow per period.
+ *
+ * @param rate           The periodic interest rate (as a decimal, e.g., 0.05 for 5%).
+ * @param present_value  The loan amount.
+ * @param future_value   The balance left after the last payment (0 to pay off the loan).
+ * @param due_type       When the payments are due (see FinFunsPaymentDue).
+ * @param periods        The number of payment periods.
+ * @param[out] out_interest Interest part of every payment, periods elements
+ * @param[out] out_principal Principal part of every payment, periods elements
+ * @param[out] out_balance Balance after every payment, periods elements
+ * @param[out] out_payment The payment per period (finfuns_pmt)
+ *
+ * @return FinFunsCode error code (FINFUNS_CODE_EMPTY_CASHFLOWS for periods == 0)
+ */
+FINFUNSLIB_EXPORT [[nodiscard]] FinFunsCode finfuns_amortization_schedule(
+    double rate,
+    double present_value,
+    double future_value,
+    FinFunsPaymentDue due_type,
+    size_t periods,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payment) noexcept;
+
+/**
+ * @brief Fills the amortization schedules of many loans stored back to back (columnar layout)
+ *
+ * Loan i fills elements offsets[i - 1] .. offsets[i] of the schedule arrays (the first loan starts
+ * at 0), i.e. the ClickHouse Array offsets layout; the row length is the loan's number of periods.
+ * The loan inputs are columns with a stride like in finfuns_pv_batch.
+ *
+ * @param rates Periodic interest rates
+ * @param rates_stride Stride of rates in elements (0 to broadcast)
+ * @param present_values Loan amounts
+ * @param present_values_stride Stride of present_values in elements (0 to broadcast)
+ * @param future_values Balances left after the last payment
+ * @param future_values_stride Stride of future_values in elements (0 to broadcast)
+ * @param due_types Payment due types (see FinFunsPaymentDue)
+ * @param due_types_stride Stride of due_types in elements (0 to broadcast)
+ * @param offsets End offset (exclusive) of every loan's schedule, n_loans elements
+ * @param n_loans Number of loans
+ * @param[out] out_interest Interest part of every payment, offsets[n_loans - 1] elements
+ * @param[out] out_principal Principal part of every payment, offsets[n_loans - 1] elements
+ * @param[out] out_balance Balance after every payment, offsets[n_loans - 1] elements
+ * @param[out] out_payments Payment per loan, n_loans elements (NaN, like the loan's schedule, if it failed)
+ * @param[out] out_codes FinFunsCode per loan, n_loans elements
+ */
+FINFUNSLIB_EXPORT void finfuns_amortization_schedule_batch(
+    const double * rates,
+    size_t rates_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    const uint64_t * offsets,
+    size_t n_loans,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payments,
+    FinFunsCode * out_codes) noexcept;
+
+/**
+ * @brief Multi-threaded finfuns_amortization_schedule_batch
+ *
+ * Loans are split into length balanced tasks, which are spread over n_threads threads with work stealing.
+ * The output is identical to finfuns_amortization_schedule_batch for any thread count.
+ *
+ * @param rates Periodic interest rates
+ * @param rates_stride Stride of rates in elements (0 to broadcast)
+ * @param present_values Loan amounts
+ * @param present_values_stride Stride of present_values in elements (0 to broadcast)
+ * @param future_values Balances left after the last payment
+ * @param future_values_stride Stride of future_values in elements (0 to broadcast)
+ * @param due_types Payment due types (see FinFunsPaymentDue)
+ * @param due_types_stride Stride of due_types in elements (0 to broadcast)
+ * @param offsets End offset (exclusive) of every loan's schedule, n_loans elements
+ * @param n_loans Number of loans
+ * @param[out] out_interest Interest part of every payment, offsets[n_loans - 1] elements
+ * @param[out] out_principal Principal part of every payment, offsets[n_loans - 1] elements
+ * @param[out] out_balance Balance after every payment, offsets[n_loans - 1] elements
+ * @param[out] out_payments Payment per loan, n_loans elements (NaN, like the loan's schedule, if it failed)
+ * @param[out] out_codes FinFunsCode per loan, n_loans elements
+ * @param n_threads Number of threads (including the calling one), 0 for the number of hardware threads
+ */
+FINFUNSLIB_EXPORT void finfuns_amortization_schedule_batch_mt(
+    const double * rates,
+    size_t rates_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    const uint64_t * offsets,
+    size_t n_loans,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payments,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept;
+
+// NOLINTBEGIN
+/**
+ * @brief SIMD kernel set used by the library
+ *
+ * The library is built for the baseline target and picks the widest kernel set the CPU supports the
+ * first time it is needed (CPUID). Functions without SIMD kernels run the same code on every CPU.
+ */
+typedef enum
+{
+    FINFUNS_ISA_SCALAR, ///< Plain C++ loops
+    FINFUNS_ISA_AVX2, ///< AVX2 + FMA, 256-bit lanes
+    FINFUNS_ISA_AVX512, ///< AVX-512F/DQ, 512-bit lanes
+} FinFunsIsa;
+// NOLINTEND
+
+/**
+ * @brief The SIMD kernel set the library runs on this CPU
+ *
+ * Resolved once per process; npv, xnpv, irr, xirr (single, batch, warm, mt, rolling), mirr, xmirr and
+ * the pv / fv / pmt batches use it.
+ *
+ * @return The FinFunsIsa in use
+ */
+FINFUNSLIB_EXPORT FinFunsIsa finfuns_active_isa() noexcept;
 
 #ifdef __cplusplus
 }
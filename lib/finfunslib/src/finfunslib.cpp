@@ -12,6 +12,10 @@
 #include <finfuns/overloaded.hpp>
 #include <finfuns/preprocessor.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
 #include <utility>
 
 
@@ -45,6 +49,10 @@ FINFUNS_NOINLINE FinFunsCode make_error_code(NPVError err)
             return FINFUNS_CODE_INVALID_RATE;
         case NPVError::EmptyCashflows:
             return FINFUNS_CODE_EMPTY_CASHFLOWS;
+        case NPVError::ResultsSizeMismatch:
+            return FINFUNS_CODE_SIZE_MISMATCH;
+        case NPVError::InvalidWindow:
+            return FINFUNS_CODE_INVALID_WINDOW;
     }
     return FINFUNS_CODE_UNEXPECTED_ERROR;
 }
@@ -61,6 +69,8 @@ FINFUNS_NOINLINE FinFunsCode make_error_code(XNPVError err)
             return FINFUNS_CODE_SIZE_MISMATCH;
         case XNPVError::UnsupportedDayCountConvention:
             return FINFUNS_CODE_UNSUPPORTED_DAYCOUNT;
+        case XNPVError::ResultsSizeMismatch:
+            return FINFUNS_CODE_SIZE_MISMATCH;
     }
     return FINFUNS_CODE_UNEXPECTED_ERROR;
 }
@@ -94,6 +104,347 @@ FINFUNS_NOINLINE FinFunsCode make_error_code(XIRRErrorCode err)
     return FINFUNS_CODE_UNEXPECTED_ERROR;
 }
 
+FINFUNS_NOINLINE FinFunsCode make_error_code(AmortizationError err)
+{
+    switch (err)
+    {
+        case AmortizationError::InvalidRate:
+            return FINFUNS_CODE_INVALID_RATE;
+        case AmortizationError::EmptySchedule:
+            return FINFUNS_CODE_EMPTY_CASHFLOWS;
+        case AmortizationError::ScheduleSizeMismatch:
+            return FINFUNS_CODE_SIZE_MISMATCH;
+        case AmortizationError::InvalidDueType:
+            return FINFUNS_CODE_INVALID_DUE_TYPE;
+    }
+    return FINFUNS_CODE_UNEXPECTED_ERROR;
+}
+
+FINFUNS_NOINLINE FinFunsCode make_error_code(AnnuityRateErrorCode err)
+{
+    switch (err)
+    {
+        case AnnuityRateErrorCode::ZeroPeriods:
+            return FINFUNS_CODE_EMPTY_CASHFLOWS;
+        case AnnuityRateErrorCode::SameSignCashflows:
+            return FINFUNS_CODE_SAME_SIGN_CASHFLOWS;
+        case AnnuityRateErrorCode::InvalidDueType:
+            return FINFUNS_CODE_INVALID_DUE_TYPE;
+    }
+    return FINFUNS_CODE_UNEXPECTED_ERROR;
+}
+
+FINFUNS_NOINLINE FinFunsCode make_error_code(MIRRError err)
+{
+    switch (err)
+    {
+        case MIRRError::NotEnoughCashflows:
+            return FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS;
+        case MIRRError::SameSignCashflows:
+            return FINFUNS_CODE_SAME_SIGN_CASHFLOWS;
+        case MIRRError::InvalidRate:
+            return FINFUNS_CODE_INVALID_RATE;
+    }
+    return FINFUNS_CODE_UNEXPECTED_ERROR;
+}
+
+FINFUNS_NOINLINE FinFunsCode make_error_code(XMIRRError err)
+{
+    switch (err)
+    {
+        case XMIRRError::NotEnoughCashflows:
+            return FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS;
+        case XMIRRError::SameSignCashflows:
+            return FINFUNS_CODE_SAME_SIGN_CASHFLOWS;
+        case XMIRRError::InvalidRate:
+            return FINFUNS_CODE_INVALID_RATE;
+        case XMIRRError::CashflowsDatesSizeMismatch:
+            return FINFUNS_CODE_SIZE_MISMATCH;
+        case XMIRRError::ZeroHorizon:
+            return FINFUNS_CODE_ZERO_HORIZON;
+        case XMIRRError::UnsupportedDayCountConvention:
+            return FINFUNS_CODE_UNSUPPORTED_DAYCOUNT;
+    }
+    return FINFUNS_CODE_UNEXPECTED_ERROR;
+}
+
+void copy_stats(const SolverStats & stats, FinFunsSolverStats * out_stats)
+{
+    if (out_stats == nullptr)
+        return;
+    *out_stats = FinFunsSolverStats{
+        .newton_iterations = stats.newton_iterations,
+        .bracket_iterations = stats.bracket_iterations,
+        .function_evaluations = stats.function_evaluations,
+        .used_fallback = stats.used_fallback,
+        .residual = stats.residual,
+        .bracket_lower = stats.bracket_lower,
+        .bracket_upper = stats.bracket_upper,
+    };
+}
+
+// The widest kernel set the CPU supports, checked (CPUID) on first use
+simd::Isa active_isa()
+{
+    static const simd::Isa isa = []
+    {
+        if (simd::cpu_supports(simd::Isa::Avx512))
+            return simd::Isa::Avx512;
+        if (simd::cpu_supports(simd::Isa::Avx2))
+            return simd::Isa::Avx2;
+        return simd::Isa::Scalar;
+    }();
+    return isa;
+}
+
+// Calls fn.template operator()<isa>() for active_isa(), once per call. The SIMD kernels carry their
+// target attributes (see FINFUNS_TARGET_AVX2), so a library built for the baseline x86-64 target
+// still reaches the AVX2 / AVX-512 ones on the CPUs that have them.
+template <typename Fn>
+decltype(auto) dispatch_isa(Fn && fn)
+{
+#ifdef FINFUNS_X86_SIMD
+    switch (active_isa())
+    {
+        case simd::Isa::Avx512:
+            return fn.template operator()<simd::Isa::Avx512>();
+        case simd::Isa::Avx2:
+            return fn.template operator()<simd::Isa::Avx2>();
+        default:
+            break;
+    }
+#endif
+    return fn.template operator()<simd::Isa::Scalar>();
+}
+
+// Calls fn.template operator()<day_count>() for the runtime day count, once per call (never per
+// cashflow or row); nullopt for a value that is not a FinFunsDayCount
+template <typename Fn>
+auto dispatch_day_count(FinFunsDayCount day_count, Fn && fn)
+{
+    using Result = decltype(fn.template operator()<DayCountConvention::ACT_365F>());
+    switch (day_count)
+    {
+        case FinFunsDayCount::FINFUNS_ACT_365F:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::ACT_365F>());
+        case FinFunsDayCount::FINFUNS_ACT_365_25:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::ACT_365_25>());
+        case FinFunsDayCount::FINFUNS_ACT_360:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::ACT_360>());
+        case FinFunsDayCount::FINFUNS_ACT_365L:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::ACT_365L>());
+        case FinFunsDayCount::FINFUNS_ACT_ACT_ISDA:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::ACT_ACT_ISDA>());
+        case FinFunsDayCount::FINFUNS_30_360_US:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::THIRTY_360_US>());
+        case FinFunsDayCount::FINFUNS_30E_360:
+            return std::optional<Result>(fn.template operator()<DayCountConvention::THIRTY_E_360>());
+        default:
+            [[unlikely]] return std::optional<Result>();
+    }
+}
+
+template <DayCountConvention day_count, DateUnit unit = DateUnit::Days, typename DateType>
+void xirr_batch_impl(
+    const double * cashflows,
+    const DateType * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    const batch::RowGuesses & guesses,
+    double * out_results,
+    FinFunsCode * out_codes,
+    const batch::Executor * executor)
+{
+    const auto n_values = n_rows == 0 ? size_t{0} : static_cast<size_t>(offsets[n_rows - 1]);
+    auto on_error = [out_codes](size_t row, auto e) { out_codes[row] = make_error_code(e); };
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            if (executor != nullptr)
+                batch::xirr<day_count, unit, isa>(
+                    *executor,
+                    std::span(cashflows, n_values),
+                    std::span(dates, n_values),
+                    std::span(offsets, n_rows),
+                    guesses,
+                    std::span(out_results, n_rows),
+                    on_error);
+            else
+                batch::xirr<day_count, unit, isa>(
+                    std::span(cashflows, n_values),
+                    std::span(dates, n_values),
+                    std::span(offsets, n_rows),
+                    guesses,
+                    std::span(out_results, n_rows),
+                    on_error);
+        });
+}
+
+void amortization_schedule_batch_impl(
+    const batch::AmortizationLoans<FinFunsPaymentDue> & loans,
+    const uint64_t * offsets,
+    size_t n_loans,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payments,
+    FinFunsCode * out_codes,
+    const batch::Executor * executor)
+{
+    const auto n_values = n_loans == 0 ? size_t{0} : static_cast<size_t>(offsets[n_loans - 1]);
+    const AmortizationSchedule schedules{
+        std::span(out_interest, n_values), std::span(out_principal, n_values), std::span(out_balance, n_values)};
+    std::fill_n(out_codes, n_loans, FINFUNS_CODE_SUCCESS);
+    auto on_error = [out_codes](size_t row, AmortizationError e) { out_codes[row] = make_error_code(e); };
+    if (executor != nullptr)
+        batch::amortization_schedules(*executor, loans, std::span(offsets, n_loans), schedules, std::span(out_payments, n_loans), on_error);
+    else
+        batch::amortization_schedules(loans, std::span(offsets, n_loans), schedules, std::span(out_payments, n_loans), on_error);
+}
+
+// The code of a batch call: a call rejected as a whole (e.g. an unsupported day count) sets it and a
+// NaN result on every row, which the row kernels never ran on
+FinFunsCode batch_code(FinFunsCode code, size_t n_rows, double * out_results, FinFunsCode * out_codes)
+{
+    if (code != FINFUNS_CODE_SUCCESS) [[unlikely]]
+    {
+        std::fill_n(out_results, n_rows, std::numeric_limits<double>::quiet_NaN());
+        std::fill_n(out_codes, n_rows, code);
+    }
+    return code;
+}
+
+FinFunsCode xirr_batch_dispatch(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    const batch::RowGuesses & guesses,
+    double * out_results,
+    FinFunsCode * out_codes,
+    const batch::Executor * executor)
+{
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    const FinFunsCode code = dispatch_day_count(
+                                 day_count,
+                                 [&]<DayCountConvention dc>()
+                                 {
+                                     xirr_batch_impl<dc>(cashflows, dates, offsets, n_rows, guesses, out_results, out_codes, executor);
+                                     return FINFUNS_CODE_SUCCESS;
+                                 })
+                                 .value_or(FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+    return batch_code(code, n_rows, out_results, out_codes);
+}
+
+// Calls fn.template operator()<day_count, unit>() for the runtime pair, once per call - the date
+// scaling is then compiled into the kernels
+template <DayCountConvention day_count, typename Fn>
+FinFunsCode dispatch_date_unit(FinFunsDateUnit unit, Fn && fn)
+{
+    switch (unit)
+    {
+        case FinFunsDateUnit::FINFUNS_DATE_DAYS:
+            return fn.template operator()<day_count, DateUnit::Days>();
+        case FinFunsDateUnit::FINFUNS_DATE_SECONDS:
+            return fn.template operator()<day_count, DateUnit::Seconds>();
+        case FinFunsDateUnit::FINFUNS_DATE_MILLISECONDS:
+            return fn.template operator()<day_count, DateUnit::Milliseconds>();
+        case FinFunsDateUnit::FINFUNS_DATE_MICROSECONDS:
+            return fn.template operator()<day_count, DateUnit::Microseconds>();
+        case FinFunsDateUnit::FINFUNS_DATE_NANOSECONDS:
+            return fn.template operator()<day_count, DateUnit::Nanoseconds>();
+        default:
+            [[unlikely]] return FINFUNS_CODE_INVALID_DATE_UNIT;
+    }
+}
+
+template <typename Fn>
+FinFunsCode dispatch_date_encoding(FinFunsDayCount day_count, FinFunsDateUnit unit, Fn && fn)
+{
+    return dispatch_day_count(day_count, [&]<DayCountConvention dc>() { return dispatch_date_unit<dc>(unit, fn); })
+        .value_or(FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+}
+
+template <typename DateType>
+FinFunsCode xnpv_native(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const DateType * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result)
+{
+    const auto cf_span = std::span(cashflows, num_cashflows);
+    const auto date_span = std::span(dates, num_cashflows);
+    return dispatch_date_encoding(
+        day_count,
+        unit,
+        [&]<DayCountConvention dc, DateUnit date_unit>()
+        {
+            auto result = dispatch_isa([&]<simd::Isa isa>() { return xnpv<dc, date_unit, isa>(rate, cf_span, date_span); });
+            if (result.has_value()) [[likely]]
+            {
+                *out_result = result.value();
+                return FINFUNS_CODE_SUCCESS;
+            }
+            return make_error_code(result.error());
+        });
+}
+
+template <typename DateType>
+FinFunsCode xirr_native(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const DateType * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result)
+{
+    const auto cf_span = std::span(cashflows, num_cashflows);
+    const auto date_span = std::span(dates, num_cashflows);
+    return dispatch_date_encoding(
+        day_count,
+        unit,
+        [&]<DayCountConvention dc, DateUnit date_unit>()
+        {
+            auto result
+                = dispatch_isa([&]<simd::Isa isa>() { return xirr<dc, ExpAccuracy::Full, date_unit, isa>(cf_span, date_span, guess); });
+            if (result.has_value()) [[likely]]
+            {
+                *out_result = result.value();
+                return FINFUNS_CODE_SUCCESS;
+            }
+            return std::visit([](auto e) { return make_error_code(e); }, result.error());
+        });
+}
+
+template <typename DateType>
+FinFunsCode xirr_batch_native(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const DateType * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes)
+{
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    const FinFunsCode code = dispatch_date_encoding(
+        day_count,
+        unit,
+        [&]<DayCountConvention dc, DateUnit date_unit>()
+        {
+            xirr_batch_impl<dc, date_unit>(cashflows, dates, offsets, n_rows, guess, out_results, out_codes, nullptr);
+            return FINFUNS_CODE_SUCCESS;
+        });
+    return batch_code(code, n_rows, out_results, out_codes);
+}
+
 }
 
 #ifdef __cplusplus
@@ -120,10 +471,166 @@ double finfuns_fv_due_begin(double rate, uint32_t periods, double pmt, double pr
     return fv<PaymentDueType::BeginningOfPeriod>(rate, periods, pmt, present_value);
 }
 
+// The kernels read the C due types by their values
+static_assert(FINFUNS_DUE_END == static_cast<int32_t>(PaymentDueType::EndOfPeriod));
+static_assert(FINFUNS_DUE_BEGIN == static_cast<int32_t>(PaymentDueType::BeginningOfPeriod));
+
+void finfuns_pv_batch(
+    const double * rates,
+    size_t rates_stride,
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * pmts,
+    size_t pmts_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results) noexcept
+{
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            batch::pv<isa>(
+                batch::Column<double>{rates, rates_stride},
+                batch::Column<uint32_t>{periods, periods_stride},
+                batch::Column<double>{pmts, pmts_stride},
+                batch::Column<double>{future_values, future_values_stride},
+                batch::Column<FinFunsPaymentDue>{due_types, due_types_stride},
+                std::span(out_results, n));
+        });
+}
+
+void finfuns_fv_batch(
+    const double * rates,
+    size_t rates_stride,
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * pmts,
+    size_t pmts_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results) noexcept
+{
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            batch::fv<isa>(
+                batch::Column<double>{rates, rates_stride},
+                batch::Column<uint32_t>{periods, periods_stride},
+                batch::Column<double>{pmts, pmts_stride},
+                batch::Column<double>{present_values, present_values_stride},
+                batch::Column<FinFunsPaymentDue>{due_types, due_types_stride},
+                std::span(out_results, n));
+        });
+}
+
+double finfuns_pmt(double rate, uint32_t periods, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept
+{
+    switch (due_type)
+    {
+        case FINFUNS_DUE_END:
+            return pmt<PaymentDueType::EndOfPeriod>(rate, periods, present_value, future_value);
+        case FINFUNS_DUE_BEGIN:
+            return pmt<PaymentDueType::BeginningOfPeriod>(rate, periods, present_value, future_value);
+        default:
+            [[unlikely]] return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+double finfuns_ipmt(
+    double rate, uint32_t per, uint32_t periods, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept
+{
+    switch (due_type)
+    {
+        case FINFUNS_DUE_END:
+            return ipmt<PaymentDueType::EndOfPeriod>(rate, per, periods, present_value, future_value);
+        case FINFUNS_DUE_BEGIN:
+            return ipmt<PaymentDueType::BeginningOfPeriod>(rate, per, periods, present_value, future_value);
+        default:
+            [[unlikely]] return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+double finfuns_ppmt(
+    double rate, uint32_t per, uint32_t periods, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept
+{
+    switch (due_type)
+    {
+        case FINFUNS_DUE_END:
+            return ppmt<PaymentDueType::EndOfPeriod>(rate, per, periods, present_value, future_value);
+        case FINFUNS_DUE_BEGIN:
+            return ppmt<PaymentDueType::BeginningOfPeriod>(rate, per, periods, present_value, future_value);
+        default:
+            [[unlikely]] return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+double finfuns_nper(double rate, double pmt, double present_value, double future_value, FinFunsPaymentDue due_type) noexcept
+{
+    switch (due_type)
+    {
+        case FINFUNS_DUE_END:
+            return nper<PaymentDueType::EndOfPeriod>(rate, pmt, present_value, future_value);
+        case FINFUNS_DUE_BEGIN:
+            return nper<PaymentDueType::BeginningOfPeriod>(rate, pmt, present_value, future_value);
+        default:
+            [[unlikely]] return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+void finfuns_pmt_batch(
+    const double * rates,
+    size_t rates_stride,
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results) noexcept
+{
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            batch::pmt<isa>(
+                batch::Column<double>{rates, rates_stride},
+                batch::Column<uint32_t>{periods, periods_stride},
+                batch::Column<double>{present_values, present_values_stride},
+                batch::Column<double>{future_values, future_values_stride},
+                batch::Column<FinFunsPaymentDue>{due_types, due_types_stride},
+                std::span(out_results, n));
+        });
+}
+
 FinFunsCode finfuns_irr(const double * cashflows, unsigned num_cashflows, double guess, double * out_result) noexcept
 {
     const auto cf_span = std::span<const double>(cashflows, num_cashflows);
-    auto result = irr(cf_span, guess);
+    auto result = dispatch_isa([&]<simd::Isa isa>() { return irr<NpvEvaluation::Discounting, isa>(cf_span, guess); });
+    if (result.has_value()) [[likely]]
+    {
+        *out_result = result.value();
+        return FINFUNS_CODE_SUCCESS;
+    }
+    auto error = result.error();
+    auto error_code = std::visit([](auto e) { return make_error_code(e); }, error);
+    return error_code;
+}
+
+FinFunsCode finfuns_irr_ex(
+    const double * cashflows, unsigned num_cashflows, double guess, double * out_result, FinFunsSolverStats * out_stats) noexcept
+{
+    const auto cf_span = std::span<const double>(cashflows, num_cashflows);
+    SolverStats stats;
+    auto result = dispatch_isa([&]<simd::Isa isa>() { return irr<NpvEvaluation::Discounting, isa>(cf_span, guess, &stats); });
+    copy_stats(stats, out_stats);
     if (result.has_value()) [[likely]]
     {
         *out_result = result.value();
@@ -137,7 +644,9 @@ FinFunsCode finfuns_irr(const double * cashflows, unsigned num_cashflows, double
 FinFunsCode finfuns_npv(FinFunsIndexMode mode, double rate, const double * cashflows, unsigned num_cashflows, double * out_result) noexcept
 {
     const auto cf_span = std::span{cashflows, static_cast<size_t>(num_cashflows)};
-    auto result = (mode == FINFUNS_ZERO_BASED) ? npv<IndexMode::ZeroBased>(rate, cf_span) : npv<IndexMode::OneBased>(rate, cf_span);
+    auto result = dispatch_isa(
+        [&]<simd::Isa isa>()
+        { return (mode == FINFUNS_ZERO_BASED) ? npv<IndexMode::ZeroBased, isa>(rate, cf_span) : npv<IndexMode::OneBased, isa>(rate, cf_span); });
     if (result.has_value()) [[likely]]
     {
         *out_result = result.value();
@@ -157,18 +666,12 @@ FINFUNSLIB_EXPORT FinFunsCode finfuns_xnpv(
 {
     const auto cf_span = std::span(cashflows, num_cashflows);
     const auto date_span = std::span(dates, num_cashflows);
-    auto result = [&]() -> expected<double, XNPVError>
-    {
-        switch (day_count)
+    auto result = dispatch_isa(
+        [&]<simd::Isa isa>()
         {
-            case FinFunsDayCount::FINFUNS_ACT_365F:
-                return xnpv<DayCountConvention::ACT_365F>(rate, cf_span, date_span);
-            case FinFunsDayCount::FINFUNS_ACT_365_25:
-                return xnpv<DayCountConvention::ACT_365_25>(rate, cf_span, date_span);
-            default:
-                [[unlikely]] return unexpected(XNPVError::UnsupportedDayCountConvention);
-        }
-    }();
+            return dispatch_day_count(day_count, [&]<DayCountConvention dc>() { return xnpv<dc, DateUnit::Days, isa>(rate, cf_span, date_span); })
+                .value_or(unexpected(XNPVError::UnsupportedDayCountConvention));
+        });
     if (result.has_value()) [[likely]]
     {
         *out_result = result.value();
@@ -188,18 +691,46 @@ FINFUNSLIB_EXPORT FinFunsCode finfuns_xirr(
 {
     const auto cf_span = std::span(cashflows, num_cashflows);
     const auto date_span = std::span(dates, num_cashflows);
-    auto result = [&]() -> expected<double, XIRRError>
+    auto result = dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            return dispatch_day_count(
+                       day_count,
+                       [&]<DayCountConvention dc>() { return xirr<dc, ExpAccuracy::Full, DateUnit::Days, isa>(cf_span, date_span, guess); })
+                .value_or(unexpected(XIRRErrorCode::UnsupportedDayCountConvention));
+        });
+    if (result.has_value()) [[likely]]
     {
-        switch (day_count)
+        *out_result = result.value();
+        return FINFUNS_CODE_SUCCESS;
+    }
+    auto error = result.error();
+    auto error_code = std::visit([](auto e) { return make_error_code(e); }, error);
+    return error_code;
+}
+
+FINFUNSLIB_EXPORT FinFunsCode finfuns_xirr_ex(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result,
+    FinFunsSolverStats * out_stats) noexcept
+{
+    const auto cf_span = std::span(cashflows, num_cashflows);
+    const auto date_span = std::span(dates, num_cashflows);
+    SolverStats stats;
+    auto result = dispatch_isa(
+        [&]<simd::Isa isa>()
         {
-            case FinFunsDayCount::FINFUNS_ACT_365F:
-                return xirr<DayCountConvention::ACT_365F>(cf_span, date_span, guess);
-            case FinFunsDayCount::FINFUNS_ACT_365_25:
-                return xirr<DayCountConvention::ACT_365_25>(cf_span, date_span, guess);
-            default:
-                [[unlikely]] return unexpected(XIRRErrorCode::UnsupportedDayCountConvention);
-        }
-    }();
+            return dispatch_day_count(
+                       day_count,
+                       [&]<DayCountConvention dc>()
+                       { return xirr<dc, ExpAccuracy::Full, DateUnit::Days, isa>(cf_span, date_span, guess, &stats); })
+                .value_or(unexpected(XIRRErrorCode::UnsupportedDayCountConvention));
+        });
+    copy_stats(stats, out_stats);
     if (result.has_value()) [[likely]]
     {
         *out_result = result.value();
@@ -210,6 +741,521 @@ FINFUNSLIB_EXPORT FinFunsCode finfuns_xirr(
     return error_code;
 }
 
+void finfuns_irr_batch(
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    const auto n_values = n_rows == 0 ? size_t{0} : static_cast<size_t>(offsets[n_rows - 1]);
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            batch::irr<isa>(
+                std::span(cashflows, n_values),
+                std::span(offsets, n_rows),
+                guess,
+                std::span(out_results, n_rows),
+                [out_codes](size_t row, auto e) { out_codes[row] = make_error_code(e); });
+        });
+}
+
+FinFunsCode finfuns_xirr_batch(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    return xirr_batch_dispatch(day_count, cashflows, dates, offsets, n_rows, guess, out_results, out_codes, nullptr);
+}
+
+void finfuns_irr_batch_mt(
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept
+{
+    const auto n_values = n_rows == 0 ? size_t{0} : static_cast<size_t>(offsets[n_rows - 1]);
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            batch::irr<isa>(
+                batch::Executor(n_threads),
+                std::span(cashflows, n_values),
+                std::span(offsets, n_rows),
+                guess,
+                std::span(out_results, n_rows),
+                [out_codes](size_t row, auto e) { out_codes[row] = make_error_code(e); });
+        });
+}
+
+FinFunsCode finfuns_xirr_batch_mt(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept
+{
+    const auto executor = batch::Executor(n_threads);
+    return xirr_batch_dispatch(day_count, cashflows, dates, offsets, n_rows, guess, out_results, out_codes, &executor);
+}
+
+void finfuns_irr_batch_warm(
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    const double * guesses,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept
+{
+    const auto n_values = n_rows == 0 ? size_t{0} : static_cast<size_t>(offsets[n_rows - 1]);
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            batch::irr<isa>(
+                batch::Executor(n_threads),
+                std::span(cashflows, n_values),
+                std::span(offsets, n_rows),
+                batch::RowGuesses(std::span(guesses, n_rows)),
+                std::span(out_results, n_rows),
+                [out_codes](size_t row, auto e) { out_codes[row] = make_error_code(e); });
+        });
+}
+
+FinFunsCode finfuns_xirr_batch_warm(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    const double * guesses,
+    double * out_results,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept
+{
+    const auto executor = batch::Executor(n_threads);
+    return xirr_batch_dispatch(
+        day_count, cashflows, dates, offsets, n_rows, batch::RowGuesses(std::span(guesses, n_rows)), out_results, out_codes, &executor);
+}
+
+FinFunsCode finfuns_xnpv_u16(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const uint16_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result) noexcept
+{
+    return xnpv_native(day_count, rate, cashflows, dates, unit, num_cashflows, out_result);
+}
+
+FinFunsCode finfuns_xnpv_u32(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const uint32_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result) noexcept
+{
+    return xnpv_native(day_count, rate, cashflows, dates, unit, num_cashflows, out_result);
+}
+
+FinFunsCode finfuns_xnpv_i64(
+    FinFunsDayCount day_count,
+    double rate,
+    const double * cashflows,
+    const int64_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double * out_result) noexcept
+{
+    return xnpv_native(day_count, rate, cashflows, dates, unit, num_cashflows, out_result);
+}
+
+FinFunsCode finfuns_xirr_u16(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint16_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result) noexcept
+{
+    return xirr_native(day_count, cashflows, dates, unit, num_cashflows, guess, out_result);
+}
+
+FinFunsCode finfuns_xirr_u32(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint32_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result) noexcept
+{
+    return xirr_native(day_count, cashflows, dates, unit, num_cashflows, guess, out_result);
+}
+
+FinFunsCode finfuns_xirr_i64(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int64_t * dates,
+    FinFunsDateUnit unit,
+    unsigned num_cashflows,
+    double guess,
+    double * out_result) noexcept
+{
+    return xirr_native(day_count, cashflows, dates, unit, num_cashflows, guess, out_result);
+}
+
+FinFunsCode finfuns_xirr_batch_u16(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint16_t * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    return xirr_batch_native(day_count, cashflows, dates, unit, offsets, n_rows, guess, out_results, out_codes);
+}
+
+FinFunsCode finfuns_xirr_batch_u32(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const uint32_t * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    return xirr_batch_native(day_count, cashflows, dates, unit, offsets, n_rows, guess, out_results, out_codes);
+}
+
+FinFunsCode finfuns_xirr_batch_i64(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int64_t * dates,
+    FinFunsDateUnit unit,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double guess,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    return xirr_batch_native(day_count, cashflows, dates, unit, offsets, n_rows, guess, out_results, out_codes);
+}
+
+FinFunsCode finfuns_rolling_npv(
+    FinFunsIndexMode mode, double rate, const double * cashflows, size_t num_cashflows, size_t window, double * out_results) noexcept
+{
+    const auto cf_span = std::span{cashflows, num_cashflows};
+    const auto results = std::span{out_results, rolling_window_count(num_cashflows, window)};
+    auto result = (mode == FINFUNS_ZERO_BASED) ? rolling_npv<IndexMode::ZeroBased>(rate, cf_span, window, results)
+                                               : rolling_npv<IndexMode::OneBased>(rate, cf_span, window, results);
+    if (result.has_value()) [[likely]]
+        return FINFUNS_CODE_SUCCESS;
+    return make_error_code(result.error());
+}
+
+FinFunsCode finfuns_rolling_irr(
+    const double * cashflows, size_t num_cashflows, size_t window, double guess, double * out_results, FinFunsCode * out_codes) noexcept
+{
+    const size_t n_windows = rolling_window_count(num_cashflows, window);
+    if (n_windows == 0) [[unlikely]]
+        return FINFUNS_CODE_INVALID_WINDOW;
+    std::fill_n(out_codes, n_windows, FINFUNS_CODE_SUCCESS);
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            rolling_irr<isa>(
+                std::span{cashflows, num_cashflows},
+                window,
+                guess,
+                std::span{out_results, n_windows},
+                [out_codes](size_t k, auto e) { out_codes[k] = make_error_code(e); });
+        });
+    return FINFUNS_CODE_SUCCESS;
+}
+
+FinFunsCode finfuns_mirr(
+    FinFunsIndexMode mode,
+    const double * cashflows,
+    unsigned num_cashflows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_result) noexcept
+{
+    const auto cf_span = std::span(cashflows, num_cashflows);
+    auto result = dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            return (mode == FINFUNS_ZERO_BASED) ? mirr<IndexMode::ZeroBased, isa>(cf_span, finance_rate, reinvest_rate)
+                                                : mirr<IndexMode::OneBased, isa>(cf_span, finance_rate, reinvest_rate);
+        });
+    if (result.has_value()) [[likely]]
+    {
+        *out_result = result.value();
+        return FINFUNS_CODE_SUCCESS;
+    }
+    return make_error_code(result.error());
+}
+
+FinFunsCode finfuns_xmirr(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    unsigned num_cashflows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_result) noexcept
+{
+    const auto cf_span = std::span(cashflows, num_cashflows);
+    const auto date_span = std::span(dates, num_cashflows);
+    auto result = dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            return dispatch_day_count(
+                       day_count,
+                       [&]<DayCountConvention dc>()
+                       { return xmirr<dc, ExpAccuracy::Full, isa>(cf_span, date_span, finance_rate, reinvest_rate); })
+                .value_or(unexpected(XMIRRError::UnsupportedDayCountConvention));
+        });
+    if (result.has_value()) [[likely]]
+    {
+        *out_result = result.value();
+        return FINFUNS_CODE_SUCCESS;
+    }
+    return make_error_code(result.error());
+}
+
+void finfuns_mirr_batch(
+    FinFunsIndexMode mode,
+    const double * cashflows,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    const auto n_values = n_rows == 0 ? size_t{0} : static_cast<size_t>(offsets[n_rows - 1]);
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    auto on_error = [out_codes](size_t row, MIRRError e) { out_codes[row] = make_error_code(e); };
+    const auto values = std::span(cashflows, n_values);
+    const auto row_offsets = std::span(offsets, n_rows);
+    const auto results = std::span(out_results, n_rows);
+    dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            if (mode == FINFUNS_ZERO_BASED)
+                batch::mirr<IndexMode::ZeroBased, isa>(values, row_offsets, finance_rate, reinvest_rate, results, on_error);
+            else
+                batch::mirr<IndexMode::OneBased, isa>(values, row_offsets, finance_rate, reinvest_rate, results, on_error);
+        });
+}
+
+FinFunsCode finfuns_xmirr_batch(
+    FinFunsDayCount day_count,
+    const double * cashflows,
+    const int * dates,
+    const uint64_t * offsets,
+    size_t n_rows,
+    double finance_rate,
+    double reinvest_rate,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    const auto n_values = n_rows == 0 ? size_t{0} : static_cast<size_t>(offsets[n_rows - 1]);
+    std::fill_n(out_codes, n_rows, FINFUNS_CODE_SUCCESS);
+    auto on_error = [out_codes](size_t row, XMIRRError e) { out_codes[row] = make_error_code(e); };
+    const auto values = std::span(cashflows, n_values);
+    const auto date_values = std::span(dates, n_values);
+    const auto row_offsets = std::span(offsets, n_rows);
+    const auto results = std::span(out_results, n_rows);
+    const FinFunsCode code = dispatch_isa(
+        [&]<simd::Isa isa>()
+        {
+            return dispatch_day_count(
+                       day_count,
+                       [&]<DayCountConvention dc>()
+                       {
+                           batch::xmirr<dc, ExpAccuracy::Full, isa>(
+                               values, date_values, row_offsets, finance_rate, reinvest_rate, results, on_error);
+                           return FINFUNS_CODE_SUCCESS;
+                       })
+                .value_or(FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+        });
+    return batch_code(code, n_rows, out_results, out_codes);
+}
+
+FinFunsCode finfuns_rate(
+    uint32_t periods,
+    double pmt,
+    double present_value,
+    double future_value,
+    FinFunsPaymentDue due_type,
+    double guess,
+    double * out_result) noexcept
+{
+    const auto solve = [&]<PaymentDueType due>()
+    {
+        const double start = std::isnan(guess) ? detail::annuity_rate_guess<due>(periods, pmt, present_value, future_value) : guess;
+        return rate<due>(periods, pmt, present_value, future_value, start);
+    };
+    expected<double, AnnuityRateError> res = unexpected(AnnuityRateErrorCode::InvalidDueType);
+    switch (due_type)
+    {
+        case FINFUNS_DUE_END:
+            res = solve.template operator()<PaymentDueType::EndOfPeriod>();
+            break;
+        case FINFUNS_DUE_BEGIN:
+            res = solve.template operator()<PaymentDueType::BeginningOfPeriod>();
+            break;
+        default:
+            break;
+    }
+    if (!res.has_value()) [[unlikely]]
+        return std::visit([](auto e) { return make_error_code(e); }, res.error());
+    *out_result = res.value();
+    return FINFUNS_CODE_SUCCESS;
+}
+
+void finfuns_rate_batch(
+    const uint32_t * periods,
+    size_t periods_stride,
+    const double * pmts,
+    size_t pmts_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    size_t n,
+    double * out_results,
+    FinFunsCode * out_codes) noexcept
+{
+    std::fill_n(out_codes, n, FINFUNS_CODE_SUCCESS);
+    batch::rate(
+        batch::Column<uint32_t>{periods, periods_stride},
+        batch::Column<double>{pmts, pmts_stride},
+        batch::Column<double>{present_values, present_values_stride},
+        batch::Column<double>{future_values, future_values_stride},
+        batch::Column<FinFunsPaymentDue>{due_types, due_types_stride},
+        std::span(out_results, n),
+        [out_codes](size_t row, const AnnuityRateError & e) { out_codes[row] = std::visit([](auto err) { return make_error_code(err); }, e); });
+}
+
+FinFunsCode finfuns_amortization_schedule(
+    double rate,
+    double present_value,
+    double future_value,
+    FinFunsPaymentDue due_type,
+    size_t periods,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payment) noexcept
+{
+    const AmortizationSchedule schedule{
+        std::span(out_interest, periods), std::span(out_principal, periods), std::span(out_balance, periods)};
+    expected<double, AmortizationError> res = unexpected(AmortizationError::InvalidDueType);
+    switch (due_type)
+    {
+        case FINFUNS_DUE_END:
+            res = amortization_schedule<PaymentDueType::EndOfPeriod>(rate, present_value, future_value, schedule);
+            break;
+        case FINFUNS_DUE_BEGIN:
+            res = amortization_schedule<PaymentDueType::BeginningOfPeriod>(rate, present_value, future_value, schedule);
+            break;
+        default:
+            break;
+    }
+    if (!res.has_value()) [[unlikely]]
+        return make_error_code(res.error());
+    *out_payment = res.value();
+    return FINFUNS_CODE_SUCCESS;
+}
+
+void finfuns_amortization_schedule_batch(
+    const double * rates,
+    size_t rates_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    const uint64_t * offsets,
+    size_t n_loans,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payments,
+    FinFunsCode * out_codes) noexcept
+{
+    const batch::AmortizationLoans<FinFunsPaymentDue> loans{
+        {rates, rates_stride}, {present_values, present_values_stride}, {future_values, future_values_stride}, {due_types, due_types_stride}};
+    amortization_schedule_batch_impl(loans, offsets, n_loans, out_interest, out_principal, out_balance, out_payments, out_codes, nullptr);
+}
+
+void finfuns_amortization_schedule_batch_mt(
+    const double * rates,
+    size_t rates_stride,
+    const double * present_values,
+    size_t present_values_stride,
+    const double * future_values,
+    size_t future_values_stride,
+    const FinFunsPaymentDue * due_types,
+    size_t due_types_stride,
+    const uint64_t * offsets,
+    size_t n_loans,
+    double * out_interest,
+    double * out_principal,
+    double * out_balance,
+    double * out_payments,
+    FinFunsCode * out_codes,
+    unsigned n_threads) noexcept
+{
+    const batch::AmortizationLoans<FinFunsPaymentDue> loans{
+        {rates, rates_stride}, {present_values, present_values_stride}, {future_values, future_values_stride}, {due_types, due_types_stride}};
+    const batch::Executor executor(n_threads);
+    amortization_schedule_batch_impl(loans, offsets, n_loans, out_interest, out_principal, out_balance, out_payments, out_codes, &executor);
+}
+
+static_assert(FINFUNS_ISA_SCALAR == static_cast<int32_t>(simd::Isa::Scalar));
+static_assert(FINFUNS_ISA_AVX2 == static_cast<int32_t>(simd::Isa::Avx2));
+static_assert(FINFUNS_ISA_AVX512 == static_cast<int32_t>(simd::Isa::Avx512));
+
+FinFunsIsa finfuns_active_isa() noexcept
+{
+    return dispatch_isa([]<simd::Isa isa>() { return static_cast<FinFunsIsa>(isa); });
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,7 +6,10 @@
 //  1.0. (See accompanying file LICENSE_1_0.txt or copy at
 //  http://www.boost.org/LICENSE_1_0.txt)
 
+#include <finfuns/day_count.hpp>
+
 #include <chrono>
+#include <cstdint>
 #include <span>
 #include <vector>
 
@@ -28,3 +31,26 @@ struct IntDates
         return result;
     }
 };
+
+// Dates in an integer column encoding (see finfuns::DateUnit), time_of_day units past midnight
+template <typename T, finfuns::DateUnit date_unit, int64_t time_of_day = 0>
+struct EncodedDates
+{
+    using type = T;
+    static constexpr finfuns::DateUnit unit = date_unit;
+
+    static constexpr std::vector<T> process(std::span<const std::chrono::sys_days> dates)
+    {
+        std::vector<T> result;
+        result.reserve(dates.size());
+        for (const auto & date : dates)
+            result.push_back(static_cast<T>(date.time_since_epoch().count() * finfuns::units_per_day(date_unit) + time_of_day));
+        return result;
+    }
+};
+
+// ClickHouse Date, DateTime and DateTime64(3 / 9), the date times at 23:59:59
+using Date16 = EncodedDates<uint16_t, finfuns::DateUnit::Days>;
+using DateTime32 = EncodedDates<uint32_t, finfuns::DateUnit::Seconds, 86'399>;
+using DateTime64Ms = EncodedDates<int64_t, finfuns::DateUnit::Milliseconds, 86'399'000>;
+using DateTime64Ns = EncodedDates<int64_t, finfuns::DateUnit::Nanoseconds, 86'399'000'000'000>;
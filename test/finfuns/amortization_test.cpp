@@ -0,0 +1,92 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/amortization.hpp>
+#include <finfuns/ipmt.hpp>
+#include <finfuns/pmt.hpp>
+
+#include <doctest/doctest.h>
+
+#include <limits>
+#include <vector>
+
+using namespace finfuns;
+
+namespace
+{
+
+struct Buffers
+{
+    explicit Buffers(std::size_t periods)
+        : interest(periods)
+        , principal(periods)
+        , balance(periods)
+    {
+    }
+
+    AmortizationSchedule schedule() { return {interest, principal, balance}; }
+
+    std::vector<double> interest;
+    std::vector<double> principal;
+    std::vector<double> balance;
+};
+
+template <PaymentDueType due_type>
+void check_schedule(double rate, uint32_t periods, double present_value, double future_value)
+{
+    CAPTURE(rate);
+    CAPTURE(periods);
+    Buffers buffers(periods);
+    const auto payment = amortization_schedule<due_type>(rate, present_value, future_value, buffers.schedule());
+    REQUIRE(payment.has_value());
+    CHECK(payment.value() == pmt<due_type>(rate, periods, present_value, future_value));
+
+    for (uint32_t k = 0; k < periods; ++k)
+    {
+        CAPTURE(k);
+        const double interest = ipmt<due_type>(rate, k + 1, periods, present_value, future_value);
+        const double principal = ppmt<due_type>(rate, k + 1, periods, present_value, future_value);
+        // Absolute tolerances: the parts cross 0 on loans with a large future value
+        CHECK(buffers.interest[k] == doctest::Approx(interest).epsilon(1e-9).scale(present_value));
+        CHECK(buffers.principal[k] == doctest::Approx(principal).epsilon(1e-9).scale(present_value));
+        CHECK(buffers.interest[k] + buffers.principal[k] == doctest::Approx(payment.value()).epsilon(1e-12));
+    }
+    const double last = due_type == PaymentDueType::EndOfPeriod ? -future_value : -future_value / (1.0 + rate);
+    CHECK(buffers.balance.back() == doctest::Approx(last).epsilon(1e-9).scale(present_value));
+}
+
+}
+
+TEST_CASE("amortization_schedule")
+{
+    for (const double rate : {0.0, 1e-9, 0.035 / 12, 0.1, -0.01})
+    {
+        check_schedule<PaymentDueType::EndOfPeriod>(rate, 360, 250000.0, 0.0);
+        check_schedule<PaymentDueType::BeginningOfPeriod>(rate, 360, 250000.0, 0.0);
+        check_schedule<PaymentDueType::EndOfPeriod>(rate, 60, 30000.0, -12000.0);
+        check_schedule<PaymentDueType::BeginningOfPeriod>(rate, 1, 1000.0, 0.0);
+    }
+}
+
+TEST_CASE("amortization_schedule_errors")
+{
+    Buffers buffers(12);
+    CHECK(
+        amortization_schedule<PaymentDueType::EndOfPeriod>(-1.0, 1000.0, 0.0, buffers.schedule()).error()
+        == AmortizationError::InvalidRate);
+    CHECK(
+        amortization_schedule<PaymentDueType::EndOfPeriod>(std::numeric_limits<double>::quiet_NaN(), 1000.0, 0.0, buffers.schedule()).error()
+        == AmortizationError::InvalidRate);
+
+    Buffers empty(0);
+    CHECK(amortization_schedule<PaymentDueType::EndOfPeriod>(0.01, 1000.0, 0.0, empty.schedule()).error() == AmortizationError::EmptySchedule);
+
+    auto mismatch = buffers.schedule();
+    mismatch.balance = mismatch.balance.first(11);
+    CHECK(amortization_schedule<PaymentDueType::EndOfPeriod>(0.01, 1000.0, 0.0, mismatch).error() == AmortizationError::ScheduleSizeMismatch);
+    CHECK_FALSE(error_to_sv(AmortizationError::ScheduleSizeMismatch).empty());
+}
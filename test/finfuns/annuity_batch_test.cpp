@@ -0,0 +1,383 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/annuity_batch.hpp>
+#include <finfuns/batch_executor.hpp>
+#include <finfuns/fv.hpp>
+#include <finfuns/pmt.hpp>
+#include <finfuns/pv.hpp>
+#include <finfuns/rate.hpp>
+
+#include "../test_data.hpp"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace finfuns;
+
+namespace
+{
+
+struct Table
+{
+    std::vector<double> rates;
+    std::vector<uint32_t> periods;
+    std::vector<double> pmts;
+    std::vector<double> values;
+    std::vector<PaymentDueType> dues;
+};
+
+// Loan table rows with every special case mixed in: zero and tiny rates, rate <= -1, NaN, zero periods
+Table make_table(std::size_t n)
+{
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> rate_dist(-0.05, 0.25);
+    std::uniform_int_distribution<uint32_t> periods_dist(0, 480);
+    std::uniform_real_distribution<double> amount_dist(-5000.0, 5000.0);
+    const double specials[] = {0.0, -1.0, -1.5, std::numeric_limits<double>::quiet_NaN(), 1e-12};
+
+    Table table;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        table.rates.push_back(i % 7 == 3 ? specials[(i / 7) % 5] : rate_dist(rng));
+        table.periods.push_back(periods_dist(rng));
+        table.pmts.push_back(amount_dist(rng));
+        table.values.push_back(amount_dist(rng));
+        table.dues.push_back(i % 3 == 0 ? PaymentDueType::BeginningOfPeriod : PaymentDueType::EndOfPeriod);
+    }
+    return table;
+}
+
+enum class Function
+{
+    Pv,
+    Fv,
+    Pmt,
+};
+
+// pv / fv / pmt in long double, from log1p / expm1 so that rates close to 0 lose nothing, and the size
+// of the two terms (the scale for the comparison, as they may cancel)
+struct Reference
+{
+    double value;
+    double scale;
+};
+
+Reference reference(Function function, PaymentDueType due, double rate, uint32_t periods, double amount, double value)
+{
+    if (!(rate > -1.0) || (function == Function::Pmt && periods == 0))
+        return {std::numeric_limits<double>::quiet_NaN(), 0.0};
+    const long double n = periods;
+    const long double due_factor = due == PaymentDueType::BeginningOfPeriod ? 1.0L + rate : 1.0L;
+    if (function == Function::Pmt)
+    {
+        if (rate == 0.0)
+            return {static_cast<double>(-(amount + value) / n), static_cast<double>((std::abs(amount) + std::abs(value)) / n)};
+        const long double r = rate;
+        const long double growth = std::expm1(n * std::log1p(r));
+        const long double interest = -r * amount / due_factor;
+        const long double repayment = -r * (amount + value) / growth / due_factor;
+        return {static_cast<double>(interest + repayment), static_cast<double>(std::abs(interest) + std::abs(repayment))};
+    }
+    if (rate == 0.0)
+        return {static_cast<double>(-amount * n - value), static_cast<double>(std::abs(amount) * n + std::abs(value))};
+
+    const bool future_value = function == Function::Fv;
+    const long double r = rate;
+    const long double log_growth = n * std::log1p(r);
+    const long double factor = future_value ? std::exp(log_growth) : std::exp(-log_growth);
+    const long double growth = future_value ? std::expm1(log_growth) : -std::expm1(-log_growth);
+    const long double annuity = -amount * growth / r * due_factor;
+    const long double lump = value * factor;
+    return {static_cast<double>(annuity - lump), static_cast<double>(std::abs(annuity) + std::abs(lump))};
+}
+
+void check_close(double result, const Reference & expected)
+{
+    if (std::isnan(expected.value))
+        CHECK(std::isnan(result));
+    else
+        CHECK(std::abs(result - expected.value) <= 1e-13 * expected.scale);
+}
+
+template <simd::Isa isa>
+void check_against_reference()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    CAPTURE(simd::isa_to_string(isa));
+    // Lengths around the lane widths exercise the partial last block
+    for (const std::size_t n : {1u, 3u, 4u, 7u, 8u, 9u, 17u, 1000u})
+    {
+        CAPTURE(n);
+        const auto t = make_table(n);
+        std::vector<double> pv_results(n);
+        std::vector<double> fv_results(n);
+        std::vector<double> pmt_results(n);
+        batch::pv<isa>(
+            batch::column<double>(t.rates),
+            batch::column<uint32_t>(t.periods),
+            batch::column<double>(t.pmts),
+            batch::column<double>(t.values),
+            batch::column<PaymentDueType>(t.dues),
+            pv_results);
+        batch::fv<isa>(
+            batch::column<double>(t.rates),
+            batch::column<uint32_t>(t.periods),
+            batch::column<double>(t.pmts),
+            batch::column<double>(t.values),
+            batch::column<PaymentDueType>(t.dues),
+            fv_results);
+        // pmts / values as the present / future values
+        batch::pmt<isa>(
+            batch::column<double>(t.rates),
+            batch::column<uint32_t>(t.periods),
+            batch::column<double>(t.pmts),
+            batch::column<double>(t.values),
+            batch::column<PaymentDueType>(t.dues),
+            pmt_results);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            CAPTURE(i);
+            CAPTURE(t.rates[i]);
+            check_close(pv_results[i], reference(Function::Pv, t.dues[i], t.rates[i], t.periods[i], t.pmts[i], t.values[i]));
+            check_close(fv_results[i], reference(Function::Fv, t.dues[i], t.rates[i], t.periods[i], t.pmts[i], t.values[i]));
+            check_close(pmt_results[i], reference(Function::Pmt, t.dues[i], t.rates[i], t.periods[i], t.pmts[i], t.values[i]));
+        }
+    }
+}
+
+// All cases of test_data.hpp as one batch
+template <typename TestData, typename Batch>
+void check_test_data(const std::vector<TestData> & cases, double TestData::*amount, double TestData::*value, Batch run)
+{
+    std::vector<double> rates;
+    std::vector<uint32_t> periods;
+    std::vector<double> pmts;
+    std::vector<double> values;
+    std::vector<PaymentDueType> dues;
+    for (const auto & test : cases)
+    {
+        rates.push_back(test.rate);
+        periods.push_back(test.periods);
+        pmts.push_back(test.*amount);
+        values.push_back(test.*value);
+        dues.push_back(test.mode);
+    }
+
+    std::vector<double> results(cases.size());
+    run(batch::column<double>(rates),
+        batch::column<uint32_t>(periods),
+        batch::column<double>(pmts),
+        batch::column<double>(values),
+        batch::column<PaymentDueType>(dues),
+        results);
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        CAPTURE(cases[i].id);
+        if (std::isnan(cases[i].expected_result))
+            CHECK(std::isnan(results[i]));
+        else
+            CHECK(results[i] == doctest::Approx(cases[i].expected_result).epsilon(1e-6));
+    }
+}
+
+}
+
+TEST_CASE("annuity_batch_test_data")
+{
+    check_test_data(test::pv::pv_cases, &test::pv::TestData::pmt, &test::pv::TestData::fv, &batch::pv<simd::compiled_isa, PaymentDueType>);
+    check_test_data(test::fv::fv_cases, &test::fv::TestData::pmt, &test::fv::TestData::pv, &batch::fv<simd::compiled_isa, PaymentDueType>);
+    check_test_data(test::pmt::pmt_cases, &test::pmt::TestData::pv, &test::pmt::TestData::fv, &batch::pmt<simd::compiled_isa, PaymentDueType>);
+}
+
+TEST_CASE("annuity_batch_against_reference")
+{
+    check_against_reference<simd::Isa::Scalar>();
+    check_against_reference<simd::Isa::Avx2>();
+    check_against_reference<simd::Isa::Avx512>();
+}
+
+TEST_CASE("annuity_batch_broadcast")
+{
+    // One rate, payment and due type for all rows, periods per row
+    const std::vector<uint32_t> periods = {0, 1, 12, 60, 360, 361, 4000, 1u << 20};
+    const double rate = 0.004;
+    const double pmt = -1200.0;
+    const double value = 0.0;
+    const auto due = PaymentDueType::BeginningOfPeriod;
+
+    std::vector<double> results(periods.size());
+    batch::pv(
+        batch::broadcast(rate), batch::column<uint32_t>(periods), batch::broadcast(pmt), batch::broadcast(value), batch::broadcast(due), results);
+    for (std::size_t i = 0; i < periods.size(); ++i)
+    {
+        CAPTURE(periods[i]);
+        // Long horizons lose ~periods ulps in the power, as pv() does from rounding 1 + rate
+        CHECK(results[i] == doctest::Approx(pv<PaymentDueType::BeginningOfPeriod>(rate, periods[i], pmt, value)).epsilon(1e-9));
+        check_close(results[i], reference(Function::Pv, due, rate, periods[i], pmt, value));
+    }
+
+    // Strided column: every other element of an interleaved array
+    const std::vector<double> interleaved = {0.01, -1.0, 0.02, -1.0, 0.0, -1.0};
+    std::vector<double> strided(3);
+    const uint32_t n = 10;
+    batch::fv(
+        batch::Column<double>{interleaved.data(), 2},
+        batch::broadcast(n),
+        batch::broadcast(pmt),
+        batch::broadcast(value),
+        batch::broadcast(PaymentDueType::EndOfPeriod),
+        strided);
+    CHECK(strided[0] == doctest::Approx(fv<PaymentDueType::EndOfPeriod>(0.01, n, pmt, value)).epsilon(1e-14));
+    CHECK(strided[1] == doctest::Approx(fv<PaymentDueType::EndOfPeriod>(0.02, n, pmt, value)).epsilon(1e-14));
+    CHECK(strided[2] == -pmt * n - value);
+
+    // Nothing to do
+    batch::pv(batch::broadcast(rate), batch::broadcast(n), batch::broadcast(pmt), batch::broadcast(value), batch::broadcast(due), {});
+}
+
+TEST_CASE("annuity_batch_special_cases")
+{
+    const std::vector<double> rates = {0.0, -1.0, -2.0, 0.05, 0.05};
+    const std::vector<int32_t> dues = {0, 1, 0, 2, -1};
+    std::vector<double> results(rates.size());
+    const uint32_t n = 12;
+    const double pmt = -100.0;
+    const double value = 50.0;
+    batch::pv(batch::column<double>(rates), batch::broadcast(n), batch::broadcast(pmt), batch::broadcast(value), batch::column<int32_t>(dues), results);
+
+    CHECK(results[0] == -pmt * n - value);
+    CHECK(std::isnan(results[1]));
+    CHECK(std::isnan(results[2]));
+    // Unknown due types
+    CHECK(std::isnan(results[3]));
+    CHECK(std::isnan(results[4]));
+}
+
+TEST_CASE("rate_batch")
+{
+    std::vector<uint32_t> periods;
+    std::vector<double> pmts;
+    std::vector<double> present_values;
+    std::vector<double> future_values;
+    std::vector<int32_t> dues;
+    for (const auto & test : test::rate::rate_cases)
+    {
+        periods.push_back(test.periods);
+        pmts.push_back(test.pmt);
+        present_values.push_back(test.pv);
+        future_values.push_back(test.fv);
+        dues.push_back(static_cast<int32_t>(test.mode));
+    }
+    // Zero periods, same sign cashflows and an unknown due type
+    periods.insert(periods.end(), {0, 12, 12});
+    pmts.insert(pmts.end(), {-100.0, 100.0, -100.0});
+    present_values.insert(present_values.end(), {1000.0, 1000.0, 1000.0});
+    future_values.insert(future_values.end(), {0.0, 0.0, 0.0});
+    dues.insert(dues.end(), {0, 0, 3});
+
+    std::vector<double> results(periods.size());
+    std::vector<std::pair<std::size_t, AnnuityRateError>> errors;
+    batch::rate(
+        batch::column<uint32_t>(periods),
+        batch::column<double>(pmts),
+        batch::column<double>(present_values),
+        batch::column<double>(future_values),
+        batch::column<int32_t>(dues),
+        results,
+        [&errors](std::size_t row, const AnnuityRateError & e) { errors.emplace_back(row, e); });
+
+    const std::size_t cases = test::rate::rate_cases.size();
+    for (std::size_t row = 0; row < cases; ++row)
+    {
+        CAPTURE(row);
+        CHECK(results[row] == doctest::Approx(test::rate::rate_cases[row].expected_result).epsilon(1e-9).scale(1e-3));
+    }
+    REQUIRE(errors.size() == 3);
+    CHECK(errors[0] == std::pair{cases, AnnuityRateError{AnnuityRateErrorCode::ZeroPeriods}});
+    CHECK(errors[1] == std::pair{cases + 1, AnnuityRateError{AnnuityRateErrorCode::SameSignCashflows}});
+    CHECK(errors[2] == std::pair{cases + 2, AnnuityRateError{AnnuityRateErrorCode::InvalidDueType}});
+    CHECK(std::ranges::all_of(results.begin() + static_cast<std::ptrdiff_t>(cases), results.end(), [](double r) { return std::isnan(r); }));
+}
+
+TEST_CASE("amortization_schedules_batch")
+{
+    // Loans of 1 .. 240 periods back to back, one with an invalid rate and one with an unknown due type
+    const std::vector<double> rates = {0.05 / 12, 0.0, -1.5, 0.01, 0.2, 0.03};
+    const std::vector<double> present_values = {200000.0, 1200.0, 1000.0, 5000.0, 100.0, 700.0};
+    const std::vector<double> future_values = {0.0, 0.0, 0.0, -1000.0, 0.0, 0.0};
+    const std::vector<int32_t> dues = {0, 1, 0, 1, 0, 7};
+    const std::vector<uint64_t> offsets = {240, 252, 262, 298, 299, 309};
+    const batch::AmortizationLoans<int32_t> loans{
+        batch::column<double>(rates), batch::column<double>(present_values), batch::column<double>(future_values), batch::column<int32_t>(dues)};
+
+    const auto run = [&](auto && ... executor)
+    {
+        std::vector<double> interest(offsets.back());
+        std::vector<double> principal(offsets.back());
+        std::vector<double> balance(offsets.back());
+        std::vector<double> payments(offsets.size());
+        std::vector<std::pair<std::size_t, AmortizationError>> errors;
+        batch::amortization_schedules(
+            executor...,
+            loans,
+            offsets,
+            AmortizationSchedule{interest, principal, balance},
+            payments,
+            [&errors](std::size_t row, AmortizationError e) { errors.emplace_back(row, e); });
+        std::ranges::sort(errors);
+        return std::tuple{interest, principal, balance, payments, errors};
+    };
+
+    const auto [interest, principal, balance, payments, errors] = run();
+    for (std::size_t row = 0; row < offsets.size(); ++row)
+    {
+        CAPTURE(row);
+        const auto [begin, size] = batch::row_range(offsets, row);
+        if (row == 2 || row == 5)
+        {
+            CHECK(std::isnan(payments[row]));
+            CHECK(std::isnan(balance[begin + size - 1]));
+            continue;
+        }
+        std::vector<double> expected_interest(size);
+        std::vector<double> expected_principal(size);
+        std::vector<double> expected_balance(size);
+        const AmortizationSchedule expected{expected_interest, expected_principal, expected_balance};
+        const auto payment = dues[row] == 0
+            ? amortization_schedule<PaymentDueType::EndOfPeriod>(rates[row], present_values[row], future_values[row], expected)
+            : amortization_schedule<PaymentDueType::BeginningOfPeriod>(rates[row], present_values[row], future_values[row], expected);
+        CHECK(payments[row] == payment.value());
+        CHECK(std::equal(expected_interest.begin(), expected_interest.end(), interest.begin() + static_cast<std::ptrdiff_t>(begin)));
+        CHECK(std::equal(expected_principal.begin(), expected_principal.end(), principal.begin() + static_cast<std::ptrdiff_t>(begin)));
+        CHECK(std::equal(expected_balance.begin(), expected_balance.end(), balance.begin() + static_cast<std::ptrdiff_t>(begin)));
+    }
+    REQUIRE(errors.size() == 2);
+    CHECK(errors[0] == std::pair{std::size_t{2}, AmortizationError::InvalidRate});
+    CHECK(errors[1] == std::pair{std::size_t{5}, AmortizationError::InvalidDueType});
+
+    // Identical with threads, NaNs of the failed loans included
+    const auto threaded = run(batch::Executor(3));
+    const auto same = [](const std::vector<double> & a, const std::vector<double> & b)
+    { return std::ranges::equal(a, b, [](double x, double y) { return x == y || (std::isnan(x) && std::isnan(y)); }); };
+    CHECK(same(std::get<0>(threaded), interest));
+    CHECK(same(std::get<1>(threaded), principal));
+    CHECK(same(std::get<2>(threaded), balance));
+    CHECK(same(std::get<3>(threaded), payments));
+    CHECK(std::get<4>(threaded) == errors);
+}
@@ -0,0 +1,157 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/batch_executor.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+namespace
+{
+
+// Rows of very different lengths (2 .. 3000 cashflows), a few invalid ones among them
+struct SkewedBatch
+{
+    std::vector<double> values;
+    std::vector<int> dates;
+    std::vector<uint64_t> offsets;
+
+    SkewedBatch()
+    {
+        for (std::size_t row = 0; row < 600; ++row)
+        {
+            const std::size_t length = row % 97 == 0 ? 3000 : 2 + (row * 7) % 40;
+            const bool invalid = row % 53 == 0;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                values.push_back(i == 0 && !invalid ? -100.0 * static_cast<double>(length) : 5.0 + static_cast<double>((row + i) % 11));
+                dates.push_back(18000 + static_cast<int>(i * 30 + row % 5));
+            }
+            offsets.push_back(values.size());
+        }
+    }
+};
+
+}
+
+TEST_CASE("batch_partition_rows")
+{
+    const SkewedBatch batch;
+    for (const std::size_t max_tasks : {std::size_t{1}, std::size_t{3}, std::size_t{16}, std::size_t{100}, std::size_t{10000}})
+    {
+        CAPTURE(max_tasks);
+        const auto tasks = batch::partition_rows(batch.offsets, max_tasks);
+        REQUIRE(not tasks.empty());
+        CHECK(tasks.front().row_begin == 0);
+        CHECK(tasks.back().row_end == batch.offsets.size());
+        for (std::size_t t = 0; t < tasks.size(); ++t)
+        {
+            CHECK(tasks[t].row_begin < tasks[t].row_end);
+            if (t > 0)
+                CHECK(tasks[t].row_begin == tasks[t - 1].row_end);
+        }
+        CHECK(tasks.size() <= std::min(max_tasks, batch.offsets.size()));
+    }
+    CHECK(batch::partition_rows({}, 8).empty());
+}
+
+TEST_CASE("batch_executor_runs_every_task_once")
+{
+    std::vector<batch::RowTask> tasks;
+    for (std::size_t i = 0; i < 1000; ++i)
+        tasks.push_back({i, i + 1});
+
+    for (const unsigned threads : {1u, 2u, 5u, 16u})
+    {
+        CAPTURE(threads);
+        std::vector<std::atomic<int>> runs(tasks.size());
+        std::atomic<bool> worker_in_range = true;
+        batch::Executor(threads).run(
+            tasks,
+            [&](batch::RowTask task, unsigned worker)
+            {
+                runs[task.row_begin].fetch_add(1);
+                if (worker >= threads)
+                    worker_in_range = false;
+            });
+        for (const auto & count : runs)
+            CHECK(count.load() == 1);
+        CHECK(worker_in_range.load());
+    }
+}
+
+TEST_CASE("batch_executor_irr_xirr_independent_of_thread_count")
+{
+    const SkewedBatch batch;
+    const std::size_t n_rows = batch.offsets.size();
+
+    std::vector<double> irr_reference(n_rows);
+    std::vector<double> xirr_reference(n_rows);
+    std::vector<int> irr_failed_reference(n_rows, 0);
+    std::vector<int> xirr_failed_reference(n_rows, 0);
+    batch::irr(batch.values, batch.offsets, 0.1, irr_reference, [&](std::size_t row, auto) { irr_failed_reference[row] = 1; });
+    batch::xirr<DayCountConvention::ACT_365F>(
+        std::span<const double>(batch.values),
+        std::span<const int>(batch.dates),
+        std::span<const uint64_t>(batch.offsets),
+        0.1,
+        std::span<double>(xirr_reference),
+        [&](std::size_t row, auto) { xirr_failed_reference[row] = 1; });
+
+    for (const unsigned threads : {1u, 2u, 3u, 8u})
+    {
+        CAPTURE(threads);
+        const auto executor = batch::Executor(threads);
+
+        std::vector<double> irr_results(n_rows);
+        std::vector<int> irr_failed(n_rows, 0);
+        batch::irr(executor, batch.values, batch.offsets, 0.1, irr_results, [&](std::size_t row, auto) { irr_failed[row] = 1; });
+
+        std::vector<double> xirr_results(n_rows);
+        std::vector<int> xirr_failed(n_rows, 0);
+        batch::xirr<DayCountConvention::ACT_365F>(
+            executor,
+            std::span<const double>(batch.values),
+            std::span<const int>(batch.dates),
+            std::span<const uint64_t>(batch.offsets),
+            0.1,
+            std::span<double>(xirr_results),
+            [&](std::size_t row, auto) { xirr_failed[row] = 1; });
+
+        // Bit identical, NaNs included
+        CHECK(std::memcmp(irr_results.data(), irr_reference.data(), n_rows * sizeof(double)) == 0);
+        CHECK(std::memcmp(xirr_results.data(), xirr_reference.data(), n_rows * sizeof(double)) == 0);
+        CHECK(irr_failed == irr_failed_reference);
+        CHECK(xirr_failed == xirr_failed_reference);
+    }
+}
+
+TEST_CASE("batch_executor_more_threads_than_rows")
+{
+    // A huge thread count only starts as many workers as there are tasks
+    const std::vector<double> values = {-100.0, 60.0, 60.0, -200.0, 120.0, 120.0};
+    const std::vector<int> dates = {18000, 18365, 18730, 18000, 18365, 18730};
+    const std::vector<uint64_t> offsets = {3, 6};
+    const auto executor = batch::Executor(4'000'000'000u);
+
+    std::vector<double> results(offsets.size());
+    batch::xirr<DayCountConvention::ACT_365F>(
+        executor,
+        std::span<const double>(values),
+        std::span<const int>(dates),
+        std::span<const uint64_t>(offsets),
+        0.1,
+        std::span<double>(results),
+        [](std::size_t, auto) {});
+    CHECK(results[0] == doctest::Approx(results[1]).epsilon(1e-12));
+    CHECK(results[0] > 0.13);
+}
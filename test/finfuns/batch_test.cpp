@@ -0,0 +1,218 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../day_count_helper.hpp"
+#include "../test_data.hpp"
+
+#include <finfuns/batch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+TEST_CASE("batch_irr")
+{
+    using namespace finfuns::test::irr;
+
+    std::vector<double> values;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : irr_cases)
+    {
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        offsets.push_back(values.size());
+    }
+
+    std::vector<double> results(offsets.size());
+    std::vector<int> failed(offsets.size(), 0);
+    batch::irr(values, offsets, 0.1, results, [&](std::size_t row, auto) { failed[row] = 1; });
+
+    for (std::size_t row = 0; row < irr_cases.size(); ++row)
+    {
+        const auto & test = irr_cases[row];
+        CAPTURE(test.id);
+        const auto expected = irr(test.cashflows, 0.1);
+        if (expected.has_value())
+        {
+            REQUIRE(failed[row] == 0);
+            CHECK(results[row] == doctest::Approx(expected.value()).epsilon(1e-12));
+        }
+        else
+        {
+            CHECK(failed[row] == 1);
+            CHECK(std::isnan(results[row]));
+        }
+    }
+}
+
+TEST_CASE("batch_irr_warm_start")
+{
+    using namespace finfuns::test::irr;
+
+    std::vector<double> values;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : irr_cases)
+    {
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        offsets.push_back(values.size());
+    }
+
+    std::vector<double> yesterday(offsets.size());
+    batch::irr(values, offsets, 0.1, yesterday, [](std::size_t, auto) {});
+
+    // Inputs move a little, the previous results are the guesses
+    for (auto & value : values)
+        value *= value > 0 ? 1.001 : 1.0;
+    std::vector<double> cold(offsets.size());
+    std::vector<int> cold_failed(offsets.size(), 0);
+    batch::irr(values, offsets, 0.1, cold, [&](std::size_t row, auto) { cold_failed[row] = 1; });
+    std::vector<double> warm(offsets.size());
+    std::vector<int> warm_failed(offsets.size(), 0);
+    batch::irr(values, offsets, batch::RowGuesses(yesterday), warm, [&](std::size_t row, auto) { warm_failed[row] = 1; });
+
+    for (std::size_t row = 0; row < offsets.size(); ++row)
+    {
+        CAPTURE(row);
+        REQUIRE(warm_failed[row] == cold_failed[row]);
+        if (cold_failed[row] == 0)
+            CHECK(warm[row] == doctest::Approx(cold[row]).epsilon(1e-9));
+        else
+            CHECK(std::isnan(warm[row]));
+    }
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("batch_xirr", T, SysDates, IntDates)
+{
+    using namespace finfuns::test::xirr;
+
+    std::vector<double> values;
+    std::vector<std::chrono::sys_days> sys_dates;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : xirr_cases)
+    {
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        sys_dates.insert(sys_dates.end(), test.dates.begin(), test.dates.end());
+        offsets.push_back(values.size());
+    }
+    const auto dates = T::process(sys_dates);
+
+    std::vector<double> results(offsets.size());
+    std::vector<int> failed(offsets.size(), 0);
+    batch::xirr<DayCountConvention::ACT_365F>(
+        std::span<const double>(values),
+        std::span(dates.data(), dates.size()),
+        std::span<const uint64_t>(offsets),
+        0.1,
+        std::span<double>(results),
+        [&](std::size_t row, auto) { failed[row] = 1; });
+
+    for (std::size_t row = 0; row < xirr_cases.size(); ++row)
+    {
+        const auto & test = xirr_cases[row];
+        CAPTURE(test.id);
+        REQUIRE(failed[row] == 0);
+        CHECK(results[row] == doctest::Approx(test.expected_results[0].value).epsilon(1e-6));
+    }
+
+    // Rows in reverse date order
+    auto reversed_values = values;
+    auto reversed_dates = dates;
+    for (std::size_t row = 0; row < offsets.size(); ++row)
+    {
+        const auto [begin, size] = batch::row_range(std::span<const uint64_t>(offsets), row);
+        const auto first = static_cast<std::ptrdiff_t>(begin);
+        const auto last = static_cast<std::ptrdiff_t>(begin + size);
+        std::reverse(reversed_values.begin() + first, reversed_values.begin() + last);
+        std::reverse(reversed_dates.begin() + first, reversed_dates.begin() + last);
+    }
+    std::vector<double> reversed_results(offsets.size());
+    batch::xirr<DayCountConvention::ACT_365F>(
+        std::span<const double>(reversed_values),
+        std::span<const typename decltype(reversed_dates)::value_type>(reversed_dates),
+        std::span<const uint64_t>(offsets),
+        0.1,
+        std::span<double>(reversed_results),
+        [&](std::size_t row, auto) { failed[row] = 1; });
+    for (std::size_t row = 0; row < offsets.size(); ++row)
+    {
+        REQUIRE(failed[row] == 0);
+        CHECK(reversed_results[row] == doctest::Approx(results[row]).epsilon(1e-10));
+    }
+}
+
+TEST_CASE("batch_mirr")
+{
+    using namespace finfuns::test::mirr;
+
+    std::vector<double> values;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : mirr_cases)
+    {
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        offsets.push_back(values.size());
+    }
+
+    std::vector<double> results(offsets.size());
+    std::vector<int> failed(offsets.size(), 0);
+    batch::mirr(values, offsets, 0.1, 0.12, results, [&](std::size_t row, MIRRError) { failed[row] = 1; });
+
+    for (std::size_t row = 0; row < mirr_cases.size(); ++row)
+    {
+        const auto & test = mirr_cases[row];
+        CAPTURE(test.id);
+        const auto expected = mirr(test.cashflows, 0.1, 0.12);
+        if (expected.has_value())
+        {
+            REQUIRE(failed[row] == 0);
+            CHECK(results[row] == expected.value());
+        }
+        else
+        {
+            CHECK(failed[row] == 1);
+            CHECK(std::isnan(results[row]));
+        }
+    }
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("batch_xmirr", T, SysDates, IntDates)
+{
+    using namespace finfuns::test::xmirr;
+
+    std::vector<double> values;
+    std::vector<std::chrono::sys_days> sys_dates;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : xmirr_cases)
+    {
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        sys_dates.insert(sys_dates.end(), test.dates.begin(), test.dates.end());
+        offsets.push_back(values.size());
+    }
+    const auto dates = T::process(sys_dates);
+
+    std::vector<double> results(offsets.size());
+    std::vector<int> failed(offsets.size(), 0);
+    batch::xmirr<DayCountConvention::ACT_365F>(
+        std::span<const double>(values),
+        std::span(dates.data(), dates.size()),
+        std::span<const uint64_t>(offsets),
+        0.08,
+        0.10,
+        std::span<double>(results),
+        [&](std::size_t row, XMIRRError) { failed[row] = 1; });
+
+    for (std::size_t row = 0; row < xmirr_cases.size(); ++row)
+    {
+        const auto & test = xmirr_cases[row];
+        CAPTURE(test.id);
+        REQUIRE(failed[row] == 0);
+        CHECK(results[row] == doctest::Approx(test.expected_results[0].value).epsilon(1e-12));
+    }
+}
@@ -0,0 +1,140 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/civil_date.hpp>
+#include <finfuns/day_count.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace std::chrono;
+
+namespace
+{
+
+int to_days(int y, unsigned m, unsigned d)
+{
+    return static_cast<int>(sys_days{year{y} / month{m} / day{d}}.time_since_epoch().count());
+}
+
+}
+
+TEST_CASE("civil_date")
+{
+    // Every day of 1422 .. 2517: the table years, the fallback on both sides and a few 400 year cycles
+    for (int64_t days = -200'000; days < 200'000; ++days)
+    {
+        const year_month_day expected{sys_days{std::chrono::days{days}}};
+        const CivilDate date = civil_date(days);
+        const CivilDate computed = civil_from_days(days);
+        CAPTURE(days);
+        REQUIRE(date.year == static_cast<int>(expected.year()));
+        REQUIRE(date.month == static_cast<unsigned>(expected.month()));
+        REQUIRE(date.day == static_cast<unsigned>(expected.day()));
+        REQUIRE(computed.year == date.year);
+        REQUIRE(computed.month == date.month);
+        REQUIRE(computed.day == date.day);
+        REQUIRE(days_from_civil(date.year, date.month, date.day) == days);
+
+        const CivilYear year = civil_year(days);
+        REQUIRE(year.year == date.year);
+        REQUIRE(year.start == days_from_civil(date.year, 1, 1));
+        REQUIRE(year.length == (is_leap_year(date.year) ? 366 : 365));
+    }
+}
+
+TEST_CASE("day_number")
+{
+    // Date times before the epoch round down to the day they fall on
+    static_assert(day_number<DateUnit::Seconds>(int64_t{-1}) == -1);
+    static_assert(day_number<DateUnit::Seconds>(int64_t{-86'400}) == -1);
+    static_assert(day_number<DateUnit::Seconds>(int64_t{-86'401}) == -2);
+    static_assert(day_number<DateUnit::Milliseconds>(int64_t{86'399'999}) == 0);
+    static_assert(day_number<DateUnit::Nanoseconds>(int64_t{-1}) == -1);
+    static_assert(day_number<DateUnit::Days>(uint16_t{65'535}) == 65'535);
+    CHECK(days_between_act<DateUnit::Microseconds>(int64_t{-1}, int64_t{86'400'000'000}) == 2);
+    CHECK(year_fraction<DayCountConvention::ACT_365F, DateUnit::Seconds>(uint32_t{0}, uint32_t{365 * 86'400 + 86'399}) == 1.0);
+}
+
+TEST_CASE("year_fraction_conventions")
+{
+    struct Case
+    {
+        DayCountConvention day_count;
+        int from;
+        int to;
+        double expected;
+    };
+    const std::vector<Case> cases = {
+        {DayCountConvention::ACT_360, to_days(2023, 1, 1), to_days(2023, 12, 31), 364.0 / 360.0},
+        {DayCountConvention::ACT_365L, to_days(2023, 7, 1), to_days(2024, 7, 1), 1.0},
+        {DayCountConvention::ACT_365L, to_days(2022, 7, 1), to_days(2023, 7, 1), 1.0},
+        {DayCountConvention::ACT_365L, to_days(2024, 1, 1), to_days(2024, 3, 1), 60.0 / 366.0},
+        // Straddling a leap year in both orders: the later date's year either way
+        {DayCountConvention::ACT_365L, to_days(2024, 7, 1), to_days(2023, 7, 1), -1.0},
+        {DayCountConvention::ACT_365L, to_days(2023, 12, 1), to_days(2024, 2, 1), 62.0 / 366.0},
+        {DayCountConvention::ACT_365L, to_days(2024, 2, 1), to_days(2023, 12, 1), -62.0 / 366.0},
+        {DayCountConvention::ACT_365L, to_days(2024, 12, 1), to_days(2025, 2, 1), 62.0 / 365.0},
+        {DayCountConvention::ACT_365L, to_days(2025, 2, 1), to_days(2024, 12, 1), -62.0 / 365.0},
+        // ISDA 2006 example
+        {DayCountConvention::ACT_ACT_ISDA, to_days(2003, 11, 1), to_days(2004, 5, 1), 61.0 / 365.0 + 121.0 / 366.0},
+        {DayCountConvention::ACT_ACT_ISDA, to_days(2004, 5, 1), to_days(2003, 11, 1), -(61.0 / 365.0 + 121.0 / 366.0)},
+        {DayCountConvention::ACT_ACT_ISDA, to_days(1999, 7, 1), to_days(2001, 3, 1), 184.0 / 365.0 + 1.0 + 59.0 / 365.0},
+        {DayCountConvention::ACT_ACT_ISDA, to_days(2299, 12, 1), to_days(2300, 2, 1), 31.0 / 365.0 + 31.0 / 365.0},
+        {DayCountConvention::THIRTY_360_US, to_days(2023, 1, 31), to_days(2023, 2, 28), 28.0 / 360.0},
+        {DayCountConvention::THIRTY_360_US, to_days(2023, 1, 30), to_days(2023, 3, 31), 60.0 / 360.0},
+        {DayCountConvention::THIRTY_360_US, to_days(2023, 1, 15), to_days(2023, 3, 31), 76.0 / 360.0},
+        {DayCountConvention::THIRTY_360_US, to_days(2023, 2, 28), to_days(2023, 3, 31), 30.0 / 360.0},
+        {DayCountConvention::THIRTY_360_US, to_days(2023, 2, 28), to_days(2024, 2, 29), 1.0},
+        {DayCountConvention::THIRTY_360_US, to_days(2024, 2, 28), to_days(2024, 3, 28), 30.0 / 360.0},
+        {DayCountConvention::THIRTY_E_360, to_days(2023, 1, 31), to_days(2023, 3, 31), 60.0 / 360.0},
+        {DayCountConvention::THIRTY_E_360, to_days(2023, 1, 15), to_days(2023, 3, 31), 75.0 / 360.0},
+        {DayCountConvention::THIRTY_E_360, to_days(2023, 2, 28), to_days(2024, 2, 29), 361.0 / 360.0},
+    };
+
+    const auto year_fraction_of = [](DayCountConvention day_count, auto from, auto to)
+    {
+        switch (day_count)
+        {
+            case DayCountConvention::ACT_360:
+                return year_fraction<DayCountConvention::ACT_360>(from, to);
+            case DayCountConvention::ACT_365L:
+                return year_fraction<DayCountConvention::ACT_365L>(from, to);
+            case DayCountConvention::ACT_ACT_ISDA:
+                return year_fraction<DayCountConvention::ACT_ACT_ISDA>(from, to);
+            case DayCountConvention::THIRTY_360_US:
+                return year_fraction<DayCountConvention::THIRTY_360_US>(from, to);
+            case DayCountConvention::THIRTY_E_360:
+                return year_fraction<DayCountConvention::THIRTY_E_360>(from, to);
+            default:
+                return 0.0;
+        }
+    };
+
+    for (const auto & test : cases)
+    {
+        CAPTURE(day_count_to_string(test.day_count));
+        CAPTURE(test.from);
+        CAPTURE(test.to);
+        CHECK(year_fraction_of(test.day_count, test.from, test.to) == doctest::Approx(test.expected).epsilon(1e-15));
+        const auto from = sys_days{std::chrono::days{test.from}};
+        const auto to = sys_days{std::chrono::days{test.to}};
+        CHECK(year_fraction_of(test.day_count, from, to) == doctest::Approx(test.expected).epsilon(1e-15));
+    }
+
+    // Date times count the day they fall on
+    const auto noon = [](int days) { return static_cast<int64_t>(days) * 86'400 + 43'200; };
+    CHECK(
+        year_fraction<DayCountConvention::THIRTY_360_US, DateUnit::Seconds>(noon(to_days(2023, 2, 28)), noon(to_days(2023, 3, 31)))
+        == doctest::Approx(30.0 / 360.0));
+    CHECK(
+        year_fraction<DayCountConvention::ACT_ACT_ISDA, DateUnit::Seconds>(noon(to_days(2003, 11, 1)), noon(to_days(2004, 5, 1)))
+        == doctest::Approx(61.0 / 365.0 + 121.0 / 366.0));
+}
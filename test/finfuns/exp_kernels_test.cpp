@@ -0,0 +1,143 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/exp_kernels.hpp>
+#include <finfuns/simd.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+namespace
+{
+
+// exp(x[i]) through the discounted sum kernel: cf = 1, t = x, log(1+r) = -1
+template <simd::Isa isa, ExpAccuracy accuracy>
+double kernel_exp(double x)
+{
+    const double cf = 1.0;
+    return detail::exp_discounted_sums<isa, accuracy, false>(&cf, &x, 1, -1.0).first;
+}
+
+template <simd::Isa isa, ExpAccuracy accuracy>
+void check_exp(double max_relative_error)
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> dist(-700.0, 700.0);
+    double worst = 0.0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const double x = i < 10000 ? dist(rng) : dist(rng) / 1000.0;
+        const double expected = std::exp(x);
+        worst = std::max(worst, std::abs(kernel_exp<isa, accuracy>(x) - expected) / expected);
+    }
+    CAPTURE(worst);
+    CHECK(worst <= max_relative_error);
+
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    CHECK(kernel_exp<isa, accuracy>(0.0) == 1.0);
+    CHECK(kernel_exp<isa, accuracy>(800.0) == inf);
+    CHECK(kernel_exp<isa, accuracy>(inf) == inf);
+    CHECK(kernel_exp<isa, accuracy>(-800.0) == 0.0);
+    CHECK(kernel_exp<isa, accuracy>(-inf) == 0.0);
+    CHECK(std::isnan(kernel_exp<isa, accuracy>(std::numeric_limits<double>::quiet_NaN())));
+    CHECK(kernel_exp<isa, accuracy>(-740.0) > 0.0); // subnormal results are kept
+}
+
+template <simd::Isa isa>
+float kernel_exp_float(float x)
+{
+    const float cf = 1.0f;
+    return detail::exp_discounted_sums<isa, ExpAccuracy::Full, false>(&cf, &x, 1, -1.0f).first;
+}
+
+template <simd::Isa isa>
+void check_exp_float()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<float> dist(-87.0f, 88.0f);
+    double worst = 0.0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const float x = i < 10000 ? dist(rng) : dist(rng) / 1000.0f;
+        const double expected = std::exp(static_cast<double>(x));
+        worst = std::max(worst, std::abs(static_cast<double>(kernel_exp_float<isa>(x)) - expected) / expected);
+    }
+    CAPTURE(worst);
+    CHECK(worst <= 2.5e-7);
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    CHECK(kernel_exp_float<isa>(0.0f) == 1.0f);
+    CHECK(kernel_exp_float<isa>(100.0f) == inf);
+    CHECK(kernel_exp_float<isa>(inf) == inf);
+    CHECK(kernel_exp_float<isa>(-110.0f) == 0.0f);
+    CHECK(kernel_exp_float<isa>(-inf) == 0.0f);
+    CHECK(std::isnan(kernel_exp_float<isa>(std::numeric_limits<float>::quiet_NaN())));
+    CHECK(kernel_exp_float<isa>(-100.0f) > 0.0f); // subnormal results are kept
+}
+
+template <simd::Isa isa, ExpAccuracy accuracy>
+void check_sums(double max_relative_error)
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> cf_dist(0.0, 1000.0);
+    std::uniform_real_distribution<double> t_dist(0.0, 30.0);
+    for (std::size_t n = 1; n < 70; ++n)
+    {
+        CAPTURE(n);
+        std::vector<double> cashflows(n);
+        std::vector<double> times(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            cashflows[i] = cf_dist(rng);
+            times[i] = t_dist(rng);
+        }
+        const double log1pr = std::log1p(0.08);
+        const auto [sum, weighted] = detail::exp_discounted_sums<isa, accuracy, true>(cashflows.data(), times.data(), n, log1pr);
+        const auto [sum_ref, weighted_ref]
+            = detail::exp_discounted_sums<simd::Isa::Scalar, accuracy, true>(cashflows.data(), times.data(), n, log1pr);
+        CHECK(sum == doctest::Approx(sum_ref).epsilon(max_relative_error));
+        CHECK(weighted == doctest::Approx(weighted_ref).epsilon(max_relative_error));
+    }
+}
+
+}
+
+TEST_CASE("exp_kernel_accuracy")
+{
+    check_exp<simd::Isa::Avx2, ExpAccuracy::Full>(2.5e-16);
+    check_exp<simd::Isa::Avx512, ExpAccuracy::Full>(2.5e-16);
+    check_exp<simd::Isa::Avx2, ExpAccuracy::Screening>(1e-12);
+    check_exp<simd::Isa::Avx512, ExpAccuracy::Screening>(1e-12);
+}
+
+TEST_CASE("exp_kernel_float_accuracy")
+{
+    check_exp_float<simd::Isa::Avx2>();
+    check_exp_float<simd::Isa::Avx512>();
+}
+
+TEST_CASE("exp_discounted_sums")
+{
+    check_sums<simd::Isa::Avx2, ExpAccuracy::Full>(1e-14);
+    check_sums<simd::Isa::Avx512, ExpAccuracy::Full>(1e-14);
+    check_sums<simd::Isa::Avx2, ExpAccuracy::Screening>(1e-12);
+    check_sums<simd::Isa::Avx512, ExpAccuracy::Screening>(1e-12);
+}
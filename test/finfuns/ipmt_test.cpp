@@ -0,0 +1,57 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/ipmt.hpp>
+#include <finfuns/pmt.hpp>
+
+#include "../test_data.hpp"
+
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::ipmt;
+
+TEST_CASE("ipmt_ppmt")
+{
+    for (const auto & test : ipmt_cases)
+    {
+        CAPTURE(test.id);
+        const bool end = test.mode == PaymentDueType::EndOfPeriod;
+        const auto interest = end ? ipmt<PaymentDueType::EndOfPeriod>(test.rate, test.per, test.periods, test.pv, test.fv)
+                                  : ipmt<PaymentDueType::BeginningOfPeriod>(test.rate, test.per, test.periods, test.pv, test.fv);
+        const auto principal = end ? ppmt<PaymentDueType::EndOfPeriod>(test.rate, test.per, test.periods, test.pv, test.fv)
+                                   : ppmt<PaymentDueType::BeginningOfPeriod>(test.rate, test.per, test.periods, test.pv, test.fv);
+
+        if (std::isnan(test.expected_ipmt))
+            CHECK(std::isnan(interest));
+        else
+            CHECK(interest == doctest::Approx(test.expected_ipmt).epsilon(1e-12));
+        if (std::isnan(test.expected_ppmt))
+            CHECK(std::isnan(principal));
+        else
+            CHECK(principal == doctest::Approx(test.expected_ppmt).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("ppmt_repays_loan")
+{
+    // The principal parts add up to the loan less the balance left, at any rate including 0
+    for (const double rate : {0.0, 1e-10, 0.04 / 12, 0.3})
+    {
+        CAPTURE(rate);
+        double end_total = 0.0;
+        double begin_total = 0.0;
+        for (uint32_t per = 1; per <= 120; ++per)
+        {
+            end_total += ppmt<PaymentDueType::EndOfPeriod>(rate, per, 120, 100000.0, -20000.0);
+            begin_total += ppmt<PaymentDueType::BeginningOfPeriod>(rate, per, 120, 100000.0, -20000.0);
+        }
+        CHECK(end_total == doctest::Approx(-80000.0).epsilon(1e-10));
+        // With payments at the beginning the last period's interest is still to come
+        CHECK(begin_total == doctest::Approx(20000.0 / (1.0 + rate) - 100000.0).epsilon(1e-10));
+    }
+}
@@ -0,0 +1,175 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/irr_state.hpp>
+
+#include "../test_data.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::irr;
+
+namespace
+{
+
+IrrState make_state(std::span<const double> values, uint64_t offset)
+{
+    IrrState state(offset);
+    for (const double value : values)
+        state.add(value);
+    return state;
+}
+
+std::vector<std::byte> serialized(const IrrState & state)
+{
+    std::vector<std::byte> out;
+    state.serialize(out);
+    return out;
+}
+
+}
+
+TEST_CASE("irr_state_add")
+{
+    for (const auto & test : irr_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = make_state(test.cashflows, 0).finalize(test.guess);
+        const auto expected = irr(test.cashflows, test.guess);
+
+        REQUIRE(result.has_value() == expected.has_value());
+        if (expected.has_value())
+            CHECK(result.value() == expected.value());
+        else
+            CHECK(result.error() == expected.error());
+    }
+}
+
+TEST_CASE("irr_state_merge_any_order")
+{
+    const std::vector<double> cashflows = {-1000.0, 120.0, -50.0, 300.0, 250.0, 0.0, 400.0, 180.0, 90.0, 60.0};
+    const auto expected = irr(cashflows, 0.1).value();
+    const auto part = [&](std::size_t begin, std::size_t end)
+    { return make_state(std::span(cashflows).subspan(begin, end - begin), begin); };
+
+    // In order: the parts coalesce into one chunk
+    auto in_order = part(0, 3);
+    in_order.merge(part(3, 7));
+    in_order.merge(part(7, 10));
+    CHECK(in_order.size() == cashflows.size());
+    CHECK(in_order.finalize(0.1).value() == expected);
+
+    // Reversed: separate chunks, evaluated at their offsets
+    auto reversed = part(7, 10);
+    reversed.merge(part(3, 7));
+    reversed.merge(part(0, 3));
+    CHECK(reversed.finalize(0.1).value() == doctest::Approx(expected).epsilon(1e-12));
+
+    // The serialized state does not depend on the order of the merged chunks
+    auto shuffled = part(7, 10);
+    shuffled.merge(part(0, 3));
+    shuffled.merge(part(3, 7));
+    CHECK(serialized(shuffled) == serialized(reversed));
+    CHECK(shuffled.finalize(0.1).value() == reversed.finalize(0.1).value());
+
+    // Merging a state into itself doubles every cashflow, which keeps the IRR
+    auto doubled = part(0, 10);
+    doubled.merge(doubled);
+    CHECK(doubled.size() == 2 * cashflows.size());
+    CHECK(doubled.finalize(0.1).value() == doctest::Approx(expected).epsilon(1e-12));
+}
+
+TEST_CASE("irr_state_gaps_are_zero_cashflows")
+{
+    const std::vector<double> dense = {-1000.0, 0.0, 0.0, 400.0, 0.0, 500.0, 600.0};
+
+    IrrState state;
+    state.add(-1000.0);
+    auto tail = IrrState(3);
+    tail.add(400.0);
+    auto last = IrrState(5);
+    last.add(500.0);
+    last.add(600.0);
+    state.merge(last);
+    state.merge(tail);
+
+    CHECK(state.finalize(std::nullopt).value() == doctest::Approx(irr(dense, std::nullopt).value()).epsilon(1e-12));
+}
+
+TEST_CASE("irr_state_gaps_at_large_offsets")
+{
+    // Row numbers as offsets: the discount of the offset itself would underflow
+    const std::vector<double> dense = {-100.0, 60.0, 0.0, 60.0};
+    const double expected = irr(dense, std::nullopt).value();
+
+    for (const uint64_t base : {uint64_t{1000}, uint64_t{1'000'000}, uint64_t{1} << 40})
+    {
+        auto state = IrrState(base);
+        state.add(-100.0);
+        state.add(60.0);
+        auto tail = IrrState(base + 3);
+        tail.add(60.0);
+        state.merge(tail);
+
+        CHECK(state.finalize(std::nullopt).value() == doctest::Approx(expected).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("irr_state_serialization")
+{
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 500.0, 1e-300, -0.0};
+    auto state = make_state(std::span(cashflows).first(3), 1);
+    state.merge(make_state(std::span(cashflows).subspan(3), 40));
+
+    const auto bytes = serialized(state);
+    CHECK(bytes.front() == std::byte{IrrState::serialization_version});
+    const auto restored = IrrState::deserialize(bytes);
+    REQUIRE(restored.has_value());
+    CHECK(serialized(restored.value()) == bytes);
+    CHECK(restored->finalize(0.1).value() == state.finalize(0.1).value());
+
+    // add() continues after the last period of the serialized state itself
+    auto continued = restored.value();
+    continued.add(42.0);
+    state.add(42.0);
+    CHECK(serialized(continued) == serialized(state));
+
+    CHECK(IrrState::deserialize(serialized(IrrState())).value().size() == 0);
+}
+
+TEST_CASE("irr_state_deserialization_errors")
+{
+    const auto bytes = serialized(make_state(std::vector<double>{-100.0, 60.0, 60.0}, 0));
+
+    auto wrong_version = bytes;
+    wrong_version[0] = std::byte{IrrState::serialization_version + 1};
+    CHECK(IrrState::deserialize(wrong_version).error() == SerializationError::UnsupportedVersion);
+
+    for (std::size_t size = 0; size < bytes.size(); ++size)
+    {
+        CAPTURE(size);
+        CHECK(IrrState::deserialize(std::span(bytes).first(size)).error() == SerializationError::UnexpectedEnd);
+    }
+
+    auto trailing = bytes;
+    trailing.push_back(std::byte{0});
+    CHECK(IrrState::deserialize(trailing).error() == SerializationError::InvalidData);
+}
+
+TEST_CASE("irr_state_errors")
+{
+    IrrState empty;
+    CHECK(empty.finalize(0.1).error() == IRRError{IRRErrorCode::NotEnoughCashflows});
+
+    auto same_sign = make_state(std::vector<double>{100.0, 200.0}, 0);
+    same_sign.merge(make_state(std::vector<double>{300.0}, 10));
+    CHECK(same_sign.finalize(0.1).error() == IRRError{IRRErrorCode::SameSignCashflows});
+}
@@ -6,6 +6,7 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <finfuns/irr.hpp>
+#include <finfuns/simd.hpp>
 
 #include "../test_data.hpp"
 
@@ -38,3 +39,92 @@ TEST_CASE("irr")
         }
     }
 }
+
+namespace
+{
+
+template <simd::Isa isa>
+void check_irr_kernel_set()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    for (const auto & test : irr_cases)
+    {
+        CAPTURE(test.id);
+        CAPTURE(simd::isa_to_string(isa));
+        const auto result = irr<NpvEvaluation::Discounting, isa>(test.cashflows, test.guess);
+        const auto mixed = irr<NpvEvaluation::MixedPrecision, isa>(test.cashflows, test.guess);
+        if (test.expected_result.has_value())
+        {
+            REQUIRE(result.has_value());
+            CHECK(result.value() == doctest::Approx(test.expected_result.value()).epsilon(1e-6));
+            REQUIRE(mixed.has_value());
+            CHECK(mixed.value() == doctest::Approx(result.value()).epsilon(1e-12));
+        }
+        else
+        {
+            REQUIRE(not result.has_value());
+            CHECK(result.error() == test.expected_result.error());
+        }
+    }
+}
+
+}
+
+TEST_CASE("irr_kernel_sets")
+{
+    check_irr_kernel_set<simd::Isa::Scalar>();
+    check_irr_kernel_set<simd::Isa::Avx2>();
+    check_irr_kernel_set<simd::Isa::Avx512>();
+}
+
+TEST_CASE("irr_horner")
+{
+    for (const auto & test : irr_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = irr<NpvEvaluation::Horner>(test.cashflows, test.guess);
+
+        if (test.expected_result.has_value())
+        {
+            REQUIRE(result.has_value());
+            CHECK(result.value() == doctest::Approx(test.expected_result.value()).epsilon(1e-6));
+        }
+        else
+        {
+            REQUIRE(not result.has_value());
+            CHECK(result.error() == test.expected_result.error());
+        }
+    }
+}
+
+TEST_CASE("irr_mixed_precision")
+{
+    for (const auto & test : irr_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = irr<NpvEvaluation::MixedPrecision>(test.cashflows, test.guess);
+
+        if (test.expected_result.has_value())
+        {
+            REQUIRE(result.has_value());
+            CHECK(result.value() == doctest::Approx(test.expected_result.value()).epsilon(1e-6));
+        }
+        else
+        {
+            REQUIRE(not result.has_value());
+            CHECK(result.error() == test.expected_result.error());
+        }
+    }
+
+    // The float Newton does most of the work, the double solve only refines its root
+    const std::vector<double> cashflows = {-10000.0, 2500.0, 3100.0, 2700.0, 2900.0, 1800.0, 900.0};
+    SolverStats stats;
+    const auto mixed = irr<NpvEvaluation::MixedPrecision>(cashflows, 0.1, &stats);
+    REQUIRE(mixed.has_value());
+    CHECK(mixed.value() == doctest::Approx(irr(cashflows, 0.1).value()).epsilon(1e-13));
+    CHECK(stats.low_precision_iterations > 0);
+    CHECK(stats.newton_iterations <= 2);
+    CHECK(not stats.used_fallback);
+}
@@ -0,0 +1,141 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/mirr.hpp>
+
+#include "../test_data.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::mirr;
+
+TEST_CASE("mirr")
+{
+    for (const auto & test : mirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = (test.mode == IndexMode::ZeroBased)
+            ? mirr<IndexMode::ZeroBased>(test.cashflows, test.finance_rate, test.reinvest_rate)
+            : mirr<IndexMode::OneBased>(test.cashflows, test.finance_rate, test.reinvest_rate);
+
+        REQUIRE(result.has_value() == test.expected_result.has_value());
+        if (result.has_value())
+            CHECK(result.value() == doctest::Approx(test.expected_result.value()).epsilon(1e-12));
+        else
+            CHECK(result.error() == test.expected_result.error());
+    }
+}
+
+namespace
+{
+
+// Two pass reference: PV of the negative cashflows, PV of the positive ones (their FV would overflow for
+// the long series), then the root
+double mirr_reference(const std::vector<double> & cashflows, double finance_rate, double reinvest_rate)
+{
+    const auto horizon = static_cast<double>(cashflows.size() - 1);
+    double negative = 0.0;
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+        if (cashflows[i] < 0)
+            negative += cashflows[i] * std::pow(1.0 + finance_rate, -static_cast<double>(i));
+    double positive = 0.0;
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+        if (cashflows[i] > 0)
+            positive += cashflows[i] * std::pow(1.0 + reinvest_rate, -static_cast<double>(i));
+    return (1.0 + reinvest_rate) * std::pow(positive / -negative, 1.0 / horizon) - 1.0;
+}
+
+template <simd::Isa isa>
+void check_mirr_against_reference()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(21);
+    std::normal_distribution<double> flow(0.0, 1000.0);
+    // Lengths around the SIMD block sizes, plus one long enough to reach the power flushes
+    for (const std::size_t n : {2u, 3u, 7u, 8u, 9u, 15u, 16u, 17u, 33u, 250u, 4000u})
+    {
+        std::vector<double> cashflows(n);
+        for (auto & cf : cashflows)
+            cf = flow(rng);
+        cashflows[0] = -std::abs(cashflows[0]) - 1.0;
+        cashflows[1] = std::abs(cashflows[1]) + 1.0;
+        for (const auto & [finance_rate, reinvest_rate] : {std::pair{0.1, 0.12}, std::pair{0.0, 0.0}, std::pair{-0.05, 0.3}})
+        {
+            CAPTURE(n);
+            CAPTURE(finance_rate);
+            const auto result = mirr<IndexMode::ZeroBased, isa>(cashflows, finance_rate, reinvest_rate);
+            REQUIRE(result.has_value());
+            CHECK(result.value() == doctest::Approx(mirr_reference(cashflows, finance_rate, reinvest_rate)).epsilon(1e-10));
+        }
+    }
+}
+
+}
+
+TEST_CASE("mirr_isas")
+{
+    check_mirr_against_reference<simd::Isa::Scalar>();
+    check_mirr_against_reference<simd::Isa::Avx2>();
+    check_mirr_against_reference<simd::Isa::Avx512>();
+}
+
+namespace
+{
+
+template <simd::Isa isa>
+void check_mirr_late_cashflows()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    // Only the last cashflow has its sign: discounted to period 0 it is far below the double range
+    for (const std::size_t n : {8000u, 10000u, 100000u})
+    {
+        CAPTURE(n);
+        const double horizon = static_cast<double>(n - 1);
+
+        std::vector<double> late_positive(n, 0.0);
+        late_positive.front() = -100.0;
+        late_positive.back() = 200.0;
+        const auto positive = mirr<IndexMode::ZeroBased, isa>(late_positive, 0.1, 0.1);
+        REQUIRE(positive.has_value());
+        CHECK(positive.value() == doctest::Approx(std::expm1(std::log(2.0) / horizon)).epsilon(1e-12));
+
+        std::vector<double> late_negative(n, 0.0);
+        late_negative.front() = 100.0;
+        late_negative.back() = -50.0;
+        const auto negative = mirr<IndexMode::OneBased, isa>(late_negative, 0.1, 0.1);
+        REQUIRE(negative.has_value());
+        const double log_rate = std::log1p(0.1);
+        CHECK(negative.value() == doctest::Approx(std::expm1((std::log(2.0) - log_rate) / (horizon + 1.0) + 2.0 * log_rate)).epsilon(1e-12));
+    }
+
+    // Rates far from 0 take the same path on short series
+    const std::vector<double> cashflows = {0.0, -100.0, 0.0, 30.0, -20.0, 500.0};
+    for (const double reinvest_rate : {999.0, -0.999})
+    {
+        CAPTURE(reinvest_rate);
+        const auto result = mirr<IndexMode::ZeroBased, isa>(cashflows, 0.1, reinvest_rate);
+        REQUIRE(result.has_value());
+        CHECK(result.value() == doctest::Approx(mirr_reference(cashflows, 0.1, reinvest_rate)).epsilon(1e-12));
+    }
+}
+
+}
+
+TEST_CASE("mirr_long_series_late_cashflows")
+{
+    check_mirr_late_cashflows<simd::Isa::Scalar>();
+    check_mirr_late_cashflows<simd::Isa::Avx2>();
+    check_mirr_late_cashflows<simd::Isa::Avx512>();
+}
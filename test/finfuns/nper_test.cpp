@@ -0,0 +1,42 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/nper.hpp>
+#include <finfuns/pmt.hpp>
+
+#include "../test_data.hpp"
+
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::nper;
+
+TEST_CASE("nper")
+{
+    for (const auto & test : nper_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = (test.mode == PaymentDueType::EndOfPeriod)
+            ? nper<PaymentDueType::EndOfPeriod>(test.rate, test.pmt, test.pv, test.fv)
+            : nper<PaymentDueType::BeginningOfPeriod>(test.rate, test.pmt, test.pv, test.fv);
+
+        if (std::isnan(test.expected_result))
+            CHECK(std::isnan(result));
+        else
+            CHECK(result == doctest::Approx(test.expected_result).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("nper_inverts_pmt")
+{
+    for (const double rate : {-0.005, 1e-12, 0.05 / 12, 0.15})
+    {
+        CAPTURE(rate);
+        const double payment = pmt<PaymentDueType::EndOfPeriod>(rate, 60, 30000.0, 0.0);
+        CHECK(nper<PaymentDueType::EndOfPeriod>(rate, payment, 30000.0, 0.0) == doctest::Approx(60.0).epsilon(1e-9));
+    }
+}
@@ -0,0 +1,180 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/npv_calculator.hpp>
+#include <finfuns/simd.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+namespace
+{
+
+// Magnitude of the discounted terms - the sums may cancel, so errors are relative to this
+double discounted_magnitude(std::span<const double> cashflows, double rate)
+{
+    double sum = 0.0;
+    double weighted = 0.0;
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+    {
+        const double term = std::abs(cashflows[i]) / std::pow(1.0 + rate, static_cast<double>(i));
+        sum += term;
+        weighted += term * static_cast<double>(i + 1);
+    }
+    return sum + weighted;
+}
+
+template <simd::Isa isa>
+void check_against_scalar()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> cf_dist(-1000.0, 1000.0);
+    const std::vector<double> rates = {-0.95, -0.5, -0.01, 1e-9, 0.01, 0.0866, 0.5, 3.0};
+
+    for (std::size_t n = 1; n <= 200; n += (n < 40 ? 1 : 13))
+    {
+        std::vector<double> cashflows(n);
+        for (auto & cf : cashflows)
+            cf = cf_dist(rng);
+        const auto calc = NpvCalculator<double>(cashflows);
+
+        for (const double rate : rates)
+        {
+            CAPTURE(n);
+            CAPTURE(rate);
+            const double scale = discounted_magnitude(cashflows, rate);
+            if (!std::isfinite(scale))
+                continue;
+
+            const double zero_based = calc.calculate<IndexMode::ZeroBased, isa>(rate);
+            CHECK(zero_based == doctest::Approx(calc.calculate<IndexMode::ZeroBased, simd::Isa::Scalar>(rate)).epsilon(1e-12).scale(scale));
+
+            const double one_based = calc.calculate<IndexMode::OneBased, isa>(rate);
+            CHECK(one_based == doctest::Approx(calc.calculate<IndexMode::OneBased, simd::Isa::Scalar>(rate)).epsilon(1e-12).scale(scale));
+
+            const auto [npv, derivative] = calc.calculate_with_derivative<isa>(rate);
+            const auto [npv_ref, derivative_ref] = calc.calculate_with_derivative<simd::Isa::Scalar>(rate);
+            CHECK(npv == doctest::Approx(npv_ref).epsilon(1e-12).scale(scale));
+            CHECK(derivative == doctest::Approx(derivative_ref).epsilon(1e-12).scale(scale / std::abs(1.0 + rate)));
+        }
+    }
+}
+
+}
+
+// NpvCalculator<float> (SIMD and scalar) against the double calculator
+template <simd::Isa isa>
+void check_float_against_double()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> cf_dist(-1000.0, 1000.0);
+    for (std::size_t n = 1; n <= 200; n += (n < 40 ? 1 : 13))
+    {
+        std::vector<double> cashflows(n);
+        std::vector<float> cashflows_f(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            cashflows[i] = cf_dist(rng);
+            cashflows_f[i] = static_cast<float>(cashflows[i]);
+        }
+        const auto calc = NpvCalculator<double>(cashflows);
+        const auto calc_f = NpvCalculator<float>(cashflows_f);
+
+        for (const double rate : {-0.5, -0.01, 0.01, 0.0866, 0.5, 3.0})
+        {
+            CAPTURE(n);
+            CAPTURE(rate);
+            const double scale = discounted_magnitude(cashflows, rate);
+            // Growing discount factors overflow much sooner in float
+            if (scale > 1e30)
+                continue;
+            const auto rate_f = static_cast<float>(rate);
+
+            const auto [npv, derivative] = calc.calculate_with_derivative(rate);
+            const auto [npv_f, derivative_f] = calc_f.template calculate_with_derivative<isa>(rate_f);
+            const auto [npv_scalar, derivative_scalar] = calc_f.template calculate_with_derivative<simd::Isa::Scalar>(rate_f);
+            CHECK(static_cast<double>(npv_f) == doctest::Approx(npv).epsilon(1e-5).scale(scale));
+            CHECK(static_cast<double>(npv_scalar) == doctest::Approx(npv).epsilon(1e-5).scale(scale));
+            CHECK(static_cast<double>(derivative_f) == doctest::Approx(derivative).epsilon(1e-5).scale(scale / std::abs(1.0 + rate)));
+            CHECK(static_cast<double>(calc_f.template calculate<IndexMode::ZeroBased, isa>(rate_f))
+                  == doctest::Approx(npv).epsilon(1e-5).scale(scale));
+        }
+    }
+}
+
+TEST_CASE("npv_calculator_simd_matches_scalar")
+{
+    check_against_scalar<simd::Isa::Avx2>();
+    check_against_scalar<simd::Isa::Avx512>();
+}
+
+TEST_CASE("npv_calculator_float")
+{
+    check_float_against_double<simd::Isa::Avx2>();
+    check_float_against_double<simd::Isa::Avx512>();
+    check_float_against_double<simd::Isa::Scalar>();
+}
+
+TEST_CASE("npv_calculator_special_rates")
+{
+    const std::vector<double> cashflows = {-10000.0, 3000.0, 4200.0, 6800.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    const auto calc = NpvCalculator(cashflows);
+    CHECK(calc.calculate(0.0) == doctest::Approx(4021.0));
+    CHECK(std::isinf(calc.calculate(-1.0)));
+    CHECK(std::isinf(calc.calculate_with_derivative(-1.5).first));
+}
+
+TEST_CASE("horner_npv_calculator")
+{
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> cf_dist(-1000.0, 1000.0);
+    for (std::size_t n = 1; n <= 120; n += 7)
+    {
+        std::vector<double> cashflows(n);
+        for (auto & cf : cashflows)
+            cf = cf_dist(rng);
+        const auto reference = NpvCalculator(cashflows);
+        const auto horner = HornerNpvCalculator(cashflows);
+
+        for (const double rate : {-0.5, -0.01, 0.0, 0.01, 0.0866, 0.5, 3.0})
+        {
+            CAPTURE(n);
+            CAPTURE(rate);
+            const double scale = discounted_magnitude(cashflows, rate);
+            CHECK(horner.calculate<IndexMode::ZeroBased>(rate)
+                  == doctest::Approx(reference.calculate<IndexMode::ZeroBased, simd::Isa::Scalar>(rate)).epsilon(1e-12).scale(scale));
+            CHECK(horner.calculate<IndexMode::OneBased>(rate)
+                  == doctest::Approx(reference.calculate<IndexMode::OneBased, simd::Isa::Scalar>(rate)).epsilon(1e-12).scale(scale));
+            const auto [npv, derivative] = horner.calculate_with_derivative(rate);
+            const auto [npv_ref, derivative_ref] = reference.calculate_with_derivative<simd::Isa::Scalar>(rate);
+            CHECK(npv == doctest::Approx(npv_ref).epsilon(1e-12).scale(scale));
+            CHECK(derivative == doctest::Approx(derivative_ref).epsilon(1e-12).scale(scale / std::abs(1.0 + rate)));
+        }
+    }
+    CHECK(std::isinf(HornerNpvCalculator(std::vector<double>{1.0, 2.0}).calculate(-1.0)));
+}
+
+TEST_CASE("horner_npv_long_series_stays_finite")
+{
+    // 1000 monthly flows at the upper solver bracket: (1+r)^i overflows, the Horner partial sums don't
+    std::vector<double> cashflows(1000, 10.0);
+    cashflows[0] = -1000.0;
+    const auto [npv, derivative] = HornerNpvCalculator(cashflows).calculate_with_derivative(100.0);
+    CHECK(std::isfinite(npv));
+    CHECK(std::isfinite(derivative));
+    CHECK(npv == doctest::Approx(-1000.0 + 10.0 / 100.0).epsilon(1e-12));
+}
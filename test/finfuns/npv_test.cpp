@@ -9,6 +9,10 @@
 
 #include "../test_data.hpp"
 
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
 #include <doctest/doctest.h>
 
 using namespace finfuns;
@@ -37,3 +41,53 @@ TEST_CASE("npv")
         }
     }
 }
+
+TEST_CASE("npv_profile")
+{
+    std::vector<double> rates;
+    for (int i = 0; i < 37; ++i)
+        rates.push_back(-0.5 + 0.05 * i);
+    rates.push_back(-1.0);
+
+    // Crosses the cashflow blocks of the profile
+    std::vector<double> cashflows(2500);
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+        cashflows[i] = i == 0 ? -50000.0 : 40.0 + static_cast<double>(i % 7);
+
+    for (const auto & cf : {std::vector<double>{-100.0, 30.0, 40.0, 50.0}, cashflows})
+    {
+        std::vector<double> zero_based(rates.size());
+        std::vector<double> one_based(rates.size());
+        REQUIRE(npv_profile<IndexMode::ZeroBased>(rates, cf, zero_based).has_value());
+        REQUIRE(npv_profile<IndexMode::OneBased>(rates, cf, one_based).has_value());
+        for (std::size_t j = 0; j < rates.size(); ++j)
+        {
+            CAPTURE(rates[j]);
+            const double expected_zero = npv<IndexMode::ZeroBased>(rates[j], cf).value();
+            const double expected_one = npv<IndexMode::OneBased>(rates[j], cf).value();
+            if (std::isinf(expected_zero))
+            {
+                CHECK(zero_based[j] == expected_zero);
+                CHECK(one_based[j] == expected_one);
+            }
+            else
+            {
+                CHECK(zero_based[j] == doctest::Approx(expected_zero).epsilon(1e-12));
+                CHECK(one_based[j] == doctest::Approx(expected_one).epsilon(1e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("npv_profile_errors")
+{
+    const std::vector<double> cashflows = {-100.0, 60.0, 60.0};
+    std::vector<double> results(2);
+
+    const std::vector<double> invalid_rates = {0.1, std::numeric_limits<double>::quiet_NaN()};
+    CHECK(npv_profile<IndexMode::ZeroBased>(invalid_rates, cashflows, results).error() == NPVError::InvalidRate);
+
+    const std::vector<double> rates = {0.1, 0.2};
+    CHECK(npv_profile<IndexMode::ZeroBased>(rates, {}, results).error() == NPVError::EmptyCashflows);
+    CHECK(npv_profile<IndexMode::ZeroBased>(rates, cashflows, std::span(results).first(1)).error() == NPVError::ResultsSizeMismatch);
+}
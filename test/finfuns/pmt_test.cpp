@@ -0,0 +1,45 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/fv.hpp>
+#include <finfuns/pmt.hpp>
+#include <finfuns/pv.hpp>
+
+#include "../test_data.hpp"
+
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::pmt;
+
+TEST_CASE("pmt")
+{
+    for (const auto & test : pmt_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = (test.mode == PaymentDueType::EndOfPeriod)
+            ? pmt<PaymentDueType::EndOfPeriod>(test.rate, test.periods, test.pv, test.fv)
+            : pmt<PaymentDueType::BeginningOfPeriod>(test.rate, test.periods, test.pv, test.fv);
+
+        if (std::isnan(test.expected_result))
+            CHECK(std::isnan(result));
+        else
+            CHECK(result == doctest::Approx(test.expected_result).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("pmt_inverts_pv_fv")
+{
+    // The payment of pmt() brings pv back to the present value and fv to the future value
+    for (const double rate : {-0.01, 0.001, 0.05 / 12, 0.2})
+    {
+        CAPTURE(rate);
+        const double payment = pmt<PaymentDueType::BeginningOfPeriod>(rate, 48, 25000.0, -5000.0);
+        CHECK(pv<PaymentDueType::BeginningOfPeriod>(rate, 48, payment, -5000.0) == doctest::Approx(25000.0).epsilon(1e-12));
+        CHECK(fv<PaymentDueType::BeginningOfPeriod>(rate, 48, payment, 25000.0) == doctest::Approx(-5000.0).epsilon(1e-12));
+    }
+}
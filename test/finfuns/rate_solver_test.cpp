@@ -0,0 +1,204 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/npv_calculator.hpp>
+#include <finfuns/rate_solver.hpp>
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+namespace
+{
+
+// f(r) = (r - root)^3, zero derivative at the root and a slow Newton convergence
+struct CubicCalculator
+{
+    double root;
+
+    double calculate(double rate) const
+    {
+        const double x = rate - root;
+        return x * x * x;
+    }
+
+    std::pair<double, double> calculate_with_derivative(double rate) const
+    {
+        const double x = rate - root;
+        return {x * x * x, 3 * x * x};
+    }
+};
+
+// f(r) = sign(r - root), Newton cannot move (zero derivative), only the bracketed solve finds the root
+struct StepCalculator
+{
+    double root;
+
+    double calculate(double rate) const { return rate < root ? -1.0 : 1.0; }
+    std::pair<double, double> calculate_with_derivative(double rate) const { return {calculate(rate), 0.0}; }
+};
+
+struct ConstantCalculator
+{
+    double value;
+
+    double calculate(double) const { return value; }
+    std::pair<double, double> calculate_with_derivative(double) const { return {value, 0.0}; }
+};
+
+}
+
+static_assert(noexcept(rate_solver(std::declval<NpvCalculator<>>(), 0.1)));
+static_assert(noexcept(rate_solver(std::declval<NpvCalculator<>>(), 0.1, SingleSignChange{-1.0, false, -1.0})));
+
+TEST_CASE("rate_solver_newton")
+{
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 500.0};
+    const auto result = rate_solver(NpvCalculator(cashflows), 0.1);
+    REQUIRE(result.has_value());
+    CHECK(std::abs(NpvCalculator(cashflows).calculate(result.value())) < 1e-9);
+}
+
+TEST_CASE("rate_solver_bracket_fallback")
+{
+    const auto step = rate_solver(StepCalculator{0.37}, 0.1);
+    REQUIRE(step.has_value());
+    CHECK(step.value() == doctest::Approx(0.37).epsilon(1e-12));
+
+    // Newton ends at the guess clamped into the bounds
+    const auto far_guess = rate_solver(CubicCalculator{2.5}, 1e6);
+    REQUIRE(far_guess.has_value());
+    CHECK(far_guess.value() == doctest::Approx(2.5).epsilon(1e-4));
+}
+
+TEST_CASE("rate_solver_errors")
+{
+    const auto no_root = rate_solver(ConstantCalculator{1.0}, 0.1);
+    REQUIRE(not no_root.has_value());
+    CHECK(no_root.error() == SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+
+    const auto nan = rate_solver(ConstantCalculator{std::numeric_limits<double>::quiet_NaN()}, 0.1);
+    REQUIRE(not nan.has_value());
+    CHECK(nan.error() == SolverErrorCode::CANNOT_EVALUATE_VALUE);
+}
+
+TEST_CASE("rate_solver_stats")
+{
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 500.0};
+    SolverStats stats;
+    const auto result = rate_solver(NpvCalculator(cashflows), 0.1, &stats);
+    REQUIRE(result.has_value());
+    CHECK(result.value() == rate_solver(NpvCalculator(cashflows), 0.1).value());
+    CHECK(stats.newton_iterations > 0);
+    CHECK(stats.function_evaluations == stats.newton_iterations + 1);
+    CHECK(not stats.used_fallback);
+    CHECK(stats.bracket_iterations == 0);
+    CHECK(std::abs(stats.residual) < 1e-9);
+
+    SolverStats fallback_stats;
+    const auto step = rate_solver(StepCalculator{0.37}, 0.1, &fallback_stats);
+    REQUIRE(step.has_value());
+    CHECK(fallback_stats.used_fallback);
+    CHECK(fallback_stats.newton_iterations == 0);
+    CHECK(fallback_stats.bracket_iterations > 0);
+    // One Newton evaluation, two bracket ends, one per bracket iteration
+    CHECK(fallback_stats.function_evaluations == 3 + fallback_stats.bracket_iterations);
+    CHECK(fallback_stats.bracket_lower <= step.value());
+    CHECK(step.value() <= fallback_stats.bracket_upper);
+    CHECK(fallback_stats.bracket_upper - fallback_stats.bracket_lower < 1e-12);
+
+    SolverStats error_stats;
+    const auto no_root = rate_solver(ConstantCalculator{1.0}, 0.1, &error_stats);
+    REQUIRE(not no_root.has_value());
+    CHECK(error_stats.used_fallback);
+    CHECK(error_stats.function_evaluations == 3);
+}
+
+TEST_CASE("rate_solver_warm_start_bracket")
+{
+    const auto bracket = warm_start_bracket(0.2);
+    CHECK(bracket.lower == doctest::Approx(0.17));
+    CHECK(bracket.upper == doctest::Approx(0.23));
+
+    SolverStats cold_stats;
+    const auto cold = rate_solver(StepCalculator{0.37}, 0.36, &cold_stats);
+    SolverStats warm_stats;
+    const auto warm = rate_solver(StepCalculator{0.37}, 0.36, warm_start_bracket(0.36), &warm_stats);
+    REQUIRE(warm.has_value());
+    CHECK(warm.value() == doctest::Approx(cold.value()).epsilon(1e-12));
+    CHECK(warm_stats.used_fallback);
+    CHECK(warm_stats.bracket_iterations < cold_stats.bracket_iterations);
+    CHECK(warm_stats.function_evaluations < cold_stats.function_evaluations);
+
+    // No root in the bracket: falls back to the full search bounds
+    const auto far = rate_solver(StepCalculator{2.5}, 0.1, warm_start_bracket(0.1));
+    REQUIRE(far.has_value());
+    CHECK(far.value() == doctest::Approx(2.5).epsilon(1e-12));
+
+    // Bracket outside the search bounds
+    const auto outside = rate_solver(StepCalculator{0.37}, 0.1, RateBracket{200.0, 300.0});
+    REQUIRE(outside.has_value());
+    CHECK(outside.value() == doctest::Approx(0.37).epsilon(1e-12));
+
+    const auto no_root = rate_solver(ConstantCalculator{1.0}, 0.1, warm_start_bracket(0.1));
+    REQUIRE(not no_root.has_value());
+    CHECK(no_root.error() == SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+}
+
+TEST_CASE("rate_solver_single_sign_change")
+{
+    // Investment then returns: negative below the root, positive above it
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 500.0};
+    const auto structure = SingleSignChange{-1.0, false, -1.0};
+    SolverStats stats;
+    const auto result = rate_solver(NpvCalculator(cashflows), 0.1, structure, &stats);
+    REQUIRE(result.has_value());
+    CHECK(result.value() == doctest::Approx(rate_solver(NpvCalculator(cashflows), 0.1).value()).epsilon(1e-12));
+    CHECK(not stats.used_fallback);
+    CHECK(stats.function_evaluations == stats.newton_iterations + 1);
+
+    // Newton cannot move: bisection inside the bracket, without Brent's evaluations of both bounds
+    const auto step = rate_solver(StepCalculator{0.37}, 0.1, SingleSignChange{-1.0, false, 1.0});
+    REQUIRE(step.has_value());
+    CHECK(step.value() == doctest::Approx(0.37).epsilon(1e-12));
+
+    const auto far_guess = rate_solver(CubicCalculator{2.5}, 1e6, SingleSignChange{-1.0, false, 1.0});
+    REQUIRE(far_guess.has_value());
+    CHECK(far_guess.value() == doctest::Approx(2.5).epsilon(1e-4));
+}
+
+TEST_CASE("rate_solver_single_sign_change_no_root")
+{
+    // The root is beyond the upper bound: rejected after evaluating just that bound
+    SolverStats stats;
+    const auto above = rate_solver(StepCalculator{500.0}, 0.1, SingleSignChange{-1.0, false, 1.0}, &stats);
+    REQUIRE(not above.has_value());
+    CHECK(above.error() == SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+    CHECK(stats.function_evaluations == 2);
+
+    SolverStats classic_stats;
+    CHECK(not rate_solver(StepCalculator{500.0}, 0.1, &classic_stats).has_value());
+    CHECK(stats.function_evaluations < classic_stats.function_evaluations);
+
+    // Same sign everywhere
+    const auto constant = rate_solver(ConstantCalculator{1.0}, 0.1, SingleSignChange{-1.0, false, -1.0});
+    REQUIRE(not constant.has_value());
+    CHECK(constant.error() == SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+
+    // Known lower bound (Norstrom: the root is positive) - never evaluated
+    const auto positive = rate_solver(StepCalculator{0.37}, -0.5, SingleSignChange{0.0, true, 1.0});
+    REQUIRE(positive.has_value());
+    CHECK(positive.value() == doctest::Approx(0.37).epsilon(1e-12));
+
+    const auto nan = rate_solver(ConstantCalculator{std::numeric_limits<double>::quiet_NaN()}, 0.1, SingleSignChange{-1.0, false, 1.0});
+    REQUIRE(not nan.has_value());
+    CHECK(nan.error() == SolverErrorCode::CANNOT_EVALUATE_VALUE);
+}
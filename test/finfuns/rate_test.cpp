@@ -0,0 +1,104 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/pmt.hpp>
+#include <finfuns/rate.hpp>
+
+#include "../test_data.hpp"
+
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::rate;
+
+TEST_CASE("rate")
+{
+    for (const auto & test : rate_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = (test.mode == PaymentDueType::EndOfPeriod)
+            ? rate<PaymentDueType::EndOfPeriod>(test.periods, test.pmt, test.pv, test.fv)
+            : rate<PaymentDueType::BeginningOfPeriod>(test.periods, test.pmt, test.pv, test.fv);
+
+        REQUIRE(result.has_value());
+        CHECK(result.value() == doctest::Approx(test.expected_result).epsilon(1e-9).scale(1e-3));
+    }
+}
+
+TEST_CASE("rate_errors")
+{
+    auto zero = rate<PaymentDueType::EndOfPeriod>(0, -100.0, 1000.0);
+    REQUIRE_FALSE(zero.has_value());
+    CHECK(std::get<AnnuityRateErrorCode>(zero.error()) == AnnuityRateErrorCode::ZeroPeriods);
+
+    auto same_sign = rate<PaymentDueType::BeginningOfPeriod>(12, 100.0, 1000.0, 50.0);
+    REQUIRE_FALSE(same_sign.has_value());
+    CHECK(std::get<AnnuityRateErrorCode>(same_sign.error()) == AnnuityRateErrorCode::SameSignCashflows);
+
+    auto not_finite = rate<PaymentDueType::EndOfPeriod>(12, std::numeric_limits<double>::quiet_NaN(), 1000.0);
+    REQUIRE_FALSE(not_finite.has_value());
+    CHECK(std::get<SolverErrorCode>(not_finite.error()) == SolverErrorCode::CANNOT_EVALUATE_VALUE);
+
+    // Paying 1e9 per period for 1e6 takes a rate ~1000, beyond the search bounds
+    auto no_root = rate<PaymentDueType::EndOfPeriod>(12, -1e9, 1e6);
+    REQUIRE_FALSE(no_root.has_value());
+    CHECK(std::holds_alternative<SolverErrorCode>(no_root.error()));
+}
+
+TEST_CASE("rate_inverts_pmt")
+{
+    for (const uint32_t periods : {1u, 12u, 60u, 360u})
+    {
+        for (const double expected : {-0.02, 1e-9, 0.05 / 12, 0.03, 0.5})
+        {
+            CAPTURE(periods);
+            CAPTURE(expected);
+            const double end_payment = pmt<PaymentDueType::EndOfPeriod>(expected, periods, 30000.0, -5000.0);
+            const auto end = rate<PaymentDueType::EndOfPeriod>(periods, end_payment, 30000.0, -5000.0);
+            REQUIRE(end.has_value());
+            CHECK(end.value() == doctest::Approx(expected).epsilon(1e-8).scale(1e-3));
+
+            const double begin_payment = pmt<PaymentDueType::BeginningOfPeriod>(expected, periods, 0.0, 100000.0);
+            const auto begin = rate<PaymentDueType::BeginningOfPeriod>(periods, begin_payment, 0.0, 100000.0);
+            REQUIRE(begin.has_value());
+            CHECK(begin.value() == doctest::Approx(expected).epsilon(1e-8).scale(1e-3));
+        }
+    }
+}
+
+TEST_CASE("rate_calculator_derivative")
+{
+    // The analytic derivative against a central difference, including the series branch near 0
+    const auto calculator = AnnuityRateCalculator<PaymentDueType::BeginningOfPeriod>(120, -250.0, 20000.0, -3000.0);
+    for (const double r : {-0.3, -1e-3, -1e-7, 0.0, 1e-8, 1e-6, 0.004, 0.1, 2.0})
+    {
+        CAPTURE(r);
+        const auto [value, derivative] = calculator.calculate_with_derivative(r);
+        CHECK(value == doctest::Approx(calculator.calculate(r)).epsilon(1e-14));
+        const double h = 1e-6 * (1.0 + std::abs(r));
+        const double difference = (calculator.calculate(r + h) - calculator.calculate(r - h)) / (2.0 * h);
+        CHECK(derivative == doctest::Approx(difference).epsilon(1e-6));
+    }
+}
+
+TEST_CASE("rate_guess_and_stats")
+{
+    // The closed form guess leaves Newton a few steps on a mortgage
+    SolverStats stats;
+    const auto res = rate<PaymentDueType::EndOfPeriod>(360, -1073.64, 200000.0, 0.0, std::nullopt, &stats);
+    REQUIRE(res.has_value());
+    CHECK(res.value() == doctest::Approx(0.05 / 12).epsilon(1e-6));
+    CHECK(stats.newton_iterations <= 4);
+    CHECK_FALSE(stats.used_fallback);
+    CHECK(detail::annuity_rate_guess<PaymentDueType::EndOfPeriod>(360, -1073.64, 200000.0, 0.0)
+          == doctest::Approx(0.05 / 12).epsilon(0.05));
+
+    // An explicit guess is used as given
+    const auto from_guess = rate<PaymentDueType::EndOfPeriod>(360, -1073.64, 200000.0, 0.0, 0.1);
+    REQUIRE(from_guess.has_value());
+    CHECK(from_guess.value() == doctest::Approx(res.value()).epsilon(1e-9));
+}
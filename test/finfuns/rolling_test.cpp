@@ -0,0 +1,144 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/rolling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+namespace
+{
+
+// Monthly flows: an investment every 12 months, returns in between
+std::vector<double> monthly_cashflows(std::size_t n)
+{
+    std::vector<double> cashflows(n);
+    for (std::size_t i = 0; i < n; ++i)
+        cashflows[i] = i % 12 == 0 ? -1000.0 - static_cast<double>(i % 7) : 80.0 + static_cast<double>((i * 37) % 23);
+    return cashflows;
+}
+
+}
+
+TEST_CASE("rolling_window_count")
+{
+    CHECK(rolling_window_count(10, 3) == 8);
+    CHECK(rolling_window_count(10, 10) == 1);
+    CHECK(rolling_window_count(10, 11) == 0);
+    CHECK(rolling_window_count(10, 0) == 0);
+}
+
+TEST_CASE("rolling_npv")
+{
+    const auto cashflows = monthly_cashflows(5000);
+    std::vector<double> magnitudes(cashflows.size());
+    std::ranges::transform(cashflows, magnitudes.begin(), [](double cashflow) { return std::abs(cashflow); });
+    for (const double rate : {0.0, 0.01, -0.3, 0.5, 3.0})
+    {
+        for (const std::size_t window : {std::size_t{1}, std::size_t{36}, std::size_t{500}, std::size_t{4000}})
+        {
+            // (1 + rate)^-window overflows for the long window at rate < 0
+            if (rate < 0.0 && window > 500)
+                continue;
+            CAPTURE(rate);
+            CAPTURE(window);
+            std::vector<double> results(rolling_window_count(cashflows.size(), window));
+            REQUIRE(rolling_npv<IndexMode::ZeroBased>(rate, cashflows, window, results).has_value());
+            std::vector<double> one_based(results.size());
+            REQUIRE(rolling_npv<IndexMode::OneBased>(rate, cashflows, window, one_based).has_value());
+
+            for (std::size_t k = 0; k < results.size(); k += 7)
+            {
+                CAPTURE(k);
+                const auto expected = npv<IndexMode::ZeroBased>(rate, std::span(cashflows).subspan(k, window)).value();
+                // Relative to the magnitude of the discounted flows, which may cancel out in the NPV
+                const double scale = npv<IndexMode::ZeroBased>(rate, std::span(magnitudes).subspan(k, window)).value();
+                CHECK(std::abs(results[k] - expected) <= 1e-11 * scale);
+                CHECK(one_based[k] == doctest::Approx(results[k] / (1.0 + rate)).epsilon(1e-15));
+            }
+        }
+    }
+}
+
+TEST_CASE("rolling_npv_large_tail_cashflow")
+{
+    // Alternating unit flows (NPV ~ 1 / (2 + r)) and a huge cashflow far out in the window, which a
+    // recompute of just the 2^-60 prefix would drop: entering a later window, or already in the first
+    // one. Checked while it is in the window - dropping it again cancels out all but its rounding error.
+    const std::size_t window = 400;
+    for (const std::size_t position : {std::size_t{450}, std::size_t{300}})
+    {
+        std::vector<double> cashflows(600);
+        for (std::size_t i = 0; i < cashflows.size(); ++i)
+            cashflows[i] = i % 2 == 0 ? 1.0 : -1.0;
+        cashflows[position] = position > window ? 1e40 : -1e60;
+        for (const double rate : {0.5, 3.0})
+        {
+            CAPTURE(position);
+            CAPTURE(rate);
+            std::vector<double> results(rolling_window_count(cashflows.size(), window));
+            REQUIRE(rolling_npv<IndexMode::ZeroBased>(rate, cashflows, window, results).has_value());
+            for (std::size_t k = 0; k <= position && k < results.size(); ++k)
+            {
+                CAPTURE(k);
+                const auto expected = npv<IndexMode::ZeroBased>(rate, std::span(cashflows).subspan(k, window)).value();
+                CHECK(results[k] == doctest::Approx(expected).epsilon(1e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("rolling_npv_errors")
+{
+    const std::vector<double> cashflows = {-100.0, 50.0, 60.0};
+    std::vector<double> results(2);
+    CHECK(rolling_npv<IndexMode::ZeroBased>(std::nan(""), cashflows, 2, results).error() == NPVError::InvalidRate);
+    CHECK(rolling_npv<IndexMode::ZeroBased>(0.1, std::span<const double>(), 2, results).error() == NPVError::EmptyCashflows);
+    CHECK(rolling_npv<IndexMode::ZeroBased>(0.1, cashflows, 0, results).error() == NPVError::InvalidWindow);
+    CHECK(rolling_npv<IndexMode::ZeroBased>(0.1, cashflows, 4, results).error() == NPVError::InvalidWindow);
+    CHECK(rolling_npv<IndexMode::ZeroBased>(0.1, cashflows, 1, results).error() == NPVError::ResultsSizeMismatch);
+
+    REQUIRE(rolling_npv<IndexMode::ZeroBased>(-1.0, cashflows, 2, results).has_value());
+    CHECK(std::isinf(results[0]));
+}
+
+TEST_CASE("rolling_irr")
+{
+    // Contributions, then payouts: every window has at most one sign change, so at most one root
+    std::vector<double> cashflows(400);
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+        cashflows[i] = i < 200 ? -100.0 - static_cast<double>(i % 7) : 120.0 + static_cast<double>((i * 37) % 23);
+
+    constexpr std::size_t window = 36;
+    std::vector<double> results(rolling_window_count(cashflows.size(), window));
+    std::vector<int> failed(results.size(), 0);
+    rolling_irr(cashflows, window, 0.1, results, [&](std::size_t k, auto) { failed[k] = 1; });
+
+    std::size_t n_solved = 0;
+    for (std::size_t k = 0; k < results.size(); ++k)
+    {
+        CAPTURE(k);
+        const auto expected = irr(std::span(cashflows).subspan(k, window), 0.1);
+        REQUIRE(expected.has_value() == (failed[k] == 0));
+        if (expected.has_value())
+            CHECK(results[k] == doctest::Approx(expected.value()).epsilon(1e-9));
+        else
+            CHECK(std::isnan(results[k]));
+        n_solved += static_cast<std::size_t>(1 - failed[k]);
+    }
+    CHECK(n_solved == window - 1);
+
+    // No windows: nothing is written
+    int n_errors = 0;
+    rolling_irr(cashflows, cashflows.size() + 1, 0.1, std::span<double>(), [&](std::size_t, auto) { ++n_errors; });
+    CHECK(n_errors == 0);
+}
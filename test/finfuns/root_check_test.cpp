@@ -0,0 +1,129 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <finfuns/batch.hpp>
+#include <finfuns/irr.hpp>
+#include <finfuns/root_check.hpp>
+#include <finfuns/xirr.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+
+TEST_CASE("count_sign_changes")
+{
+    CHECK(count_sign_changes(std::vector<double>{}) == 0);
+    CHECK(count_sign_changes(std::vector<double>{-1.0, 0.0, 0.0, 2.0}) == 1);
+    CHECK(count_sign_changes(std::vector<double>{-1.0, 2.0, -3.0, 0.0, 4.0}) == 3);
+    CHECK(count_sign_changes(std::vector<double>{0.0, 1.0, 2.0}) == 0);
+
+    // Running sums -100, -50, 10, -10, 90
+    CHECK(count_cumulative_sign_changes(std::vector<double>{-100.0, 50.0, 60.0, -20.0, 100.0}) == 3);
+    // Running sums -100, 50, 40, 140
+    CHECK(count_cumulative_sign_changes(std::vector<double>{-100.0, 150.0, -10.0, 100.0}) == 1);
+}
+
+TEST_CASE("irr_root_structure")
+{
+    const auto descartes = irr_root_structure(std::vector<double>{0.0, -1000.0, 300.0, 0.0, 800.0}, -0.5);
+    REQUIRE(descartes.has_value());
+    CHECK(descartes->lower == -1.0);
+    CHECK(not descartes->root_above_lower);
+    CHECK(descartes->sign_above == -1.0);
+
+    // Three sign changes, but the running sums change sign once: a unique positive root
+    const auto norstrom = irr_root_structure(std::vector<double>{-100.0, 150.0, -10.0, 100.0}, 0.1);
+    REQUIRE(norstrom.has_value());
+    CHECK(norstrom->lower == 0.0);
+    CHECK(norstrom->root_above_lower);
+    CHECK(norstrom->sign_above == -1.0);
+    // ... which says nothing about (-1, 0), where a negative guess looks
+    CHECK(not irr_root_structure(std::vector<double>{-100.0, 150.0, -10.0, 100.0}, -0.5).has_value());
+
+    // Two roots (10% and 20%)
+    CHECK(not irr_root_structure(std::vector<double>{-100.0, 230.0, -132.0}, 0.1).has_value());
+    // Running sums end at 0, i.e. NPV(0) = 0
+    CHECK(not irr_root_structure(std::vector<double>{-100.0, 150.0, -10.0, -40.0}, 0.1).has_value());
+
+    // Descartes only applies to dates in order
+    const std::vector<double> cashflows = {-1000.0, 600.0, 600.0};
+    CHECK(xirr_root_structure(cashflows, std::span<const int>(std::vector<int>{0, 365, 365})).has_value());
+    CHECK(not xirr_root_structure(cashflows, std::span<const int>(std::vector<int>{365, 0, 730})).has_value());
+
+    // Unsorted dates with every negative cashflow before every positive one (or the reverse)
+    const auto unsorted = xirr_root_structure(cashflows, std::span<const int>(std::vector<int>{0, 730, 365}));
+    REQUIRE(unsorted.has_value());
+    CHECK(unsorted->sign_above == -1.0);
+    const auto reversed = xirr_root_structure(cashflows, std::span<const int>(std::vector<int>{730, 365, 0}));
+    REQUIRE(reversed.has_value());
+    CHECK(reversed->sign_above == 1.0);
+    // A tie across the boundary in unsorted dates
+    CHECK(not xirr_root_structure(cashflows, std::span<const int>(std::vector<int>{365, 730, 365})).has_value());
+}
+
+TEST_CASE("irr_root_check")
+{
+    // Unique root found by the bracketed Newton
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 500.0, 100.0};
+    SolverStats stats;
+    const auto result = irr(cashflows, 0.1, &stats);
+    REQUIRE(result.has_value());
+    CHECK(std::abs(NpvCalculator(cashflows).calculate(result.value())) < 1e-9);
+    CHECK(not stats.used_fallback);
+
+    // The roots are beyond the search bounds: a few Newton steps and one bound, instead of Newton
+    // running to its limit and Brent evaluating both bounds
+    for (const auto & doomed : {std::vector<double>{-1.0, 1e9}, std::vector<double>{1e9, -1.0}})
+    {
+        SolverStats doomed_stats;
+        const auto res = irr(doomed, 0.1, &doomed_stats);
+        REQUIRE(not res.has_value());
+        CHECK(std::get<SolverErrorCode>(res.error()) == SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+
+        SolverStats classic_stats;
+        CHECK(not rate_solver(NpvCalculator(doomed), 0.1, &classic_stats).has_value());
+        CHECK(doomed_stats.function_evaluations < classic_stats.function_evaluations);
+    }
+
+    // Norstrom: the only root, positive, also from a negative guess
+    const std::vector<double> norstrom = {-100.0, 150.0, -10.0, 100.0};
+    const auto positive = irr(norstrom, -0.5);
+    REQUIRE(positive.has_value());
+    CHECK(positive.value() > 0.0);
+    CHECK(std::abs(NpvCalculator(norstrom).calculate(positive.value())) < 1e-9);
+
+    // Norstrom proves the positive root unique, but there is another one in (-1, 0): 1/(1+r) = 1 +- sqrt(1/3).
+    // A negative guess finds the negative root, a positive one the positive root (bracketed), also in batches
+    const std::vector<double> two_roots = {-100.0, 300.0, -150.0};
+    const double negative_root = 1.0 / (1.0 + std::sqrt(1.0 / 3.0)) - 1.0;
+    const double positive_root = 1.0 / (1.0 - std::sqrt(1.0 / 3.0)) - 1.0;
+    CHECK(irr(two_roots, -0.3).value() == doctest::Approx(negative_root).epsilon(1e-12));
+    CHECK(irr(two_roots, 0.1).value() == doctest::Approx(positive_root).epsilon(1e-12));
+    std::vector<double> batch_results(2);
+    const std::vector<uint64_t> offsets = {3, 6};
+    std::vector<double> batch_values = two_roots;
+    batch_values.insert(batch_values.end(), two_roots.begin(), two_roots.end());
+    const std::vector<double> warm_starts = {-0.3, 0.1};
+    batch::irr(
+        std::span<const double>(batch_values),
+        std::span<const uint64_t>(offsets),
+        batch::RowGuesses(std::span<const double>(warm_starts)),
+        std::span<double>(batch_results),
+        [](std::size_t, auto) {});
+    CHECK(batch_results[0] == doctest::Approx(negative_root).epsilon(1e-12));
+    CHECK(batch_results[1] == doctest::Approx(positive_root).epsilon(1e-12));
+
+    const std::vector<int> dates = {0, 200, 365, 900};
+    const std::vector<double> xirr_doomed = {-1.0, 0.0, 0.0, 1e9};
+    SolverStats xirr_stats;
+    const auto xirr_result = xirr<DayCountConvention::ACT_365F>(xirr_doomed, dates, 0.1, &xirr_stats);
+    REQUIRE(not xirr_result.has_value());
+    CHECK(std::get<SolverErrorCode>(xirr_result.error()) == SolverErrorCode::NO_ROOT_FOUND_IN_BRACKET);
+}
@@ -0,0 +1,163 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../day_count_helper.hpp"
+#include "../test_data.hpp"
+
+#include <finfuns/xirr_state.hpp>
+
+#include <cstddef>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::xirr;
+
+namespace
+{
+
+template <typename DateType>
+std::vector<std::byte> serialized(const XirrState<DateType> & state)
+{
+    std::vector<std::byte> out;
+    state.serialize(out);
+    return out;
+}
+
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("xirr_state_finalize", T, SysDates, IntDates)
+{
+    using DateType = typename decltype(T::process({}))::value_type;
+
+    for (const auto & test : xirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+
+        // Added backwards, every cashflow split in two bookings on the same date
+        XirrState<DateType> state;
+        for (std::size_t i = dates.size(); i-- > 0;)
+        {
+            state.add(dates[i], test.cashflows[i] * 0.25);
+            state.add(dates[i], test.cashflows[i] * 0.75);
+        }
+        CHECK(state.size() == dates.size());
+
+        const auto expected = xirr<DayCountConvention::ACT_365F>(test.cashflows, std::span<const DateType>(dates), std::nullopt);
+        const auto result = state.template finalize<DayCountConvention::ACT_365F>(std::nullopt);
+        REQUIRE(result.has_value());
+        CHECK(result.value() == doctest::Approx(expected.value()).epsilon(1e-12));
+
+        const auto npv = state.template finalize_xnpv<DayCountConvention::ACT_365F>(0.05);
+        CHECK(npv.value() == doctest::Approx(xnpv<DayCountConvention::ACT_365F>(0.05, test.cashflows, dates).value()).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("xirr_state_coalesces_same_date_cashflows")
+{
+    // Daily bookings over a few dates, in and out of order
+    const std::vector<int> days = {0, 31, 59, 90};
+    XirrState<int> parts[3];
+    std::vector<double> expected(days.size(), 0.0);
+    for (int row = 0; row < 3000; ++row)
+    {
+        const auto d = static_cast<std::size_t>((row * 7) % 4);
+        const double cashflow = d == 0 ? -10.0 : 3.0 + (row % 5);
+        parts[row % 3].add(days[d], cashflow);
+        expected[d] += cashflow;
+    }
+
+    XirrState<int> state;
+    state.merge(parts[2]);
+    state.merge(parts[0]);
+    state.merge(parts[1]);
+
+    const auto entries = state.entries();
+    REQUIRE(entries.size() == days.size());
+    for (std::size_t i = 0; i < days.size(); ++i)
+    {
+        CHECK(entries[i].date == days[i]);
+        CHECK(entries[i].cashflow == doctest::Approx(expected[i]));
+    }
+
+    const auto result = state.finalize<DayCountConvention::ACT_365F>(0.1);
+    const auto reference = xirr<DayCountConvention::ACT_365F>(std::span<const double>(expected), std::span<const int>(days), 0.1);
+    CHECK(result.value() == doctest::Approx(reference.value()).epsilon(1e-10));
+
+    // Merging a state into itself doubles every cashflow, which keeps the XIRR
+    auto doubled = state;
+    doubled.merge(doubled);
+    CHECK(doubled.entries()[1].cashflow == 2 * entries[1].cashflow);
+    CHECK(doubled.finalize<DayCountConvention::ACT_365F>(0.1).value() == doctest::Approx(result.value()).epsilon(1e-12));
+}
+
+TEST_CASE("xirr_state_serialization")
+{
+    XirrState<std::chrono::sys_days> state;
+    for (std::size_t i = 0; i < xirr_cases[0].dates.size(); ++i)
+        state.add(xirr_cases[0].dates[i], xirr_cases[0].cashflows[i]);
+    // Before the epoch, so the first date is negative
+    state.add(std::chrono::sys_days{std::chrono::days{-40}}, -1.0);
+
+    const auto bytes = serialized(state);
+    CHECK(bytes.front() == std::byte{XirrState<std::chrono::sys_days>::serialization_version});
+    const auto restored = XirrState<std::chrono::sys_days>::deserialize(bytes);
+    REQUIRE(restored.has_value());
+    CHECK(serialized(restored.value()) == bytes);
+    CHECK(
+        restored->finalize<DayCountConvention::ACT_365_25>(0.1).value()
+        == state.finalize<DayCountConvention::ACT_365_25>(0.1).value());
+
+    // Same bytes for int dates
+    XirrState<int> int_state;
+    for (const auto & entry : state.entries())
+        int_state.add(static_cast<int>(entry.date.time_since_epoch().count()), entry.cashflow);
+    CHECK(serialized(int_state) == bytes);
+
+    CHECK(XirrState<int>::deserialize(serialized(XirrState<int>())).value().size() == 0);
+}
+
+TEST_CASE("xirr_state_deserialization_errors")
+{
+    XirrState<int> state;
+    state.add(100, -100.0);
+    state.add(465, 120.0);
+    const auto bytes = serialized(state);
+
+    auto wrong_version = bytes;
+    wrong_version[0] = std::byte{XirrState<int>::serialization_version + 1};
+    CHECK(XirrState<int>::deserialize(wrong_version).error() == SerializationError::UnsupportedVersion);
+
+    for (std::size_t size = 0; size < bytes.size(); ++size)
+    {
+        CAPTURE(size);
+        CHECK(XirrState<int>::deserialize(std::span(bytes).first(size)).error() == SerializationError::UnexpectedEnd);
+    }
+
+    auto trailing = bytes;
+    trailing.push_back(std::byte{0});
+    CHECK(XirrState<int>::deserialize(trailing).error() == SerializationError::InvalidData);
+
+    // Second date not after the first one
+    auto repeated_date = bytes;
+    repeated_date[12] = std::byte{0};
+    repeated_date.erase(repeated_date.begin() + 13);
+    CHECK(XirrState<int>::deserialize(repeated_date).error() == SerializationError::InvalidData);
+}
+
+TEST_CASE("xirr_state_errors")
+{
+    XirrState<int> empty;
+    CHECK(empty.finalize<DayCountConvention::ACT_365F>(0.1).error() == XIRRError{XIRRErrorCode::NotEnoughCashflows});
+    CHECK(empty.finalize_xnpv<DayCountConvention::ACT_365F>(0.1).error() == XNPVError::EmptyCashflows);
+
+    XirrState<int> same_sign;
+    same_sign.add(10, 100.0);
+    same_sign.add(20, 50.0);
+    CHECK(same_sign.finalize<DayCountConvention::ACT_365F>(0.1).error() == XIRRError{XIRRErrorCode::SameSignCashflows});
+}
@@ -9,21 +9,26 @@
 #include "../test_data.hpp"
 
 #include <finfuns/xirr.hpp>
+#include <finfuns/xnpv.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 #include <doctest/doctest.h>
 
 using namespace finfuns;
 using namespace finfuns::test::xirr;
 
-template <typename DateType>
+template <DateUnit unit = DateUnit::Days, typename DateType>
 static constexpr auto invoke_xirr(DayCountConvention dcc, std::span<const double> cashflows, std::span<const DateType> dates)
 {
     switch (dcc)
     {
         case DayCountConvention::ACT_365F:
-            return xirr<DayCountConvention::ACT_365F>(cashflows, dates, std::nullopt);
+            return xirr<DayCountConvention::ACT_365F, ExpAccuracy::Full, unit>(cashflows, dates, std::nullopt);
         case DayCountConvention::ACT_365_25:
-            return xirr<DayCountConvention::ACT_365_25>(cashflows, dates, std::nullopt);
+            return xirr<DayCountConvention::ACT_365_25, ExpAccuracy::Full, unit>(cashflows, dates, std::nullopt);
         default:
             throw std::invalid_argument("Unsupported DayCountConvention");
     }
@@ -61,3 +66,124 @@ DOCTEST_TEST_CASE_TEMPLATE("XIRR", T, SysDates, IntDates)
             CHECK(result.value() == doctest::Approx(expected_result).epsilon(1e-6));
     }
 }
+
+DOCTEST_TEST_CASE_TEMPLATE("xirr_date_encodings", T, Date16, DateTime32, DateTime64Ms, DateTime64Ns)
+{
+    for (const auto & test : xirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        const auto int_dates = IntDates::process(test.dates);
+        const auto day_count = test.expected_results[0].day_count;
+        const auto result = invoke_xirr<T::unit>(day_count, test.cashflows, std::span<const typename T::type>(dates));
+        const auto expected = invoke_xirr(day_count, test.cashflows, std::span<const int>(int_dates));
+        REQUIRE(result.has_value());
+        REQUIRE(expected.has_value());
+        CHECK(result.value() == expected.value());
+    }
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("xirr_unsorted_dates", T, SysDates, IntDates)
+{
+    // The (cashflow, date) pairs reversed and rotated give the root of the sorted series
+    for (const auto & test : xirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        const auto expected = invoke_xirr(test.expected_results[0].day_count, test.cashflows, std::span(dates.data(), dates.size()));
+        REQUIRE(expected.has_value());
+
+        std::vector<double> cashflows(test.cashflows.rbegin(), test.cashflows.rend());
+        auto unsorted_dates = std::vector(dates.rbegin(), dates.rend());
+        for (std::size_t shift = 0; shift < cashflows.size(); ++shift)
+        {
+            CAPTURE(shift);
+            const auto result = invoke_xirr(
+                test.expected_results[0].day_count,
+                std::span<const double>(cashflows),
+                std::span<const typename decltype(unsorted_dates)::value_type>(unsorted_dates));
+            REQUIRE(result.has_value());
+            CHECK(result.value() == doctest::Approx(expected.value()).epsilon(1e-10));
+            std::rotate(cashflows.begin(), cashflows.begin() + 1, cashflows.end());
+            std::rotate(unsorted_dates.begin(), unsorted_dates.begin() + 1, unsorted_dates.end());
+        }
+    }
+}
+
+namespace
+{
+
+template <DayCountConvention day_count>
+void check_xnpv_at_xirr_any_order()
+{
+    // 2019-02-28, 2020-02-29, 2021-01-31, 2024-02-29: month ends and leap years, where moving the base
+    // date changes the year fractions of these day counts by more than a constant
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 600.0};
+    const std::vector<int> dates = {17955, 18321, 18658, 19782};
+    const double sorted_xnpv = xnpv<day_count>(0.07, cashflows, std::span<const int>(dates)).value();
+
+    std::vector<double> shuffled_cashflows(cashflows.rbegin(), cashflows.rend());
+    std::vector<int> shuffled_dates(dates.rbegin(), dates.rend());
+    for (std::size_t shift = 0; shift < cashflows.size(); ++shift)
+    {
+        CAPTURE(shift);
+        const auto cashflow_span = std::span<const double>(shuffled_cashflows);
+        const auto date_span = std::span<const int>(shuffled_dates);
+        CHECK(xnpv<day_count>(0.07, cashflow_span, date_span).value() == doctest::Approx(sorted_xnpv).epsilon(1e-12));
+        const double rate = xirr<day_count>(cashflow_span, date_span, std::nullopt).value();
+        CHECK(std::abs(xnpv<day_count>(rate, cashflow_span, date_span).value()) < 1e-9);
+        std::rotate(shuffled_cashflows.begin(), shuffled_cashflows.begin() + 1, shuffled_cashflows.end());
+        std::rotate(shuffled_dates.begin(), shuffled_dates.begin() + 1, shuffled_dates.end());
+    }
+}
+
+}
+
+TEST_CASE("xirr_xnpv_same_base_date")
+{
+    // xnpv() measures from the earliest date like xirr(), also for the day counts that are not shift invariant
+    check_xnpv_at_xirr_any_order<DayCountConvention::THIRTY_360_US>();
+    check_xnpv_at_xirr_any_order<DayCountConvention::ACT_365L>();
+}
+
+namespace
+{
+
+template <simd::Isa isa, ExpAccuracy accuracy>
+void check_xirr_accuracy_tier()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    for (const auto & test : xirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = IntDates::process(test.dates);
+        std::vector<double> times(dates.size());
+        const auto prepared = XnpvCalculator<int, DayCountConvention::ACT_365F, accuracy>(
+                                  test.cashflows, std::span<const int>(dates))
+                                  .prepare(times);
+        const auto result = rate_solver(IsaCalculator<decltype(prepared), isa>{prepared}, 0.1);
+        REQUIRE(result.has_value());
+        // The accuracy tier must not move the final XIRR by more than 1e-10 (relative)
+        CHECK(result.value() == doctest::Approx(test.expected_results[0].value).epsilon(1e-10));
+    }
+}
+
+}
+
+TEST_CASE("xirr_exp_accuracy_tiers")
+{
+    check_xirr_accuracy_tier<simd::Isa::Avx2, ExpAccuracy::Full>();
+    check_xirr_accuracy_tier<simd::Isa::Avx2, ExpAccuracy::Screening>();
+    check_xirr_accuracy_tier<simd::Isa::Avx512, ExpAccuracy::Full>();
+    check_xirr_accuracy_tier<simd::Isa::Avx512, ExpAccuracy::Screening>();
+
+    for (const auto & test : xirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto result = xirr<DayCountConvention::ACT_365F, ExpAccuracy::Screening>(test.cashflows, test.dates, std::nullopt);
+        REQUIRE(result.has_value());
+        CHECK(result.value() == doctest::Approx(test.expected_results[0].value).epsilon(1e-10));
+    }
+}
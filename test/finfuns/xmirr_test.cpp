@@ -0,0 +1,100 @@
+// finfuns library
+//
+//  Copyright Joanna Hulboj 2025. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../day_count_helper.hpp"
+#include "../test_data.hpp"
+
+#include <finfuns/mirr.hpp>
+#include <finfuns/xmirr.hpp>
+
+#include <random>
+#include <vector>
+#include <doctest/doctest.h>
+
+using namespace finfuns;
+using namespace finfuns::test::xmirr;
+
+DOCTEST_TEST_CASE_TEMPLATE("XMIRR", T, SysDates, IntDates)
+{
+    for (const auto & test : xmirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        const auto dates_span = std::span(dates.data(), dates.size());
+        for (const auto & expected : test.expected_results)
+        {
+            const auto result = expected.day_count == DayCountConvention::ACT_365F
+                ? xmirr<DayCountConvention::ACT_365F>(test.cashflows, dates_span, test.finance_rate, test.reinvest_rate)
+                : xmirr<DayCountConvention::ACT_365_25>(test.cashflows, dates_span, test.finance_rate, test.reinvest_rate);
+
+            REQUIRE(result.has_value());
+            CHECK(result.value() == doctest::Approx(expected.value).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("xmirr_errors")
+{
+    const std::vector<int> dates{0, 365, 730};
+    const std::vector<double> cashflows{-100.0, 50.0, 80.0};
+    const auto check_error = [](const expected<double, XMIRRError> & result, XMIRRError error)
+    {
+        REQUIRE_FALSE(result.has_value());
+        CHECK(result.error() == error);
+    };
+
+    check_error(xmirr<DayCountConvention::ACT_365F>(std::span(cashflows).first(1), dates, 0.1, 0.1), XMIRRError::NotEnoughCashflows);
+    check_error(xmirr<DayCountConvention::ACT_365F>(cashflows, std::span(dates).first(2), 0.1, 0.1), XMIRRError::CashflowsDatesSizeMismatch);
+    check_error(xmirr<DayCountConvention::ACT_365F>(std::vector<double>{-1.0, -2.0, 0.0}, dates, 0.1, 0.1), XMIRRError::SameSignCashflows);
+    check_error(xmirr<DayCountConvention::ACT_365F>(cashflows, dates, 0.1, -1.5), XMIRRError::InvalidRate);
+    check_error(xmirr<DayCountConvention::ACT_365F>(cashflows, std::vector<int>{10, 10, 3}, 0.1, 0.1), XMIRRError::ZeroHorizon);
+}
+
+namespace
+{
+
+// Cashflows one 365 day year apart are mirr's periods
+template <simd::Isa isa, ExpAccuracy accuracy>
+void check_xmirr_against_mirr()
+{
+    if (!simd::cpu_supports(isa))
+        return;
+
+    std::mt19937_64 rng(22);
+    std::normal_distribution<double> flow(0.0, 1000.0);
+    // Lengths around the SIMD and the year fraction block sizes
+    for (const std::size_t n : {2u, 5u, 8u, 17u, 63u, 64u, 65u, 129u, 1000u})
+    {
+        std::vector<double> cashflows(n);
+        std::vector<int> dates(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            cashflows[i] = flow(rng);
+            dates[i] = 18000 + static_cast<int>(i) * 365;
+        }
+        cashflows[0] = -std::abs(cashflows[0]) - 1.0;
+        cashflows[n - 1] = std::abs(cashflows[n - 1]) + 1.0;
+
+        CAPTURE(n);
+        const auto expected = mirr<IndexMode::ZeroBased, simd::Isa::Scalar>(cashflows, 0.07, 0.04);
+        const auto result = xmirr<DayCountConvention::ACT_365F, accuracy, isa>(cashflows, dates, 0.07, 0.04);
+        REQUIRE(expected.has_value());
+        REQUIRE(result.has_value());
+        CHECK(result.value() == doctest::Approx(expected.value()).epsilon(1e-10));
+    }
+}
+
+}
+
+TEST_CASE("xmirr_isas")
+{
+    check_xmirr_against_mirr<simd::Isa::Scalar, ExpAccuracy::Full>();
+    check_xmirr_against_mirr<simd::Isa::Avx2, ExpAccuracy::Full>();
+    check_xmirr_against_mirr<simd::Isa::Avx2, ExpAccuracy::Screening>();
+    check_xmirr_against_mirr<simd::Isa::Avx512, ExpAccuracy::Full>();
+    check_xmirr_against_mirr<simd::Isa::Avx512, ExpAccuracy::Screening>();
+}
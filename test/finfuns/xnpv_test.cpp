@@ -8,8 +8,12 @@
 #include "../day_count_helper.hpp"
 #include "../test_data.hpp"
 
+#include <finfuns/small_buffer.hpp>
 #include <finfuns/xnpv.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include <doctest/doctest.h>
 
 using namespace finfuns;
@@ -29,15 +33,15 @@ TEST_CASE("xnpv_error_cases")
     }
 }
 
-template <typename DateType>
+template <DateUnit unit = DateUnit::Days, typename DateType>
 static constexpr auto invoke_xnpv(DayCountConvention dcc, double rate, std::span<const double> cashflows, std::span<const DateType> dates)
 {
     switch (dcc)
     {
         case DayCountConvention::ACT_365F:
-            return xnpv<DayCountConvention::ACT_365F>(rate, cashflows, dates);
+            return xnpv<DayCountConvention::ACT_365F, unit>(rate, cashflows, dates);
         case DayCountConvention::ACT_365_25:
-            return xnpv<DayCountConvention::ACT_365_25>(rate, cashflows, dates);
+            return xnpv<DayCountConvention::ACT_365_25, unit>(rate, cashflows, dates);
         default:
             throw std::invalid_argument("Unsupported DayCountConvention");
     }
@@ -66,3 +70,165 @@ DOCTEST_TEST_CASE_TEMPLATE("XNPV", T, SysDates, IntDates)
         }
     }
 }
+
+DOCTEST_TEST_CASE_TEMPLATE("xnpv_date_encodings", T, Date16, DateTime32, DateTime64Ms, DateTime64Ns)
+{
+    // The same days in any encoding, whatever the time of day
+    for (const auto & test : xnpv_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        const auto int_dates = IntDates::process(test.dates);
+        for (const auto & ev : test.expected_results)
+        {
+            const auto result = invoke_xnpv<T::unit>(ev.day_count, test.rate, test.cashflows, std::span<const typename T::type>(dates));
+            const auto expected = invoke_xnpv(ev.day_count, test.rate, test.cashflows, std::span<const int>(int_dates));
+            REQUIRE(result.has_value());
+            REQUIRE(expected.has_value());
+            if (std::isinf(expected.value()))
+                CHECK(std::isinf(result.value()));
+            else
+                CHECK(result.value() == expected.value());
+        }
+    }
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("xnpv_prepared_calculator", T, SysDates, IntDates)
+{
+    for (const auto & test : xnpv_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        const auto calc = XnpvCalculator<typename decltype(dates)::value_type, DayCountConvention::ACT_365F>(
+            test.cashflows, std::span(dates.data(), dates.size()));
+        auto times = SmallBuffer<double, 4>(test.cashflows.size());
+        const auto prepared = calc.prepare(times.span());
+
+        for (const double rate : {-0.5, 0.0, 0.05, 0.37, 2.0})
+        {
+            CAPTURE(rate);
+            CHECK(prepared.calculate(rate) == doctest::Approx(calc.calculate(rate)).epsilon(1e-12));
+            const auto [npv, derivative] = prepared.calculate_with_derivative(rate);
+            const auto [npv_ref, derivative_ref] = calc.calculate_with_derivative(rate);
+            CHECK(npv == doctest::Approx(npv_ref).epsilon(1e-12));
+            CHECK(derivative == doctest::Approx(derivative_ref).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("xnpv_calculator_base_date")
+{
+    // Measured from an anchor 100 days before the first date, every cashflow is discounted 100 days more
+    for (const auto & test : xnpv_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = IntDates::process(test.dates);
+        const auto date_span = std::span<const int>(dates);
+        CHECK(earliest_date(date_span) == *std::ranges::min_element(dates));
+        const auto calc = XnpvCalculator<int, DayCountConvention::ACT_365F>(test.cashflows, date_span);
+        const auto anchored = XnpvCalculator<int, DayCountConvention::ACT_365F>(test.cashflows, date_span, dates[0] - 100);
+        for (const double rate : {-0.5, 0.0, 0.05, 0.37})
+        {
+            CAPTURE(rate);
+            const double discount = std::pow(1.0 + rate, -100.0 / 365.0);
+            CHECK(anchored.calculate(rate) == doctest::Approx(calc.calculate(rate) * discount).epsilon(1e-12));
+            CHECK(
+                anchored.calculate<simd::Isa::Scalar>(rate)
+                == doctest::Approx(calc.calculate<simd::Isa::Scalar>(rate) * discount).epsilon(1e-12));
+        }
+    }
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("xnpv_float_calculator", T, SysDates, IntDates)
+{
+    for (const auto & test : xnpv_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        using DateType = typename decltype(dates)::value_type;
+        const auto date_span = std::span(dates.data(), dates.size());
+        const std::vector<float> cashflows_f(test.cashflows.begin(), test.cashflows.end());
+        const auto calc = XnpvCalculator<DateType, DayCountConvention::ACT_365F>(test.cashflows, date_span);
+        const auto calc_f = XnpvCalculator<DateType, DayCountConvention::ACT_365F, ExpAccuracy::Full, float>(cashflows_f, date_span);
+        auto times = SmallBuffer<float, 4>(cashflows_f.size());
+        const auto prepared_f = calc_f.prepare(times.span());
+
+        double magnitude = 0.0;
+        for (const double cf : test.cashflows)
+            magnitude += std::abs(cf);
+        for (const double rate : {0.0, 0.05, 0.37, 2.0})
+        {
+            CAPTURE(rate);
+            const auto rate_f = static_cast<float>(rate);
+            const double npv = calc.calculate(rate);
+            CHECK(static_cast<double>(calc_f.calculate(rate_f)) == doctest::Approx(npv).epsilon(1e-5).scale(magnitude));
+            CHECK(static_cast<double>(prepared_f.calculate(rate_f)) == doctest::Approx(npv).epsilon(1e-5).scale(magnitude));
+            CHECK(
+                static_cast<double>(prepared_f.calculate_with_derivative(rate_f).first) == doctest::Approx(npv).epsilon(1e-5).scale(magnitude));
+        }
+    }
+}
+
+DOCTEST_TEST_CASE_TEMPLATE("xnpv_profile", T, SysDates, IntDates)
+{
+    const std::vector<double> rates = {-1.0, -0.5, -0.1, 0.0, 0.05, 0.1, 0.37, 1.0, 2.0, 10.0, 50.0};
+    for (const auto & test : xnpv_cases)
+    {
+        CAPTURE(test.id);
+        const auto dates = T::process(test.dates);
+        const auto dates_span = std::span(dates.data(), dates.size());
+        const auto calc = XnpvCalculator<typename decltype(dates)::value_type, DayCountConvention::ACT_365F>(test.cashflows, dates_span);
+        auto times = SmallBuffer<double, 4>(test.cashflows.size());
+        const auto prepared = calc.prepare(times.span());
+
+        std::vector<double> results(rates.size());
+        std::vector<double> prepared_results(rates.size());
+        REQUIRE(xnpv_profile<DayCountConvention::ACT_365F>(rates, test.cashflows, dates_span, results).has_value());
+        prepared.calculate_profile(rates, prepared_results);
+        for (std::size_t j = 0; j < rates.size(); ++j)
+        {
+            CAPTURE(rates[j]);
+            const double expected = calc.calculate(rates[j]);
+            if (std::isinf(expected))
+            {
+                CHECK(results[j] == expected);
+                CHECK(prepared_results[j] == expected);
+            }
+            else
+            {
+                CHECK(results[j] == doctest::Approx(expected).epsilon(1e-12));
+                CHECK(prepared_results[j] == doctest::Approx(expected).epsilon(1e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("xnpv_profile_long_series")
+{
+    // Crosses the blocks of both profile variants
+    std::vector<double> cashflows(1500);
+    std::vector<int> dates(cashflows.size());
+    for (std::size_t i = 0; i < cashflows.size(); ++i)
+    {
+        cashflows[i] = i == 0 ? -30000.0 : 25.0 + static_cast<double>(i % 5);
+        dates[i] = 19000 + 3 * static_cast<int>(i);
+    }
+    std::vector<double> rates;
+    for (int i = 0; i < 21; ++i)
+        rates.push_back(-0.5 + 0.075 * i);
+
+    const auto calc = XnpvCalculator<int, DayCountConvention::ACT_365_25>(cashflows, dates);
+    std::vector<double> results(rates.size());
+    std::vector<double> scalar_results(rates.size());
+    calc.calculate_profile(rates, results);
+    calc.calculate_profile<simd::Isa::Scalar>(rates, scalar_results);
+    for (std::size_t j = 0; j < rates.size(); ++j)
+    {
+        CAPTURE(rates[j]);
+        CHECK(results[j] == doctest::Approx(calc.calculate(rates[j])).epsilon(1e-12));
+        CHECK(scalar_results[j] == doctest::Approx(calc.calculate<simd::Isa::Scalar>(rates[j])).epsilon(1e-12));
+    }
+
+    std::vector<double> short_results(rates.size() - 1);
+    CHECK(xnpv_profile<DayCountConvention::ACT_365F>(rates, cashflows, dates, short_results).error() == XNPVError::ResultsSizeMismatch);
+}
@@ -11,9 +11,17 @@
 
 #include <finfunslib/finfunslib.h>
 
+#include <finfuns/simd.hpp>
+
 #include "../day_count_helper.hpp"
 #include "../test_data.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
 TEST_CASE("pv lib")
 {
     using namespace finfuns::test::pv;
@@ -46,6 +54,200 @@ TEST_CASE("fv_lib")
     }
 }
 
+TEST_CASE("pv_fv_batch_lib")
+{
+    using namespace finfuns::test::pv;
+    std::vector<double> rates;
+    std::vector<uint32_t> periods;
+    std::vector<double> pmts;
+    std::vector<double> future_values;
+    std::vector<FinFunsPaymentDue> dues;
+    for (const auto & test : pv_cases)
+    {
+        rates.push_back(test.rate);
+        periods.push_back(test.periods);
+        pmts.push_back(test.pmt);
+        future_values.push_back(test.fv);
+        dues.push_back(test.mode == PaymentDueType::EndOfPeriod ? FINFUNS_DUE_END : FINFUNS_DUE_BEGIN);
+    }
+
+    // The batch keeps the digits the scalar functions lose to cancellation at rates close to 0
+    std::vector<double> results(pv_cases.size());
+    finfuns_pv_batch(
+        rates.data(), 1, periods.data(), 1, pmts.data(), 1, future_values.data(), 1, dues.data(), 1, results.size(), results.data());
+    for (std::size_t i = 0; i < pv_cases.size(); ++i)
+    {
+        CAPTURE(pv_cases[i].id);
+        const double expected = pv_cases[i].mode == PaymentDueType::EndOfPeriod
+            ? finfuns_pv_due_end(rates[i], periods[i], pmts[i], future_values[i])
+            : finfuns_pv_due_begin(rates[i], periods[i], pmts[i], future_values[i]);
+        if (std::isnan(expected))
+            CHECK(std::isnan(results[i]));
+        else
+            CHECK(results[i] == doctest::Approx(expected).epsilon(1e-9));
+    }
+
+    // Broadcast everything but the rate
+    const uint32_t n = 24;
+    const double pmt = -250.0;
+    const double value = 1000.0;
+    const FinFunsPaymentDue due = FINFUNS_DUE_BEGIN;
+    finfuns_fv_batch(rates.data(), 1, &n, 0, &pmt, 0, &value, 0, &due, 0, results.size(), results.data());
+    for (std::size_t i = 0; i < rates.size(); ++i)
+    {
+        CAPTURE(rates[i]);
+        const double expected = finfuns_fv_due_begin(rates[i], n, pmt, value);
+        if (std::isnan(expected))
+            CHECK(std::isnan(results[i]));
+        else
+            CHECK(results[i] == doctest::Approx(expected).epsilon(1e-9));
+    }
+}
+
+TEST_CASE("annuity_lib")
+{
+    const auto due_of = [](PaymentDueType mode) { return mode == PaymentDueType::EndOfPeriod ? FINFUNS_DUE_END : FINFUNS_DUE_BEGIN; };
+    const auto check = [](double result, double expected)
+    {
+        if (std::isnan(expected))
+            CHECK(std::isnan(result));
+        else
+            CHECK(result == doctest::Approx(expected).epsilon(1e-12));
+    };
+
+    for (const auto & test : finfuns::test::pmt::pmt_cases)
+    {
+        CAPTURE(test.id);
+        check(finfuns_pmt(test.rate, test.periods, test.pv, test.fv, due_of(test.mode)), test.expected_result);
+    }
+    for (const auto & test : finfuns::test::ipmt::ipmt_cases)
+    {
+        CAPTURE(test.id);
+        check(finfuns_ipmt(test.rate, test.per, test.periods, test.pv, test.fv, due_of(test.mode)), test.expected_ipmt);
+        check(finfuns_ppmt(test.rate, test.per, test.periods, test.pv, test.fv, due_of(test.mode)), test.expected_ppmt);
+    }
+    for (const auto & test : finfuns::test::nper::nper_cases)
+    {
+        CAPTURE(test.id);
+        check(finfuns_nper(test.rate, test.pmt, test.pv, test.fv, due_of(test.mode)), test.expected_result);
+    }
+
+    // Broadcast the periods and the future value
+    std::vector<double> rates;
+    std::vector<double> present_values;
+    std::vector<FinFunsPaymentDue> dues;
+    for (const auto & test : finfuns::test::pmt::pmt_cases)
+    {
+        rates.push_back(test.rate);
+        present_values.push_back(test.pv);
+        dues.push_back(due_of(test.mode));
+    }
+    const uint32_t n = 36;
+    const double future_value = -500.0;
+    std::vector<double> results(rates.size());
+    finfuns_pmt_batch(rates.data(), 1, &n, 0, present_values.data(), 1, &future_value, 0, dues.data(), 1, results.size(), results.data());
+    for (std::size_t i = 0; i < rates.size(); ++i)
+    {
+        CAPTURE(rates[i]);
+        check(results[i], finfuns_pmt(rates[i], n, present_values[i], future_value, dues[i]));
+    }
+}
+
+TEST_CASE("rate_lib")
+{
+    const auto due_of = [](PaymentDueType mode) { return mode == PaymentDueType::EndOfPeriod ? FINFUNS_DUE_END : FINFUNS_DUE_BEGIN; };
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (const auto & test : finfuns::test::rate::rate_cases)
+    {
+        CAPTURE(test.id);
+        double result = nan;
+        REQUIRE(finfuns_rate(test.periods, test.pmt, test.pv, test.fv, due_of(test.mode), nan, &result) == FINFUNS_CODE_SUCCESS);
+        CHECK(result == doctest::Approx(test.expected_result).epsilon(1e-9).scale(1e-3));
+        REQUIRE(finfuns_rate(test.periods, test.pmt, test.pv, test.fv, due_of(test.mode), 0.1, &result) == FINFUNS_CODE_SUCCESS);
+        CHECK(result == doctest::Approx(test.expected_result).epsilon(1e-9).scale(1e-3));
+    }
+    double result = 0.0;
+    CHECK(finfuns_rate(0, -100.0, 1000.0, 0.0, FINFUNS_DUE_END, nan, &result) == FINFUNS_CODE_EMPTY_CASHFLOWS);
+    CHECK(finfuns_rate(12, 100.0, 1000.0, 0.0, FINFUNS_DUE_BEGIN, nan, &result) == FINFUNS_CODE_SAME_SIGN_CASHFLOWS);
+
+    // Broadcast the periods and the due type, one invalid row
+    const std::vector<double> pmts = {-200.0, -250.0, 10.0};
+    const double present_value = 8000.0;
+    const double future_value = 0.0;
+    const uint32_t n = 48;
+    const FinFunsPaymentDue due = FINFUNS_DUE_END;
+    std::vector<double> results(pmts.size());
+    std::vector<FinFunsCode> codes(pmts.size());
+    finfuns_rate_batch(&n, 0, pmts.data(), 1, &present_value, 0, &future_value, 0, &due, 0, results.size(), results.data(), codes.data());
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        CAPTURE(i);
+        REQUIRE(codes[i] == FINFUNS_CODE_SUCCESS);
+        REQUIRE(finfuns_rate(n, pmts[i], present_value, future_value, due, nan, &result) == FINFUNS_CODE_SUCCESS);
+        CHECK(results[i] == result);
+    }
+    CHECK(codes[2] == FINFUNS_CODE_SAME_SIGN_CASHFLOWS);
+    CHECK(std::isnan(results[2]));
+}
+
+TEST_CASE("amortization_schedule_lib")
+{
+    std::vector<double> interest(12);
+    std::vector<double> principal(12);
+    std::vector<double> balance(12);
+    double payment = 0.0;
+    REQUIRE(
+        finfuns_amortization_schedule(0.01, 1000.0, 0.0, FINFUNS_DUE_END, 12, interest.data(), principal.data(), balance.data(), &payment)
+        == FINFUNS_CODE_SUCCESS);
+    CHECK(payment == doctest::Approx(finfuns_pmt(0.01, 12, 1000.0, 0.0, FINFUNS_DUE_END)).epsilon(1e-14));
+    for (uint32_t k = 0; k < 12; ++k)
+    {
+        CHECK(interest[k] == doctest::Approx(finfuns_ipmt(0.01, k + 1, 12, 1000.0, 0.0, FINFUNS_DUE_END)).epsilon(1e-12));
+        CHECK(principal[k] == doctest::Approx(finfuns_ppmt(0.01, k + 1, 12, 1000.0, 0.0, FINFUNS_DUE_END)).epsilon(1e-12));
+    }
+    CHECK(std::abs(balance.back()) < 1e-9);
+
+    CHECK(
+        finfuns_amortization_schedule(-2.0, 1000.0, 0.0, FINFUNS_DUE_END, 12, interest.data(), principal.data(), balance.data(), &payment)
+        == FINFUNS_CODE_INVALID_RATE);
+    CHECK(
+        finfuns_amortization_schedule(0.01, 1000.0, 0.0, FINFUNS_DUE_BEGIN, 0, interest.data(), principal.data(), balance.data(), &payment)
+        == FINFUNS_CODE_EMPTY_CASHFLOWS);
+
+    // Three loans of 12, 0 and 24 periods at one rate, single and multi-threaded
+    const double rate = 0.005;
+    const std::vector<double> present_values = {1000.0, 500.0, 2000.0};
+    const double future_value = 0.0;
+    const std::vector<FinFunsPaymentDue> dues = {FINFUNS_DUE_END, FINFUNS_DUE_END, FINFUNS_DUE_BEGIN};
+    const std::vector<uint64_t> offsets = {12, 12, 36};
+    for (const unsigned threads : {0u, 1u, 4u})
+    {
+        CAPTURE(threads);
+        std::vector<double> all_interest(36);
+        std::vector<double> all_principal(36);
+        std::vector<double> all_balance(36);
+        std::vector<double> payments(3);
+        std::vector<FinFunsCode> codes(3);
+        // 0: the single threaded function
+        if (threads == 0)
+            finfuns_amortization_schedule_batch(
+                &rate, 0, present_values.data(), 1, &future_value, 0, dues.data(), 1, offsets.data(), 3,
+                all_interest.data(), all_principal.data(), all_balance.data(), payments.data(), codes.data());
+        else
+            finfuns_amortization_schedule_batch_mt(
+                &rate, 0, present_values.data(), 1, &future_value, 0, dues.data(), 1, offsets.data(), 3,
+                all_interest.data(), all_principal.data(), all_balance.data(), payments.data(), codes.data(), threads);
+
+        CHECK(codes[0] == FINFUNS_CODE_SUCCESS);
+        CHECK(codes[1] == FINFUNS_CODE_EMPTY_CASHFLOWS);
+        CHECK(codes[2] == FINFUNS_CODE_SUCCESS);
+        CHECK(std::isnan(payments[1]));
+        CHECK(payments[0] == doctest::Approx(finfuns_pmt(rate, 12, 1000.0, 0.0, FINFUNS_DUE_END)).epsilon(1e-14));
+        CHECK(payments[2] == doctest::Approx(finfuns_pmt(rate, 24, 2000.0, 0.0, FINFUNS_DUE_BEGIN)).epsilon(1e-14));
+        CHECK(all_interest[12] == 0.0);
+        CHECK(all_interest[13] == doctest::Approx(finfuns_ipmt(rate, 2, 24, 2000.0, 0.0, FINFUNS_DUE_BEGIN)).epsilon(1e-12));
+    }
+}
 
 TEST_CASE("npv_lib")
 {
@@ -143,6 +345,8 @@ TEST_CASE("xnpv_lib")
                             dates.data(),
                             static_cast<unsigned>(cashflows.size()),
                             &value);
+                    default:
+                        break;
                 }
                 REQUIRE(false);
                 throw std::logic_error("Unexpected day count");
@@ -209,6 +413,8 @@ TEST_CASE("xirr_lib")
                             static_cast<unsigned>(cashflows.size()),
                             0.1,
                             &value);
+                    default:
+                        break;
                 }
                 REQUIRE(false);
                 throw std::logic_error("Unexpected day count");
@@ -237,4 +443,490 @@ TEST_CASE("xirr_lib")
         // TODO: Check codes
     }
 }
+TEST_CASE("irr_batch_lib")
+{
+    using namespace finfuns::test::irr;
+    std::vector<double> values;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : irr_cases)
+    {
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        offsets.push_back(values.size());
+    }
+
+    std::vector<double> results(offsets.size());
+    std::vector<FinFunsCode> codes(offsets.size());
+    finfuns_irr_batch(values.data(), offsets.data(), offsets.size(), 0.1, results.data(), codes.data());
+
+    for (std::size_t row = 0; row < irr_cases.size(); ++row)
+    {
+        const auto & test = irr_cases[row];
+        CAPTURE(test.id);
+        double value;
+        const auto rc = finfuns_irr(test.cashflows.data(), static_cast<unsigned>(test.cashflows.size()), 0.1, &value);
+        REQUIRE(codes[row] == rc);
+        if (rc == FinFunsCode::FINFUNS_CODE_SUCCESS)
+            CHECK(results[row] == doctest::Approx(value).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("xirr_batch_lib")
+{
+    using namespace finfuns::test::xirr;
+    std::vector<double> values;
+    std::vector<int> dates;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : xirr_cases)
+    {
+        const auto int_dates = IntDates::process(test.dates);
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        dates.insert(dates.end(), int_dates.begin(), int_dates.end());
+        offsets.push_back(values.size());
+    }
+    // One more row which fails validation
+    values.push_back(-1000.0);
+    dates.push_back(0);
+    offsets.push_back(values.size());
+
+    std::vector<double> results(offsets.size());
+    std::vector<FinFunsCode> codes(offsets.size());
+    const auto rc = finfuns_xirr_batch(
+        FinFunsDayCount::FINFUNS_ACT_365_25, values.data(), dates.data(), offsets.data(), offsets.size(), 0.1, results.data(), codes.data());
+    REQUIRE(rc == FinFunsCode::FINFUNS_CODE_SUCCESS);
+
+    for (std::size_t row = 0; row < xirr_cases.size(); ++row)
+    {
+        const auto & test = xirr_cases[row];
+        CAPTURE(test.id);
+        REQUIRE(codes[row] == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(results[row] == doctest::Approx(test.expected_results[1].value).epsilon(1e-6));
+    }
+    CHECK(codes.back() == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+    CHECK(std::isnan(results.back()));
+}
+
+TEST_CASE("date_encodings_lib")
+{
+    using namespace finfuns::test::xirr;
+    std::vector<double> values;
+    std::vector<int> dates;
+    std::vector<uint64_t> offsets;
+    for (const auto & test : xirr_cases)
+    {
+        CAPTURE(test.id);
+        const auto int_dates = IntDates::process(test.dates);
+        const auto days = Date16::process(test.dates);
+        const auto seconds = DateTime32::process(test.dates);
+        const auto nanos = DateTime64Ns::process(test.dates);
+        const auto n = static_cast<unsigned>(test.cashflows.size());
+        values.insert(values.end(), test.cashflows.begin(), test.cashflows.end());
+        dates.insert(dates.end(), int_dates.begin(), int_dates.end());
+        offsets.push_back(values.size());
+
+        double expected;
+        double value;
+        REQUIRE(
+            finfuns_xnpv(FinFunsDayCount::FINFUNS_ACT_365F, 0.05, test.cashflows.data(), int_dates.data(), n, &expected)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        REQUIRE(
+            finfuns_xnpv_u16(FinFunsDayCount::FINFUNS_ACT_365F, 0.05, test.cashflows.data(), days.data(), FINFUNS_DATE_DAYS, n, &value)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(value == expected);
+        REQUIRE(
+            finfuns_xnpv_u32(FinFunsDayCount::FINFUNS_ACT_365F, 0.05, test.cashflows.data(), seconds.data(), FINFUNS_DATE_SECONDS, n, &value)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(value == expected);
+
+        REQUIRE(
+            finfuns_xirr(FinFunsDayCount::FINFUNS_ACT_365_25, test.cashflows.data(), int_dates.data(), n, 0.1, &expected)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        REQUIRE(
+            finfuns_xirr_i64(FinFunsDayCount::FINFUNS_ACT_365_25, test.cashflows.data(), nanos.data(), FINFUNS_DATE_NANOSECONDS, n, 0.1, &value)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(value == expected);
+    }
+
+    const auto seconds = std::vector<uint32_t>(dates.begin(), dates.end());
+    std::vector<uint32_t> date_times;
+    for (int date : dates)
+        date_times.push_back(static_cast<uint32_t>(date) * 86'400U + 3'600U);
+    std::vector<double> expected(offsets.size());
+    std::vector<double> results(offsets.size());
+    std::vector<FinFunsCode> codes(offsets.size());
+    REQUIRE(
+        finfuns_xirr_batch(
+            FinFunsDayCount::FINFUNS_ACT_365F, values.data(), dates.data(), offsets.data(), offsets.size(), 0.1, expected.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    REQUIRE(
+        finfuns_xirr_batch_u32(
+            FinFunsDayCount::FINFUNS_ACT_365F,
+            values.data(),
+            date_times.data(),
+            FINFUNS_DATE_SECONDS,
+            offsets.data(),
+            offsets.size(),
+            0.1,
+            results.data(),
+            codes.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    for (std::size_t row = 0; row < offsets.size(); ++row)
+    {
+        CHECK(codes[row] == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(results[row] == expected[row]);
+    }
+    CHECK(
+        finfuns_xirr_batch_u32(
+            FinFunsDayCount::FINFUNS_ACT_365F,
+            values.data(),
+            seconds.data(),
+            static_cast<FinFunsDateUnit>(5),
+            offsets.data(),
+            offsets.size(),
+            0.1,
+            results.data(),
+            codes.data())
+        == FinFunsCode::FINFUNS_CODE_INVALID_DATE_UNIT);
+}
+
+TEST_CASE("irr_ex_lib")
+{
+    using namespace finfuns::test::irr;
+    for (const auto & test : irr_cases)
+    {
+        CAPTURE(test.id);
+        std::span<const double> cashflows = test.cashflows;
+        double value;
+        double value_ex;
+        FinFunsSolverStats stats;
+        const auto rc = finfuns_irr(cashflows.data(), static_cast<unsigned>(cashflows.size()), test.guess.value_or(0.1), &value);
+        const auto rc_ex
+            = finfuns_irr_ex(cashflows.data(), static_cast<unsigned>(cashflows.size()), test.guess.value_or(0.1), &value_ex, &stats);
+
+        REQUIRE(rc_ex == rc);
+        if (rc == FinFunsCode::FINFUNS_CODE_SUCCESS)
+        {
+            CHECK(value_ex == value);
+            CHECK(stats.function_evaluations >= stats.newton_iterations);
+            CHECK(std::abs(stats.residual) < 1e-6);
+            CHECK(stats.bracket_lower <= value);
+            CHECK(value <= stats.bracket_upper);
+            if (not stats.used_fallback)
+                CHECK(stats.bracket_iterations == 0);
+        }
+    }
+
+    // Stats are optional
+    const double cashflows[] = {-100.0, 60.0, 60.0};
+    double value;
+    REQUIRE(finfuns_irr_ex(cashflows, 3, 0.1, &value, nullptr) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+}
+
+TEST_CASE("xirr_ex_lib")
+{
+    const double cashflows[] = {-1000.0, 300.0, 400.0, 500.0};
+    const int dates[] = {19723, 19904, 20089, 20270};
+    double value;
+    double value_ex;
+    FinFunsSolverStats stats;
+    REQUIRE(finfuns_xirr(FinFunsDayCount::FINFUNS_ACT_365F, cashflows, dates, 4, 0.1, &value) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    REQUIRE(
+        finfuns_xirr_ex(FinFunsDayCount::FINFUNS_ACT_365F, cashflows, dates, 4, 0.1, &value_ex, &stats)
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(value_ex == value);
+    CHECK(stats.newton_iterations > 0);
+    CHECK(stats.function_evaluations > 0);
+    CHECK(not stats.used_fallback);
+    CHECK(std::abs(stats.residual) < 1e-6);
+}
+
+TEST_CASE("batch_mt_lib")
+{
+    std::vector<double> values;
+    std::vector<int> dates;
+    std::vector<uint64_t> offsets;
+    for (std::size_t row = 0; row < 300; ++row)
+    {
+        const std::size_t length = row % 50 == 0 ? 2000 : 1 + row % 30;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            values.push_back(i == 0 ? -50.0 * static_cast<double>(length) : 3.0 + static_cast<double>((row * i) % 7));
+            dates.push_back(19000 + static_cast<int>(i * 31));
+        }
+        offsets.push_back(values.size());
+    }
+    const std::size_t n_rows = offsets.size();
+
+    std::vector<double> irr_reference(n_rows);
+    std::vector<FinFunsCode> irr_codes_reference(n_rows);
+    finfuns_irr_batch(values.data(), offsets.data(), n_rows, 0.1, irr_reference.data(), irr_codes_reference.data());
+    std::vector<double> xirr_reference(n_rows);
+    std::vector<FinFunsCode> xirr_codes_reference(n_rows);
+    REQUIRE(
+        finfuns_xirr_batch(
+            FinFunsDayCount::FINFUNS_ACT_365F,
+            values.data(),
+            dates.data(),
+            offsets.data(),
+            n_rows,
+            0.1,
+            xirr_reference.data(),
+            xirr_codes_reference.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+
+    for (const unsigned threads : {0u, 1u, 4u})
+    {
+        CAPTURE(threads);
+        std::vector<double> results(n_rows);
+        std::vector<FinFunsCode> codes(n_rows);
+        finfuns_irr_batch_mt(values.data(), offsets.data(), n_rows, 0.1, results.data(), codes.data(), threads);
+        CHECK(std::memcmp(results.data(), irr_reference.data(), n_rows * sizeof(double)) == 0);
+        CHECK(codes == irr_codes_reference);
+
+        REQUIRE(
+            finfuns_xirr_batch_mt(
+                FinFunsDayCount::FINFUNS_ACT_365F,
+                values.data(),
+                dates.data(),
+                offsets.data(),
+                n_rows,
+                0.1,
+                results.data(),
+                codes.data(),
+                threads)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(std::memcmp(results.data(), xirr_reference.data(), n_rows * sizeof(double)) == 0);
+        CHECK(codes == xirr_codes_reference);
+    }
+    CHECK(irr_codes_reference[30] == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+}
+
+TEST_CASE("batch_warm_lib")
+{
+    const std::vector<double> values = {-1000.0, 300.0, 400.0, 500.0, -500.0, 200.0, 200.0, 200.0, 100.0};
+    const std::vector<int> dates = {19000, 19100, 19300, 19500, 19000, 19200, 19400, 19600, 19000};
+    const std::vector<uint64_t> offsets = {4, 8, 9};
+    const std::size_t n_rows = offsets.size();
+
+    std::vector<double> cold(n_rows);
+    std::vector<FinFunsCode> cold_codes(n_rows);
+    finfuns_irr_batch(values.data(), offsets.data(), n_rows, 0.1, cold.data(), cold_codes.data());
+
+    const std::vector<double> guesses = {cold[0] + 0.001, std::numeric_limits<double>::quiet_NaN(), 0.1};
+    std::vector<double> results(n_rows);
+    std::vector<FinFunsCode> codes(n_rows);
+    finfuns_irr_batch_warm(values.data(), offsets.data(), n_rows, guesses.data(), results.data(), codes.data(), 1);
+    CHECK(codes == cold_codes);
+    CHECK(results[0] == doctest::Approx(cold[0]).epsilon(1e-9));
+    CHECK(results[1] == cold[1]);
+    CHECK(codes[2] == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+    CHECK(std::isnan(results[2]));
+
+    std::vector<double> xirr_cold(n_rows);
+    REQUIRE(
+        finfuns_xirr_batch(
+            FinFunsDayCount::FINFUNS_ACT_365F, values.data(), dates.data(), offsets.data(), n_rows, 0.1, xirr_cold.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    REQUIRE(
+        finfuns_xirr_batch_warm(
+            FinFunsDayCount::FINFUNS_ACT_365F,
+            values.data(),
+            dates.data(),
+            offsets.data(),
+            n_rows,
+            xirr_cold.data(),
+            results.data(),
+            codes.data(),
+            0)
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(results[0] == doctest::Approx(xirr_cold[0]).epsilon(1e-12));
+    CHECK(results[1] == doctest::Approx(xirr_cold[1]).epsilon(1e-12));
+}
+
+TEST_CASE("rolling_lib")
+{
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 500.0, 600.0, 200.0, 100.0};
+    constexpr size_t window = 4;
+    constexpr size_t n_windows = 4;
+
+    std::vector<double> npvs(n_windows);
+    REQUIRE(
+        finfuns_rolling_npv(FINFUNS_ZERO_BASED, 0.05, cashflows.data(), cashflows.size(), window, npvs.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    for (size_t k = 0; k < n_windows; ++k)
+    {
+        double expected = 0.0;
+        REQUIRE(
+            finfuns_npv(FINFUNS_ZERO_BASED, 0.05, cashflows.data() + k, static_cast<unsigned>(window), &expected)
+            == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(npvs[k] == doctest::Approx(expected).epsilon(1e-12));
+    }
+    CHECK(
+        finfuns_rolling_npv(FINFUNS_ZERO_BASED, 0.05, cashflows.data(), cashflows.size(), 0, npvs.data())
+        == FinFunsCode::FINFUNS_CODE_INVALID_WINDOW);
+
+    std::vector<double> irrs(n_windows);
+    std::vector<FinFunsCode> codes(n_windows);
+    REQUIRE(
+        finfuns_rolling_irr(cashflows.data(), cashflows.size(), window, 0.1, irrs.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    for (size_t k = 0; k < n_windows; ++k)
+    {
+        CAPTURE(k);
+        double expected = 0.0;
+        const auto code = finfuns_irr(cashflows.data() + k, static_cast<unsigned>(window), 0.1, &expected);
+        CHECK(codes[k] == code);
+        if (code == FinFunsCode::FINFUNS_CODE_SUCCESS)
+            CHECK(irrs[k] == doctest::Approx(expected).epsilon(1e-9));
+        else
+            CHECK(std::isnan(irrs[k]));
+    }
+    CHECK(codes[1] == FinFunsCode::FINFUNS_CODE_SAME_SIGN_CASHFLOWS);
+    CHECK(
+        finfuns_rolling_irr(cashflows.data(), cashflows.size(), cashflows.size() + 1, 0.1, irrs.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_INVALID_WINDOW);
+}
+TEST_CASE("mirr_lib")
+{
+    const std::vector<double> cashflows = {-120000.0, 39000.0, 30000.0, 21000.0, 37000.0, 46000.0, -1000.0, 500.0};
+    const std::vector<int> dates = {0, 365, 730, 1095, 1460, 1825, 1000, 2000};
+    const std::vector<uint64_t> offsets = {6, 7, 8};
+
+    double result = 0.0;
+    REQUIRE(finfuns_mirr(FINFUNS_ONE_BASED, cashflows.data(), 6, 0.1, 0.12, &result) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(result == doctest::Approx(0.12170251383465858).epsilon(1e-12));
+    REQUIRE(finfuns_mirr(FINFUNS_ZERO_BASED, cashflows.data(), 6, 0.1, 0.12, &result) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(result == doctest::Approx(0.1260941303659051).epsilon(1e-12));
+    CHECK(finfuns_mirr(FINFUNS_ZERO_BASED, cashflows.data(), 1, 0.1, 0.12, &result) == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+    CHECK(finfuns_mirr(FINFUNS_ZERO_BASED, cashflows.data() + 1, 5, 0.1, 0.12, &result) == FinFunsCode::FINFUNS_CODE_SAME_SIGN_CASHFLOWS);
+    CHECK(finfuns_mirr(FINFUNS_ZERO_BASED, cashflows.data(), 6, -1.0, 0.12, &result) == FinFunsCode::FINFUNS_CODE_INVALID_RATE);
+
+    double dated = 0.0;
+    REQUIRE(
+        finfuns_xmirr(FINFUNS_ACT_365F, cashflows.data(), dates.data(), 6, 0.1, 0.12, &dated) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(dated == doctest::Approx(0.1260941303659051).epsilon(1e-12));
+    CHECK(
+        finfuns_xmirr(FINFUNS_ACT_365F, cashflows.data() + 5, dates.data() + 5, 2, 0.1, 0.12, &dated)
+        == FinFunsCode::FINFUNS_CODE_ZERO_HORIZON);
+
+    // Rows: the Excel example and two single cashflow rows
+    std::vector<double> results(offsets.size());
+    std::vector<FinFunsCode> codes(offsets.size());
+    finfuns_mirr_batch(FINFUNS_ZERO_BASED, cashflows.data(), offsets.data(), offsets.size(), 0.1, 0.12, results.data(), codes.data());
+    CHECK(codes[0] == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(results[0] == result);
+    CHECK(codes[1] == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+    CHECK(std::isnan(results[1]));
+
+    REQUIRE(
+        finfuns_xmirr_batch(
+            FINFUNS_ACT_365F, cashflows.data(), dates.data(), offsets.data(), offsets.size(), 0.1, 0.12, results.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(codes[0] == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(results[0] == dated);
+    CHECK(codes[1] == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+    CHECK(codes[2] == FinFunsCode::FINFUNS_CODE_NOT_ENOUGH_CASHFLOWS);
+}
+
+TEST_CASE("calendar_day_counts_lib")
+{
+    // 2003-11-01, 2004-05-01, 2005-01-31, 2005-02-28
+    const std::vector<int> dates = {12357, 12539, 12814, 12842};
+    const std::vector<double> cashflows = {-1000.0, 300.0, 400.0, 450.0};
+
+    // A unit cashflow at dates[i] discounted at 100%: 2^-t gives back the year fraction from dates[0]
+    const auto year_fraction = [&](FinFunsDayCount day_count, std::size_t i)
+    {
+        const int pair[] = {dates[0], dates[i]};
+        const double unit[] = {0.0, 1.0};
+        double value = 0.0;
+        REQUIRE(finfuns_xnpv(day_count, 1.0, unit, pair, 2, &value) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        return -std::log2(value);
+    };
+    CHECK(year_fraction(FINFUNS_ACT_360, 1) == doctest::Approx(182.0 / 360.0).epsilon(1e-14));
+    CHECK(year_fraction(FINFUNS_ACT_365L, 1) == doctest::Approx(182.0 / 366.0).epsilon(1e-14));
+    CHECK(year_fraction(FINFUNS_ACT_ACT_ISDA, 1) == doctest::Approx(61.0 / 365.0 + 121.0 / 366.0).epsilon(1e-14));
+    CHECK(year_fraction(FINFUNS_30_360_US, 3) == doctest::Approx(477.0 / 360.0).epsilon(1e-14));
+    CHECK(year_fraction(FINFUNS_30E_360, 2) == doctest::Approx(449.0 / 360.0).epsilon(1e-14));
+
+    for (const auto day_count : {FINFUNS_ACT_360, FINFUNS_ACT_365L, FINFUNS_ACT_ACT_ISDA, FINFUNS_30_360_US, FINFUNS_30E_360})
+    {
+        CAPTURE(static_cast<int>(day_count));
+        const auto n = static_cast<unsigned>(cashflows.size());
+        double rate = 0.0;
+        REQUIRE(finfuns_xirr(day_count, cashflows.data(), dates.data(), n, 0.1, &rate) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        double value = 1.0;
+        REQUIRE(finfuns_xnpv(day_count, rate, cashflows.data(), dates.data(), n, &value) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+        CHECK(value == doctest::Approx(0.0).scale(1000.0).epsilon(1e-9));
+        double mirr = 0.0;
+        CHECK(finfuns_xmirr(day_count, cashflows.data(), dates.data(), n, 0.1, 0.12, &mirr) == FinFunsCode::FINFUNS_CODE_SUCCESS);
+    }
+    double value = 0.0;
+    CHECK(
+        finfuns_xnpv(static_cast<FinFunsDayCount>(7), 0.1, cashflows.data(), dates.data(), 4, &value)
+        == FinFunsCode::FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+}
+TEST_CASE("active_isa_lib")
+{
+    using finfuns::simd::Isa;
+    const FinFunsIsa isa = finfuns_active_isa();
+    CHECK(finfuns_active_isa() == isa);
+    CHECK(finfuns::simd::cpu_supports(static_cast<Isa>(isa)));
+    // The widest kernel set the CPU has
+    if (isa != FINFUNS_ISA_AVX512)
+        CHECK(not finfuns::simd::cpu_supports(Isa::Avx512));
+    if (isa == FINFUNS_ISA_SCALAR)
+        CHECK(not finfuns::simd::cpu_supports(Isa::Avx2));
+}
+
+TEST_CASE("batch_unsupported_day_count_lib")
+{
+    // Rejected as a whole: every row reports the call's code and a NaN result
+    const std::vector<double> cashflows = {-100.0, 60.0, 60.0, -200.0, 120.0, 120.0};
+    const std::vector<int> dates = {18000, 18365, 18730, 18000, 18365, 18730};
+    const std::vector<int64_t> dates_i64(dates.begin(), dates.end());
+    const std::vector<uint64_t> offsets = {3, 6};
+    const auto bad_day_count = static_cast<FinFunsDayCount>(7);
+
+    const auto check_rows = [](const std::vector<double> & results, const std::vector<FinFunsCode> & codes, FinFunsCode expected)
+    {
+        for (std::size_t row = 0; row < results.size(); ++row)
+        {
+            CAPTURE(row);
+            CHECK(std::isnan(results[row]));
+            CHECK(codes[row] == expected);
+        }
+    };
+
+    std::vector<double> results(offsets.size(), 0.0);
+    std::vector<FinFunsCode> codes(offsets.size(), FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(
+        finfuns_xirr_batch(bad_day_count, cashflows.data(), dates.data(), offsets.data(), offsets.size(), 0.1, results.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+    check_rows(results, codes, FinFunsCode::FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+
+    std::ranges::fill(results, 0.0);
+    std::ranges::fill(codes, FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(
+        finfuns_xirr_batch_i64(
+            FINFUNS_ACT_365F,
+            cashflows.data(),
+            dates_i64.data(),
+            static_cast<FinFunsDateUnit>(7),
+            offsets.data(),
+            offsets.size(),
+            0.1,
+            results.data(),
+            codes.data())
+        == FinFunsCode::FINFUNS_CODE_INVALID_DATE_UNIT);
+    check_rows(results, codes, FinFunsCode::FINFUNS_CODE_INVALID_DATE_UNIT);
+
+    std::ranges::fill(results, 0.0);
+    std::ranges::fill(codes, FinFunsCode::FINFUNS_CODE_SUCCESS);
+    CHECK(
+        finfuns_xmirr_batch(
+            bad_day_count, cashflows.data(), dates.data(), offsets.data(), offsets.size(), 0.1, 0.12, results.data(), codes.data())
+        == FinFunsCode::FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+    check_rows(results, codes, FinFunsCode::FINFUNS_CODE_UNSUPPORTED_DAYCOUNT);
+}
+
 // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
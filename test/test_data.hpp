@@ -120,6 +120,127 @@ const std::vector<TestData> fv_cases = {
 
 }
 
+namespace finfuns::test::pmt
+{
+
+struct TestData
+{
+    int id;
+    PaymentDueType mode;
+    double rate;
+    uint32_t periods;
+    double pv;
+    double fv;
+    double expected_result;
+};
+
+const std::vector<TestData> pmt_cases = {
+    // Basic cases
+    {1, PaymentDueType::EndOfPeriod, 0.08 / 12, 10, 10000.0, 0.0, -1037.03208935915},
+    {2, PaymentDueType::BeginningOfPeriod, 0.08 / 12, 10, 10000.0, 0.0, -1030.16432717797},
+    {3, PaymentDueType::EndOfPeriod, 0.06 / 12, 216, 0.0, 50000.0, -129.081160867991},
+    {4, PaymentDueType::EndOfPeriod, 0.06 / 12, 360, 200000.0, 0.0, -1199.10105030550},
+    {5, PaymentDueType::BeginningOfPeriod, 0.05, 10, -1000.0, 500.0, 85.4783690311699},
+
+    // Zero, tiny and negative rates
+    {6, PaymentDueType::EndOfPeriod, 0.0, 12, 1200.0, 0.0, -100},
+    {7, PaymentDueType::EndOfPeriod, 1e-9, 360, 100000.0, 0.0, -277.777827916670},
+    {8, PaymentDueType::EndOfPeriod, -0.02, 10, 1000.0, 0.0, -89.3331158681539},
+
+    // Invalid rates and periods
+    {100, PaymentDueType::EndOfPeriod, -1, 60, 10000.0, 0.0, std::numeric_limits<double>::quiet_NaN()},
+    {101, PaymentDueType::BeginningOfPeriod, 0.05, 0, 10000.0, 0.0, std::numeric_limits<double>::quiet_NaN()}};
+
+}
+
+namespace finfuns::test::ipmt
+{
+
+struct TestData
+{
+    int id;
+    PaymentDueType mode;
+    double rate;
+    uint32_t per;
+    uint32_t periods;
+    double pv;
+    double fv;
+    double expected_ipmt;
+    double expected_ppmt;
+};
+
+const std::vector<TestData> ipmt_cases = {
+    {1, PaymentDueType::EndOfPeriod, 0.1 / 12, 1, 36, 8000.0, 0.0, -66.6666666666667, -191.470830884033},
+    {2, PaymentDueType::EndOfPeriod, 0.1, 3, 3, 8000.0, 0.0, -292.447129909366, -2924.47129909366},
+    {3, PaymentDueType::BeginningOfPeriod, 0.1 / 12, 1, 36, 8000.0, 0.0, 0.0, -256.004129802347},
+    {4, PaymentDueType::BeginningOfPeriod, 0.1 / 12, 2, 36, 8000.0, 0.0, -64.5332989183138, -191.470830884033},
+    {5, PaymentDueType::BeginningOfPeriod, 0.05, 7, 10, -1000.0, 500.0, 34.7432574497641, 50.7351115814057},
+    {6, PaymentDueType::EndOfPeriod, 0.05, 10, 10, 1000.0, 0.0, -6.16688452216460, -123.337690443292},
+
+    // Payment out of range
+    {100, PaymentDueType::EndOfPeriod, 0.05, 0, 10, 1000.0, 0.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()},
+    {101, PaymentDueType::BeginningOfPeriod, 0.05, 11, 10, 1000.0, 0.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()},
+    // Invalid rate
+    {102, PaymentDueType::BeginningOfPeriod, -1.5, 1, 10, 1000.0, 0.0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()}};
+
+}
+
+namespace finfuns::test::nper
+{
+
+struct TestData
+{
+    int id;
+    PaymentDueType mode;
+    double rate;
+    double pmt;
+    double pv;
+    double fv;
+    double expected_result;
+};
+
+const std::vector<TestData> nper_cases = {
+    {1, PaymentDueType::BeginningOfPeriod, 0.12 / 12, -100.0, -1000.0, 10000.0, 59.6738656742946},
+    {2, PaymentDueType::EndOfPeriod, 0.12 / 12, -100.0, -1000.0, 10000.0, 60.0821228537617},
+    {3, PaymentDueType::EndOfPeriod, 0.12 / 12, -100.0, -1000.0, 0.0, -9.57859403981317},
+    {4, PaymentDueType::EndOfPeriod, 0.01, -100.0, 1000.0, 0.0, 10.5886444594232},
+    {5, PaymentDueType::EndOfPeriod, 0.0, -100.0, 1000.0, 0.0, 10},
+    {6, PaymentDueType::BeginningOfPeriod, 1e-9, -100.0, 1000.0, 0.0, 10.0000000450000},
+
+    // Payments that don't cover the interest never pay off the loan
+    {100, PaymentDueType::EndOfPeriod, 0.1, -50.0, 1000.0, 0.0, std::numeric_limits<double>::quiet_NaN()},
+    {101, PaymentDueType::EndOfPeriod, 0.0, 0.0, 1000.0, 0.0, std::numeric_limits<double>::quiet_NaN()},
+    {102, PaymentDueType::EndOfPeriod, -1.0, -100.0, 1000.0, 0.0, std::numeric_limits<double>::quiet_NaN()}};
+
+}
+
+namespace finfuns::test::rate
+{
+
+struct TestData
+{
+    int id;
+    PaymentDueType mode;
+    uint32_t periods;
+    double pmt;
+    double pv;
+    double fv;
+    double expected_result;
+};
+
+const std::vector<TestData> rate_cases = {
+    {1, PaymentDueType::EndOfPeriod, 48, -200.0, 8000.0, 0.0, 0.00770147248820204},
+    {2, PaymentDueType::EndOfPeriod, 360, -1200.0, 200000.0, 0.0, 0.00500582500676241},
+    {3, PaymentDueType::BeginningOfPeriod, 10, -100.0, 0.0, 1500.0, 0.0725674021092588},
+    {4, PaymentDueType::EndOfPeriod, 12, -500.0, 5000.0, -1000.0, 0.0496327188250202},
+    {5, PaymentDueType::EndOfPeriod, 10, -90.0, 1000.0, 0.0, -0.0187116654229046},
+    {6, PaymentDueType::EndOfPeriod, 10, 0.0, -1000.0, 2000.0, 0.0717734625362932},
+    {7, PaymentDueType::BeginningOfPeriod, 36, -250.0, 8000.0, 0.0, 0.00689986517379437},
+    {8, PaymentDueType::EndOfPeriod, 240, -50.0, 0.0, 30000.0, 0.0067903082923843},
+    {9, PaymentDueType::EndOfPeriod, 20, -50.0, 1000.0, 0.0, 0.0}};
+
+}
+
 namespace finfuns::test::npv
 {
 
@@ -178,6 +299,37 @@ const std::vector<TestData> irr_cases = {
 };
 }
 
+namespace finfuns::test::mirr
+{
+
+struct TestData
+{
+    int id;
+    IndexMode mode;
+    std::vector<double> cashflows;
+    double finance_rate;
+    double reinvest_rate;
+    finfuns::expected<double, MIRRError> expected_result;
+};
+
+const std::vector<TestData> mirr_cases = {
+    {1, IndexMode::ZeroBased, {-120000, 39000, 30000, 21000, 37000, 46000}, 0.10, 0.12, 0.1260941303659051},
+    {2, IndexMode::ZeroBased, {-120000, 39000, 30000, 21000}, 0.10, 0.12, -0.048044655249980806},
+    {3, IndexMode::ZeroBased, {-120000, 39000, 30000, 21000, 37000, 46000}, 0.10, 0.14, 0.13475911082831482},
+    {4, IndexMode::OneBased, {-120000, 39000, 30000, 21000, 37000, 46000}, 0.10, 0.12, 0.12170251383465858},
+    {5, IndexMode::ZeroBased, {-1000, -4000, 5000, 2000}, 0.10, 0.12, 0.17908568603489283},
+    {6, IndexMode::ZeroBased, {-100, 50, -20, 80, -10, 60}, 0.08, 0.05, 0.10914204094673363},
+    {7, IndexMode::ZeroBased, {100, -50}, 0.10, 0.10, 1.42},
+
+    {1001, IndexMode::ZeroBased, {-100}, 0.1, 0.1, finfuns::unexpected(MIRRError::NotEnoughCashflows)},
+    {1002, IndexMode::OneBased, {}, 0.1, 0.1, finfuns::unexpected(MIRRError::NotEnoughCashflows)},
+    {1003, IndexMode::ZeroBased, {100, 200, 0}, 0.1, 0.1, finfuns::unexpected(MIRRError::SameSignCashflows)},
+    {1004, IndexMode::ZeroBased, {-100, 200}, -1.0, 0.1, finfuns::unexpected(MIRRError::InvalidRate)},
+    {1005, IndexMode::ZeroBased, {-100, 200}, 0.1, std::numeric_limits<double>::quiet_NaN(), finfuns::unexpected(MIRRError::InvalidRate)},
+};
+
+}
+
 namespace finfuns::test::xnpv
 {
 
@@ -286,3 +438,45 @@ const std::vector<TestData> xirr_cases
         {{DayCountConvention::ACT_365F, 0.37336253351883136}, {DayCountConvention::ACT_365_25, 0.3736610015164226}}}};
 
 }
+
+namespace finfuns::test::xmirr
+{
+
+struct ExpectedResult
+{
+    DayCountConvention day_count;
+    double value;
+};
+
+struct TestData
+{
+    int id;
+    std::vector<double> cashflows;
+    std::vector<std::chrono::sys_days> dates;
+    double finance_rate;
+    double reinvest_rate;
+    std::vector<ExpectedResult> expected_results;
+};
+
+const std::vector<TestData> xmirr_cases
+    = {{1,
+        {-10000, 5750, 4250, 3250},
+        {2020y / 1 / 1, 2020y / 3 / 1, 2020y / 10 / 30, 2021y / 2 / 15},
+        0.08,
+        0.10,
+        {{DayCountConvention::ACT_365F, 0.34171191860978567}, {DayCountConvention::ACT_365_25, 0.3419409872905703}}},
+       {2,
+        {-10000, 2750, 4250, 3250, 2750},
+        {2008y / 1 / 1, 2008y / 3 / 1, 2008y / 10 / 30, 2009y / 2 / 15, 2009y / 4 / 1},
+        0.08,
+        0.10,
+        {{DayCountConvention::ACT_365F, 0.27236975312477174}, {DayCountConvention::ACT_365_25, 0.2725522916078533}}},
+       // Unsorted: the second cashflow is before the first date, the horizon is the latest date
+       {3,
+        {-5000, -2000, 3000, -1000, 8000},
+        {2021y / 6 / 30, 2021y / 1 / 1, 2022y / 3 / 15, 2022y / 12 / 31, 2023y / 7 / 1},
+        0.08,
+        0.10,
+        {{DayCountConvention::ACT_365F, 0.19553713691379682}, {DayCountConvention::ACT_365_25, 0.19566710016068556}}}};
+
+}